@@ -0,0 +1,145 @@
+#include "../include/epoll_multiplexer.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+using namespace IOMultiplexing;
+
+// 自旋等待演示：服务器线程用EpollMultiplexer回显socketpair上的消息，
+// 客户端做ping-pong，对比不同自旋时长下的往返延迟和自旋命中/阻塞次数。
+// 客户端每次ping之间停顿一小段时间，模拟请求间隔，空闲时服务器要么在自旋要么已阻塞。
+//
+// 用法: demo_busy_poll [ping次数] [请求间隔us]
+
+namespace {
+
+struct Result {
+    double p50Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+    BusyPollStats stats;
+};
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+bool runOnce(const BusyPollConfig& busyPoll, int pings, int gapUs, Result& result) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        std::cerr << "socketpair失败: " << strerror(errno) << std::endl;
+        return false;
+    }
+    setNonBlocking(fds[1]);
+
+    EpollMultiplexer multiplexer(16);
+    multiplexer.setBusyPoll(busyPoll);
+    multiplexer.addFd(fds[1], static_cast<uint32_t>(IOEventType::Read));
+
+    std::atomic<bool> running{true};
+    std::thread server([&]() {
+        char buffer[64];
+        while (running) {
+            for (const auto& event : multiplexer.wait(100)) {
+                ssize_t n = read(event.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    ssize_t written = write(event.fd, buffer, n);
+                    (void)written;
+                }
+            }
+        }
+    });
+
+    std::vector<double> rtts;
+    rtts.reserve(pings);
+    char byte = 'p';
+    bool ok = true;
+    for (int i = 0; i < pings && ok; i++) {
+        if (gapUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(gapUs));
+        }
+        auto start = std::chrono::steady_clock::now();
+        ok = write(fds[0], &byte, 1) == 1 && read(fds[0], &byte, 1) == 1;
+        auto end = std::chrono::steady_clock::now();
+        rtts.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    running = false;
+    server.join();
+    result.stats = multiplexer.getBusyPollStats();
+    multiplexer.removeFd(fds[1]);
+    close(fds[0]);
+    close(fds[1]);
+
+    if (!ok || rtts.empty()) {
+        return false;
+    }
+    std::sort(rtts.begin(), rtts.end());
+    result.p50Us = percentile(rtts, 0.50);
+    result.p99Us = percentile(rtts, 0.99);
+    result.maxUs = rtts.back();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int pings = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int gapUs = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::cout << "Epoll 自旋等待演示 (ping次数=" << pings << ", 请求间隔=" << gapUs << "us)\n";
+    std::cout << "==============================================\n";
+
+    if (std::thread::hardware_concurrency() < 2) {
+        // 自旋线程与客户端抢同一个核心，延迟只会变差
+        std::cout << "提示: 只有1个CPU，自旋无法带来收益，结果仅用于观察计数\n";
+    }
+
+    const int spinSettings[] = {0, 10, 50, 200};
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int spinUs : spinSettings) {
+        Result result;
+        if (!runOnce(BusyPollConfig(spinUs), pings, gapUs, result)) {
+            ok = false;
+            continue;
+        }
+        std::cout << "自旋 " << std::setw(3) << spinUs << "us: "
+                  << "p50=" << result.p50Us << "us, p99=" << result.p99Us
+                  << "us, max=" << result.maxUs << "us"
+                  << " | 自旋命中=" << result.stats.spinHits
+                  << ", 阻塞等待=" << result.stats.blockingWaits
+                  << ", 命中率=" << result.stats.spinHitRatio() * 100 << "%\n";
+    }
+
+    // SO_BUSY_POLL只对支持的网卡队列生效，这里只演示配置是否能设置成功
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock >= 0) {
+        EpollMultiplexer multiplexer(16);
+        multiplexer.setBusyPoll(BusyPollConfig(50, 50, true));
+        multiplexer.addFd(sock, static_cast<uint32_t>(IOEventType::Read));
+        std::cout << "SO_BUSY_POLL/SO_PREFER_BUSY_POLL 设置失败次数: "
+                  << multiplexer.getBusyPollStats().socketOptionFailures
+                  << "（需要CAP_NET_ADMIN或内核支持）\n";
+        multiplexer.removeFd(sock);
+        close(sock);
+    }
+
+    std::cout << (ok ? "\n✅ 演示完成！\n" : "\n❌ 演示失败\n");
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 
 #include "../include/multiplexer_factory.h"
 #include "../include/epoll_multiplexer.h"
+#include "../include/reactor_pool.h"
 #include "../../threadpool/include/thread_pool_factory.h"
 #include <iostream>
 #include <thread>
@@ -285,38 +286,24 @@ private:
 };
 
 // 模式2: 多Epoll实例模式 (多Reactor模式)
+// accept线程 + N个Reactor线程由库中的ReactorPool提供，这里只负责回显逻辑
 class MultiEpollReactor {
 private:
-    struct ReactorThread {
-        std::unique_ptr<EpollMultiplexer> multiplexer;
-        std::thread thread;
-        std::atomic<bool> running{false};
-        ServerStats stats;
-        std::unordered_map<int, std::unique_ptr<Connection>> connections;
-        std::mutex connectionsMutex;
-        
-        ReactorThread() {
-            multiplexer = std::make_unique<EpollMultiplexer>(16384, EpollTriggerMode::EdgeTriggered);
-        }
-    };
-    
-    std::vector<std::unique_ptr<ReactorThread>> reactors_;
-    std::atomic<int> nextReactor_{0};
-    int serverFd_;
+    std::unique_ptr<ReactorPool> pool_;
+    int serverFd_ = -1;
     std::atomic<bool> running_{false};
     ServerStats globalStats_;
     
 public:
     MultiEpollReactor(int reactorCount = 0) {
-        if (reactorCount <= 0) {
-            reactorCount = std::thread::hardware_concurrency();
-        }
-        
-        std::cout << "多Reactor模式初始化: " << reactorCount << "个Reactor线程\n";
-        
-        for (int i = 0; i < reactorCount; i++) {
-            reactors_.push_back(std::make_unique<ReactorThread>());
-        }
+        ReactorPoolConfig config;
+        config.reactorCount = reactorCount > 0 ? reactorCount : 0;
+        config.maxEvents = 16384;
+        config.edgeTriggered = true;
+        config.strategy = DispatchStrategy::LeastConnections;
+        pool_ = std::make_unique<ReactorPool>(config);
+        
+        std::cout << "多Reactor模式初始化: " << pool_->size() << "个Reactor线程\n";
     }
     
     void start(int port) {
@@ -327,132 +314,80 @@ public:
         
         std::cout << "多Reactor服务器启动在端口 " << port << "\n";
         
-        // 启动所有reactor线程
-        for (size_t i = 0; i < reactors_.size(); i++) {
-            auto& reactor = reactors_[i];
-            reactor->running = true;
-            
-            reactor->multiplexer->setEventCallback([&reactor](const IOEvent& event) {
-                reactor->stats.totalMessages++;
-                
-                // 直接在reactor线程中处理（避免线程池开销）
-                char buffer[8192];
-                std::string allData;
-                
-                while (true) {
-                    ssize_t bytesRead = recv(event.fd, buffer, sizeof(buffer), 0);
-                    
-                    if (bytesRead > 0) {
-                        allData.append(buffer, bytesRead);
-                        reactor->stats.totalBytes += bytesRead;
-                    } else if (bytesRead == 0) {
-                        reactor->multiplexer->removeFd(event.fd);
-                        close(event.fd);
-                        reactor->stats.activeConnections--;
-                        return;
-                    } else {
-                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                            break;
-                        } else {
-                            reactor->multiplexer->removeFd(event.fd);
-                            close(event.fd);
-                            reactor->stats.activeConnections--;
-                            reactor->stats.errors++;
-                            return;
-                        }
-                    }
-                }
-                
-                if (!allData.empty()) {
-                    std::string response = "MultiReactor: " + allData;
-                    send(event.fd, response.c_str(), response.size(), MSG_NOSIGNAL);
-                }
-            });
-            
-            reactor->thread = std::thread([&reactor]() {
-                reactor->multiplexer->run();
+        pool_->start();
+        pool_->listen(serverFd_, [this](Reactor& reactor, int clientFd, const sockaddr_storage&) {
+            reactor.addFd(clientFd, static_cast<uint32_t>(IOEventType::Read),
+                          [this, &reactor, clientFd](const IOEvent&) {
+                handleClientData(reactor, clientFd);
             });
-        }
+            globalStats_.totalConnections++;
+            globalStats_.activeConnections++;
+        });
         
         running_ = true;
         
-        // 统计线程
-        std::thread([this]() {
-            while (running_) {
-                std::this_thread::sleep_for(std::chrono::seconds(5));
-                
-                // 汇总所有reactor的统计
-                globalStats_ = ServerStats{};
-                for (const auto& reactor : reactors_) {
-                    globalStats_.totalConnections += reactor->stats.totalConnections.load();
-                    globalStats_.activeConnections += reactor->stats.activeConnections.load();
-                    globalStats_.totalMessages += reactor->stats.totalMessages.load();
-                    globalStats_.totalBytes += reactor->stats.totalBytes.load();
-                    globalStats_.errors += reactor->stats.errors.load();
-                }
-                
-                std::cout << "=== 多Reactor统计 ===\n";
-                globalStats_.printStats();
-                std::cout << "Reactor线程数: " << reactors_.size() << "\n\n";
+        // 统计：连接分布和忙碌程度直接取自各Reactor的负载报告
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            
+            std::cout << "=== 多Reactor统计 ===\n";
+            globalStats_.printStats();
+            for (const auto& load : pool_->getLoads()) {
+                std::cout << "Reactor " << load.index << ": 连接=" << load.connections
+                          << ", 事件=" << load.eventsHandled
+                          << ", 忙碌=" << load.busyRatio * 100 << "%\n";
             }
-        }).detach();
-        
-        // 主线程处理accept
-        acceptLoop();
+            std::cout << "\n";
+        }
     }
     
     void stop() {
         running_ = false;
-        for (auto& reactor : reactors_) {
-            reactor->running = false;
-            reactor->multiplexer->stop();
-            if (reactor->thread.joinable()) {
-                reactor->thread.join();
-            }
-        }
+        pool_->stop();
         if (serverFd_ >= 0) {
             close(serverFd_);
+            serverFd_ = -1;
         }
     }
     
 private:
-    void acceptLoop() {
-        while (running_) {
-            sockaddr_in clientAddr{};
-            socklen_t addrLen = sizeof(clientAddr);
-            int clientFd = accept(serverFd_, (sockaddr*)&clientAddr, &addrLen);
+    // 在连接所属的Reactor线程中处理（避免线程池开销）
+    void handleClientData(Reactor& reactor, int clientFd) {
+        globalStats_.totalMessages++;
+        
+        char buffer[8192];
+        std::string allData;
+        
+        while (true) {
+            ssize_t bytesRead = recv(clientFd, buffer, sizeof(buffer), 0);
             
-            if (clientFd < 0) {
+            if (bytesRead > 0) {
+                allData.append(buffer, bytesRead);
+                globalStats_.totalBytes += bytesRead;
+            } else if (bytesRead == 0) {
+                closeClient(reactor, clientFd);
+                return;
+            } else {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    std::this_thread::sleep_for(std::chrono::microseconds(100));
-                    continue;
-                } else if (errno == EINTR) {
-                    continue;
+                    break;
                 } else {
                     globalStats_.errors++;
-                    continue;
+                    closeClient(reactor, clientFd);
+                    return;
                 }
             }
-            
-            if (!setNonBlocking(clientFd)) {
-                close(clientFd);
-                globalStats_.errors++;
-                continue;
-            }
-            
-            // 负载均衡到不同的reactor
-            int reactorIndex = nextReactor_++ % reactors_.size();
-            auto& reactor = reactors_[reactorIndex];
-            
-            if (!reactor->multiplexer->addFd(clientFd, static_cast<uint32_t>(IOEventType::Read))) {
-                close(clientFd);
-                globalStats_.errors++;
-                continue;
-            }
-            
-            reactor->stats.totalConnections++;
-            reactor->stats.activeConnections++;
         }
+        
+        if (!allData.empty()) {
+            std::string response = "MultiReactor: " + allData;
+            send(clientFd, response.c_str(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+    
+    void closeClient(Reactor& reactor, int clientFd) {
+        reactor.removeFd(clientFd);
+        close(clientFd);
+        globalStats_.activeConnections--;
     }
 };
 
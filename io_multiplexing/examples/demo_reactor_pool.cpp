@@ -0,0 +1,151 @@
+#include "../include/reactor_pool.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <signal.h>
+
+using namespace IOMultiplexing;
+
+// 创建监听在回环地址随机端口上的服务器socket
+int createListenSocket(int& port) {
+    int serverFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (serverFd < 0) {
+        return -1;
+    }
+
+    int opt = 1;
+    setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    if (bind(serverFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(serverFd, 1024) < 0) {
+        close(serverFd);
+        return -1;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(serverFd, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    return serverFd;
+}
+
+// 阻塞客户端：连接后发送若干条消息并等待回显
+bool runClient(int port, int messages) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return false;
+    }
+
+    bool ok = true;
+    const char msg[] = "ping";
+    char buffer[64];
+    for (int i = 0; i < messages && ok; i++) {
+        ok = send(fd, msg, sizeof(msg) - 1, 0) == (ssize_t)(sizeof(msg) - 1);
+        size_t received = 0;
+        while (ok && received < sizeof(msg) - 1) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            ok = n > 0;
+            if (ok) received += n;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+void printLoads(const ReactorPool& pool) {
+    for (const auto& load : pool.getLoads()) {
+        std::cout << "  Reactor " << load.index
+                  << ": 当前连接=" << load.connections
+                  << ", 累计连接=" << load.totalConnections
+                  << ", 事件数=" << load.eventsHandled
+                  << ", 循环次数=" << load.loopIterations
+                  << ", 忙碌占比=" << load.busyRatio * 100 << "%"
+                  << ", CPU=" << load.cpu << "\n";
+    }
+}
+
+bool runWithStrategy(DispatchStrategy strategy, const char* name) {
+    std::cout << "\n=== 分发策略: " << name << " ===\n";
+
+    ReactorPoolConfig config;
+    config.reactorCount = 4;
+    config.strategy = strategy;
+    config.waitTimeoutMs = 100;
+
+    ReactorPool pool(config);
+    pool.start();
+
+    int port = 0;
+    int listenFd = createListenSocket(port);
+    if (listenFd < 0) {
+        std::cerr << "创建监听socket失败: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 每个连接在所属Reactor的loop线程中回显数据
+    pool.listen(listenFd, [](Reactor& reactor, int fd, const sockaddr_storage&) {
+        reactor.addFd(fd, static_cast<uint32_t>(IOEventType::Read), [&reactor, fd](const IOEvent&) {
+            char buffer[4096];
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                send(fd, buffer, n, MSG_NOSIGNAL);
+            } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                reactor.removeFd(fd);
+                close(fd);
+            }
+        });
+    });
+
+    const int clientCount = 32;
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> clients;
+    for (int i = 0; i < clientCount; i++) {
+        clients.emplace_back([port, &succeeded]() {
+            if (runClient(port, 10)) {
+                succeeded++;
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::cout << "客户端完成: " << succeeded.load() << "/" << clientCount << "\n";
+    printLoads(pool);
+
+    pool.stop();
+    close(listenFd);
+    return succeeded == clientCount;
+}
+
+int main() {
+    signal(SIGPIPE, SIG_IGN);
+    std::cout << "ReactorPool 演示程序\n";
+    std::cout << "===================\n";
+
+    bool ok = true;
+    ok = runWithStrategy(DispatchStrategy::RoundRobin, "轮询") && ok;
+    ok = runWithStrategy(DispatchStrategy::LeastConnections, "最少连接") && ok;
+    ok = runWithStrategy(DispatchStrategy::HashByPeer, "按对端哈希") && ok;
+
+    std::cout << (ok ? "\n✅ 演示完成！\n" : "\n❌ 演示失败\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+#include "../include/tcp_connection.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <signal.h>
+
+using namespace IOMultiplexing;
+
+// TcpConnection背压演示：
+// 服务器向一个暂时不读取的慢客户端推送数据，超过高水位时暂停生产，
+// 客户端开始读取、输出队列降到低水位后恢复生产。
+// 公平性演示：同一个ET模式Reactor上，一个连接持续灌入数据，
+// 另一个连接做ping-pong，对比有无读写预算时ping的延迟。
+
+namespace {
+
+const size_t kTotalBytes = 32 * 1024 * 1024;
+const size_t kChunkSize = 64 * 1024;
+const size_t kHighWaterMark = 1024 * 1024;
+const size_t kLowWaterMark = 256 * 1024;
+const int kPingCount = 200;
+const size_t kFloodBytes = 128 * 1024 * 1024;  // 有上限，否则不限预算时输入缓冲区会无限增长
+
+int createListenSocket(int& port) {
+    int serverFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (serverFd < 0) {
+        return -1;
+    }
+
+    int opt = 1;
+    setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    if (bind(serverFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(serverFd, 16) < 0) {
+        close(serverFd);
+        return -1;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(serverFd, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    return serverFd;
+}
+
+// 生产者状态，只在连接所属的loop线程中访问
+struct Producer {
+    size_t sent = 0;
+    bool paused = false;
+    int highWaterHits = 0;
+    int lowWaterHits = 0;
+    std::string chunk = std::string(kChunkSize, 'x');
+
+    void pump(const TcpConnection::Ptr& conn) {
+        while (!paused && sent < kTotalBytes) {
+            if (!conn->send(chunk)) {
+                return;
+            }
+            sent += chunk.size();
+        }
+        if (sent >= kTotalBytes) {
+            conn->shutdown();
+        }
+    }
+};
+
+int connectLoopback(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (fd >= 0 && connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 返回ping的最大往返时间（微秒），失败返回-1
+long runFairness(const IOBudget& budget, const char* name) {
+    ReactorPoolConfig config;
+    config.reactorCount = 1;
+    config.waitTimeoutMs = 100;
+    config.edgeTriggered = true;
+    config.ioBudget = budget;
+    ReactorPool pool(config);
+    pool.start();
+
+    int port = 0;
+    int listenFd = createListenSocket(port);
+    if (listenFd < 0) {
+        return -1;
+    }
+
+    // 小消息回显（ping），大块数据直接丢弃（灌水连接）
+    pool.listen(listenFd, [](Reactor& reactor, int fd, const sockaddr_storage& peer) {
+        TcpConnection::Ptr conn = TcpConnection::create(reactor, fd, peer);
+        conn->setMessageCallback([](const TcpConnection::Ptr& c, IOBuffer& buffer) {
+            if (buffer.readableBytes() <= 4) {
+                c->send(buffer.retrieveAllAsString());
+            } else {
+                buffer.retrieveAll();
+            }
+        });
+        conn->start();
+    });
+
+    std::atomic<bool> flooding{true};
+    int floodFd = connectLoopback(port);
+    std::thread flooder([floodFd, &flooding]() {
+        std::string chunk(256 * 1024, 'f');
+        size_t sent = 0;
+        while (flooding && sent < kFloodBytes) {
+            ssize_t n = send(floodFd, chunk.data(), chunk.size(), MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+    });
+
+    int pingFd = connectLoopback(port);
+    long maxRttUs = 0;
+    long totalRttUs = 0;
+    char buffer[4];
+    for (int i = 0; i < kPingCount && pingFd >= 0; i++) {
+        auto start = std::chrono::steady_clock::now();
+        if (send(pingFd, "ping", 4, 0) != 4 || recv(pingFd, buffer, 4, MSG_WAITALL) != 4) {
+            maxRttUs = -1;
+            break;
+        }
+        long rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        maxRttUs = std::max(maxRttUs, rtt);
+        totalRttUs += rtt;
+    }
+
+    flooding = false;
+    shutdown(floodFd, SHUT_RDWR);
+    flooder.join();
+    close(floodFd);
+    if (pingFd >= 0) {
+        close(pingFd);
+    }
+
+    ReactorLoad load = pool.getLoads()[0];
+    pool.stop();
+    close(listenFd);
+
+    std::cout << name << ": ping平均 " << (maxRttUs < 0 ? 0 : totalRttUs / kPingCount)
+              << " us, 最大 " << maxRttUs << " us, 预算让出次数 " << load.budgetYields << "\n";
+    return maxRttUs;
+}
+
+} // namespace
+
+int main() {
+    signal(SIGPIPE, SIG_IGN);
+    std::cout << "TcpConnection 背压演示\n";
+    std::cout << "=====================\n";
+
+    ReactorPoolConfig config;
+    config.reactorCount = 1;
+    config.waitTimeoutMs = 100;
+    ReactorPool pool(config);
+    pool.start();
+
+    int port = 0;
+    int listenFd = createListenSocket(port);
+    if (listenFd < 0) {
+        std::cerr << "创建监听socket失败: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::atomic<bool> serverDone{false};
+    TcpConnection::Stats serverStats;
+    std::shared_ptr<Producer> producer = std::make_shared<Producer>();
+
+    pool.listen(listenFd, [&](Reactor& reactor, int fd, const sockaddr_storage& peer) {
+        TcpConnection::Ptr conn = TcpConnection::create(reactor, fd, peer);
+
+        conn->setHighWaterMarkCallback([producer](const TcpConnection::Ptr&, size_t pending) {
+            producer->paused = true;
+            producer->highWaterHits++;
+            std::cout << "高水位: 待发送 " << pending / 1024 << " KB，暂停生产\n";
+        }, kHighWaterMark);
+
+        conn->setLowWaterMarkCallback([producer](const TcpConnection::Ptr& c) {
+            producer->paused = false;
+            producer->lowWaterHits++;
+            producer->pump(c);
+        }, kLowWaterMark);
+
+        conn->setCloseCallback([&serverDone, &serverStats](const TcpConnection::Ptr& c) {
+            serverStats = c->getStats();
+            serverDone = true;
+        });
+
+        conn->start();
+        producer->pump(conn);
+    });
+
+    // 慢客户端：先不读取，让服务器输出队列堆积
+    int clientFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(clientFd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "连接失败: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    size_t received = 0;
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t n = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        received += n;
+    }
+    close(clientFd);
+
+    for (int i = 0; i < 50 && !serverDone; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    pool.stop();
+    close(listenFd);
+
+    std::cout << "客户端接收: " << received / 1024 << " KB / " << kTotalBytes / 1024 << " KB\n";
+    std::cout << "高水位触发: " << producer->highWaterHits
+              << ", 低水位触发: " << producer->lowWaterHits << "\n";
+    std::cout << "直接写完: " << serverStats.directWrites
+              << ", 排队写: " << serverStats.queuedWrites
+              << ", 可写事件切换(modifyFd): " << serverStats.writeInterestToggles << "\n";
+
+    std::cout << "\n公平性（ET模式，一个灌水连接 + 一个ping连接）\n";
+    long unlimitedRtt = runFairness(IOBudget(), "不限预算      ");
+    long budgetRtt = runFairness(IOBudget(64 * 1024, 4), "预算64KB/4次  ");
+
+    bool ok = received == kTotalBytes && producer->highWaterHits > 0 &&
+              unlimitedRtt >= 0 && budgetRtt >= 0;
+    std::cout << (ok ? "\n✅ 演示完成！\n" : "\n❌ 演示失败\n");
+    return ok ? 0 : 1;
+}
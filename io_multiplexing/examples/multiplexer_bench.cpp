@@ -0,0 +1,453 @@
+// IO复用器基准测试
+//
+// 使用socketpair代替真实TCP客户端，保证结果可复现：
+//   - 每个后端注册N个空闲fd（socketpair的一端）
+//   - 每轮向其中M个fd的对端写入1字节，使其变为可读
+//   - 统计wait延迟、事件吞吐以及add/modify/remove单次开销
+// 结果以JSON输出到stdout，日志输出到stderr。
+
+#include "../include/multiplexer_factory.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+
+using namespace IOMultiplexing;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 基准测试配置
+struct BenchConfig {
+    size_t minFds = 100;          // 最小空闲fd数量
+    size_t maxFds = 1000000;      // 最大空闲fd数量
+    size_t activeFds = 100;       // 每轮激活的fd数量M
+    size_t rounds = 200;          // 每个规模的测量轮数
+    double rate = 0;              // 每秒激活轮数，0表示不限速
+    std::vector<MultiplexerType> types; // 为空时测试所有支持的类型
+};
+
+// 单个(后端, N)组合的测量结果
+struct BenchResult {
+    std::string type;
+    size_t idleFds = 0;
+    bool ok = false;
+    std::string reason;
+
+    double addNs = 0;
+    double modifyNs = 0;
+    double removeNs = 0;
+    double idleWaitNs = 0;       // 没有就绪fd时wait(0)的开销
+    double waitAvgUs = 0;
+    double waitP50Us = 0;
+    double waitP99Us = 0;
+    double waitMaxUs = 0;
+    double eventsPerSec = 0;
+    uint64_t totalEvents = 0;
+};
+
+// 构造复用器时把stdout日志临时重定向到stderr，避免污染JSON输出
+class StdoutToStderr {
+public:
+    StdoutToStderr() : old_(std::cout.rdbuf(std::cerr.rdbuf())) {}
+    ~StdoutToStderr() { std::cout.rdbuf(old_); }
+private:
+    std::streambuf* old_;
+};
+
+double elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+// 尽量提高fd上限，返回当前软限制
+size_t raiseFdLimit() {
+    rlimit rlim;
+    if (getrlimit(RLIMIT_NOFILE, &rlim) != 0) {
+        return 1024;
+    }
+    if (rlim.rlim_cur < rlim.rlim_max) {
+        rlim.rlim_cur = rlim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rlim);
+        getrlimit(RLIMIT_NOFILE, &rlim);
+    }
+    return static_cast<size_t>(rlim.rlim_cur);
+}
+
+// socketpair集合：watched[i]注册到复用器，peer[i]用于制造可读事件
+struct SocketPairs {
+    std::vector<int> watched;
+    std::vector<int> peer;
+
+    bool create(size_t n, std::string& error) {
+        watched.reserve(n);
+        peer.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            int sv[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+                error = std::string("socketpair失败: ") + strerror(errno);
+                return false;
+            }
+            setNonBlocking(sv[0]);
+            setNonBlocking(sv[1]);
+            watched.push_back(sv[0]);
+            peer.push_back(sv[1]);
+        }
+        return true;
+    }
+
+    ~SocketPairs() {
+        for (int fd : watched) close(fd);
+        for (int fd : peer) close(fd);
+    }
+};
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[idx];
+}
+
+BenchResult runOne(MultiplexerType type, size_t n, const BenchConfig& config) {
+    BenchResult result;
+    result.type = MultiplexerFactory::getTypeName(type);
+    result.idleFds = n;
+
+    std::unique_ptr<IOMultiplexer> mux;
+    {
+        StdoutToStderr redirect;
+        mux = MultiplexerFactory::create(type, static_cast<int>(std::max<size_t>(config.activeFds, 64)));
+    }
+    if (!mux) {
+        result.reason = "create失败";
+        return result;
+    }
+    if (n > mux->getMaxFdCount()) {
+        result.reason = "超过后端最大fd数量";
+        return result;
+    }
+
+    SocketPairs pairs;
+    if (!pairs.create(n, result.reason)) {
+        return result;
+    }
+
+    const uint32_t readEvent = static_cast<uint32_t>(IOEventType::Read);
+
+    // add开销
+    auto start = Clock::now();
+    for (size_t i = 0; i < n; i++) {
+        if (!mux->addFd(pairs.watched[i], readEvent, reinterpret_cast<void*>(i))) {
+            std::ostringstream oss;
+            oss << "addFd失败 (第" << i << "个fd=" << pairs.watched[i] << ")";
+            result.reason = oss.str();
+            return result;
+        }
+    }
+    result.addNs = elapsedNs(start, Clock::now()) / n;
+
+    // modify开销（事件集合不变，仅更新userData，测的是纯粹的修改路径）
+    start = Clock::now();
+    for (size_t i = 0; i < n; i++) {
+        mux->modifyFd(pairs.watched[i], readEvent, reinterpret_cast<void*>(i));
+    }
+    result.modifyNs = elapsedNs(start, Clock::now()) / n;
+
+    // 空闲wait开销：O(1)与O(N)后端的主要差异
+    const int idleIterations = 20;
+    start = Clock::now();
+    for (int i = 0; i < idleIterations; i++) {
+        mux->wait(0);
+    }
+    result.idleWaitNs = elapsedNs(start, Clock::now()) / idleIterations;
+
+    // 激活轮次
+    size_t active = std::min(config.activeFds, n);
+    std::vector<double> latencies;
+    latencies.reserve(config.rounds);
+    std::vector<size_t> indices(active);
+    uint64_t lcg = 0x9E3779B97F4A7C15ULL; // 固定种子，保证可复现
+    double totalWaitNs = 0;
+    auto roundInterval = config.rate > 0
+        ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / config.rate))
+        : std::chrono::nanoseconds(0);
+    auto nextRound = Clock::now();
+    char byte = 'x';
+    char drain[64];
+
+    for (size_t r = 0; r < config.rounds; r++) {
+        if (roundInterval.count() > 0) {
+            std::this_thread::sleep_until(nextRound);
+            nextRound += roundInterval;
+        }
+
+        // 选择M个互不相同的fd：随机起点 + 与n互质的步长
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t base = static_cast<size_t>(lcg >> 33) % n;
+        for (size_t k = 0; k < active; k++) {
+            indices[k] = (base + k * 7919) % n;
+            if (write(pairs.peer[indices[k]], &byte, 1) != 1) {
+                result.reason = std::string("write失败: ") + strerror(errno);
+                return result;
+            }
+        }
+
+        // 只统计wait本身的耗时，读取清空数据不计入
+        size_t received = 0;
+        double ns = 0;
+        while (received < active) {
+            auto waitStart = Clock::now();
+            auto events = mux->wait(100);
+            ns += elapsedNs(waitStart, Clock::now());
+            if (events.empty()) {
+                break; // 超时保护，正常情况下不会出现
+            }
+            received += events.size();
+            for (const auto& ev : events) {
+                while (read(ev.fd, drain, sizeof(drain)) > 0) {}
+            }
+        }
+
+        if (received < active) {
+            std::ostringstream oss;
+            oss << "事件丢失: 期望" << active << ", 实际" << received;
+            result.reason = oss.str();
+            return result;
+        }
+
+        totalWaitNs += ns;
+        result.totalEvents += received;
+        latencies.push_back(ns / 1000.0);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    if (!latencies.empty()) {
+        double sum = 0;
+        for (double v : latencies) sum += v;
+        result.waitAvgUs = sum / latencies.size();
+        result.waitP50Us = percentile(latencies, 0.50);
+        result.waitP99Us = percentile(latencies, 0.99);
+        result.waitMaxUs = latencies.back();
+    }
+    if (totalWaitNs > 0) {
+        result.eventsPerSec = result.totalEvents / (totalWaitNs / 1e9);
+    }
+
+    // remove开销
+    start = Clock::now();
+    for (size_t i = 0; i < n; i++) {
+        mux->removeFd(pairs.watched[i]);
+    }
+    result.removeNs = elapsedNs(start, Clock::now()) / n;
+
+    result.ok = true;
+    return result;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// 根据测量数据给出推荐顺序：先比较能承载的最大规模，再比较该规模下的事件吞吐
+std::vector<std::string> rankByData(const std::vector<BenchResult>& results,
+                                    const std::vector<MultiplexerType>& types) {
+    struct Score {
+        std::string name;
+        size_t maxFds;
+        double eventsPerSec;
+    };
+    std::vector<Score> scores;
+    for (auto type : types) {
+        Score score{MultiplexerFactory::getTypeName(type), 0, 0};
+        for (const auto& r : results) {
+            if (r.type == score.name && r.ok && r.idleFds >= score.maxFds) {
+                score.maxFds = r.idleFds;
+                score.eventsPerSec = r.eventsPerSec;
+            }
+        }
+        scores.push_back(score);
+    }
+    std::stable_sort(scores.begin(), scores.end(), [](const Score& a, const Score& b) {
+        if (a.maxFds != b.maxFds) return a.maxFds > b.maxFds;
+        return a.eventsPerSec > b.eventsPerSec;
+    });
+    std::vector<std::string> ranking;
+    for (const auto& s : scores) ranking.push_back(s.name);
+    return ranking;
+}
+
+void printJson(const BenchConfig& config, size_t fdLimit,
+               const std::vector<MultiplexerType>& types,
+               const std::vector<BenchResult>& results) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "{\n";
+    out << "  \"benchmark\": \"multiplexer_bench\",\n";
+    out << "  \"config\": {\"min_fds\": " << config.minFds
+        << ", \"max_fds\": " << config.maxFds
+        << ", \"active_fds\": " << config.activeFds
+        << ", \"rounds\": " << config.rounds
+        << ", \"rate\": " << config.rate
+        << ", \"fd_limit\": " << fdLimit << "},\n";
+
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "    {\"type\": \"" << r.type << "\", \"idle_fds\": " << r.idleFds;
+        if (r.ok) {
+            out << ", \"status\": \"ok\""
+                << ", \"add_ns\": " << r.addNs
+                << ", \"modify_ns\": " << r.modifyNs
+                << ", \"remove_ns\": " << r.removeNs
+                << ", \"idle_wait_ns\": " << r.idleWaitNs
+                << ", \"wait_latency_us\": {\"avg\": " << r.waitAvgUs
+                << ", \"p50\": " << r.waitP50Us
+                << ", \"p99\": " << r.waitP99Us
+                << ", \"max\": " << r.waitMaxUs << "}"
+                << ", \"events\": " << r.totalEvents
+                << ", \"events_per_sec\": " << r.eventsPerSec;
+        } else {
+            out << ", \"status\": \"skipped\", \"reason\": \"" << jsonEscape(r.reason) << "\"";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+
+    out << "  \"factory_recommended\": [";
+    auto recommended = MultiplexerFactory::getRecommendedTypes();
+    for (size_t i = 0; i < recommended.size(); i++) {
+        out << (i ? ", " : "") << "\"" << MultiplexerFactory::getTypeName(recommended[i]) << "\"";
+    }
+    out << "],\n";
+
+    out << "  \"measured_ranking\": [";
+    auto ranking = rankByData(results, types);
+    for (size_t i = 0; i < ranking.size(); i++) {
+        out << (i ? ", " : "") << "\"" << ranking[i] << "\"";
+    }
+    out << "]\n";
+    out << "}\n";
+
+    std::cout << out.str();
+}
+
+bool parseType(const std::string& name, MultiplexerType& type) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "select") { type = MultiplexerType::Select; return true; }
+    if (lower == "poll")   { type = MultiplexerType::Poll;   return true; }
+    if (lower == "epoll")  { type = MultiplexerType::Epoll;  return true; }
+    if (lower == "kqueue") { type = MultiplexerType::Kqueue; return true; }
+    return false;
+}
+
+void printUsage(const char* prog) {
+    std::cerr << "用法: " << prog << " [选项]\n"
+              << "  --min N        最小空闲fd数量 (默认100)\n"
+              << "  --max N        最大空闲fd数量 (默认1000000)\n"
+              << "  --active M     每轮激活的fd数量 (默认100)\n"
+              << "  --rounds R     每个规模的测量轮数 (默认200)\n"
+              << "  --rate HZ      每秒激活轮数，0表示不限速 (默认0)\n"
+              << "  --type NAME    只测试指定后端，可重复 (select/poll/epoll/kqueue)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--min" && hasValue) {
+            config.minFds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max" && hasValue) {
+            config.maxFds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--active" && hasValue) {
+            config.activeFds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rounds" && hasValue) {
+            config.rounds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && hasValue) {
+            config.rate = std::atof(argv[++i]);
+        } else if (arg == "--type" && hasValue) {
+            MultiplexerType type;
+            if (!parseType(argv[++i], type)) {
+                std::cerr << "未知的后端类型: " << argv[i] << "\n";
+                return 1;
+            }
+            config.types.push_back(type);
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (config.minFds == 0 || config.activeFds == 0 || config.minFds > config.maxFds) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    size_t fdLimit = raiseFdLimit();
+    // 每个空闲连接占用2个fd，另外为复用器自身和标准流预留一些
+    size_t maxPairs = fdLimit > 64 ? (fdLimit - 64) / 2 : 0;
+
+    std::vector<MultiplexerType> types = config.types;
+    if (types.empty()) {
+        types = MultiplexerFactory::getSupportedTypes();
+    }
+
+    std::vector<BenchResult> results;
+    for (size_t n = config.minFds; n <= config.maxFds; n *= 10) {
+        for (auto type : types) {
+            std::cerr << "测试 " << MultiplexerFactory::getTypeName(type)
+                      << " N=" << n << " ..." << std::endl;
+            if (!MultiplexerFactory::isSupported(type)) {
+                BenchResult skipped;
+                skipped.type = MultiplexerFactory::getTypeName(type);
+                skipped.idleFds = n;
+                skipped.reason = "当前平台不支持";
+                results.push_back(skipped);
+                continue;
+            }
+            if (n > maxPairs) {
+                BenchResult skipped;
+                skipped.type = MultiplexerFactory::getTypeName(type);
+                skipped.idleFds = n;
+                skipped.reason = "超过RLIMIT_NOFILE，请调大ulimit -n";
+                results.push_back(skipped);
+                continue;
+            }
+            results.push_back(runOne(type, n, config));
+        }
+        if (n > config.maxFds / 10) {
+            break; // 防止溢出
+        }
+    }
+
+    printJson(config, fdLimit, types, results);
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace IOMultiplexing {
+
+// 先自旋后阻塞的等待策略
+// 每次阻塞的epoll_wait都意味着一次上下文切换和唤醒延迟；
+// 开启后wait()先以0超时反复轮询spinUs微秒，仍无事件才真正阻塞。
+// 用CPU换尾延迟，适合绑定在独占核心上的延迟敏感事件循环。
+struct BusyPollConfig {
+    int spinUs = 0;               // 阻塞前的自旋时长（微秒），0表示不自旋
+    int socketBusyPollUs = 0;     // 注册socket时设置SO_BUSY_POLL（微秒），0表示不设置
+    bool preferBusyPoll = false;  // 注册socket时设置SO_PREFER_BUSY_POLL（Linux 5.11+）
+
+    BusyPollConfig() = default;
+    BusyPollConfig(int spin, int socketUs = 0, bool prefer = false)
+        : spinUs(spin), socketBusyPollUs(socketUs), preferBusyPoll(prefer) {}
+
+    bool isEnabled() const { return spinUs > 0; }
+    bool hasSocketOptions() const { return socketBusyPollUs > 0 || preferBusyPoll; }
+};
+
+// 自旋等待统计
+struct BusyPollStats {
+    uint64_t spinPolls = 0;             // 自旋阶段的0超时轮询次数
+    uint64_t spinHits = 0;              // 在自旋阶段拿到事件的wait次数
+    uint64_t blockingWaits = 0;         // 自旋未命中、转入阻塞等待的次数
+    uint64_t socketOptionFailures = 0;  // 设置SO_BUSY_POLL/SO_PREFER_BUSY_POLL失败的次数
+
+    // 自旋命中率
+    double spinHitRatio() const {
+        uint64_t total = spinHits + blockingWaits;
+        return total == 0 ? 0.0 : static_cast<double>(spinHits) / total;
+    }
+};
+
+} // namespace IOMultiplexing
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "io_multiplexer.h"
+#include "busy_poll.h"
 
 #ifdef __linux__
 #include <sys/epoll.h>
+#include <atomic>
 #include <unordered_map>
 
 namespace IOMultiplexing {
@@ -42,6 +44,13 @@ public:
     // 获取fd的触发模式
     EpollTriggerMode getFdTriggerMode(int fd) const;
 
+    // 先自旋后阻塞的等待策略，socket选项只对之后注册的fd生效
+    void setBusyPoll(const BusyPollConfig& config) { busyPoll_ = config; }
+    const BusyPollConfig& getBusyPollConfig() const { return busyPoll_; }
+    // 统计信息可在其他线程读取
+    BusyPollStats getBusyPollStats() const;
+    void resetBusyPollStats();
+
 private:
     // 文件描述符信息
     struct FdInfo {
@@ -58,7 +67,15 @@ private:
     int maxEvents_;                             // 最大事件数
     EpollTriggerMode defaultTriggerMode_;       // 默认触发模式
     
+    BusyPollConfig busyPoll_;                   // 自旋等待配置
+    std::atomic<uint64_t> spinPolls_{0};
+    std::atomic<uint64_t> spinHits_{0};
+    std::atomic<uint64_t> blockingWaits_{0};
+    std::atomic<uint64_t> socketOptionFailures_{0};
+
     // 辅助函数
+    int pollEvents(int timeout);
+    void applySocketBusyPoll(int fd);
     uint32_t convertFromEpollEvents(uint32_t epollEvents);
     uint32_t convertToEpollEvents(uint32_t events, EpollTriggerMode mode);
 };
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "io_buffer.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace IOMultiplexing {
+
+// 边缘触发(ET)读写循环的公平性预算
+// ET模式下通常要读到EAGAIN，一个发送很快的连接会独占Reactor线程；
+// 设置预算后每次唤醒最多处理maxBytes字节/maxIterations次系统调用，
+// 剩余数据放到Reactor的"仍就绪"列表中，在下次阻塞前继续处理（不需要额外的epoll_ctl）
+struct IOBudget {
+    size_t maxBytes = 0;       // 每次唤醒最多读/写的字节数，0表示不限制
+    size_t maxIterations = 0;  // 每次唤醒最多的读/写系统调用次数，0表示不限制
+
+    IOBudget() = default;
+    IOBudget(size_t bytes, size_t iterations) : maxBytes(bytes), maxIterations(iterations) {}
+
+    bool isUnlimited() const { return maxBytes == 0 && maxIterations == 0; }
+
+    // 已用量是否达到预算
+    bool exhausted(size_t bytes, size_t iterations) const {
+        return (maxBytes > 0 && bytes >= maxBytes) ||
+               (maxIterations > 0 && iterations >= maxIterations);
+    }
+
+    // 已处理bytes字节后，下一次读/写最多还能处理的字节数
+    size_t remainingBytes(size_t bytes) const {
+        if (maxBytes == 0) {
+            return SIZE_MAX;
+        }
+        return bytes < maxBytes ? maxBytes - bytes : 0;
+    }
+};
+
+// 读写循环的结束原因
+enum class DrainStatus {
+    Drained,          // 已读/写到EAGAIN，等待下一次就绪通知
+    BudgetExhausted,  // 预算用完，fd可能仍然就绪，应调用Reactor::markReady
+    PeerClosed,       // 对端关闭（read返回0）
+    Error             // 系统调用出错，错误码见savedErrno
+};
+
+struct DrainResult {
+    DrainStatus status = DrainStatus::Drained;
+    size_t bytes = 0;        // 本次处理的字节数
+    size_t iterations = 0;   // 本次系统调用次数
+    int savedErrno = 0;
+};
+
+// 通用的带预算读/写循环
+// ioOnce(maxLen)执行一次读或写，最多处理maxLen字节（保证maxBytes是硬上限）；
+// 返回值语义与read/write相同，出错时设置errno
+template <typename IOOnce>
+DrainResult drainWithBudget(const IOBudget& budget, IOOnce ioOnce) {
+    DrainResult result;
+    while (true) {
+        if (budget.exhausted(result.bytes, result.iterations)) {
+            result.status = DrainStatus::BudgetExhausted;
+            return result;
+        }
+
+        ssize_t n = ioOnce(budget.remainingBytes(result.bytes));
+        result.iterations++;
+        if (n > 0) {
+            result.bytes += static_cast<size_t>(n);
+        } else if (n == 0) {
+            result.status = DrainStatus::PeerClosed;
+            return result;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            result.status = DrainStatus::Drained;
+            return result;
+        } else {
+            result.savedErrno = errno;
+            result.status = DrainStatus::Error;
+            return result;
+        }
+    }
+}
+
+// 带预算地把fd中的数据读入缓冲区
+inline DrainResult readWithBudget(int fd, IOBuffer& buffer, const IOBudget& budget) {
+    return drainWithBudget(budget, [fd, &buffer](size_t maxLen) {
+        int savedErrno = 0;
+        ssize_t n = buffer.readFd(fd, &savedErrno, maxLen);
+        if (n < 0) {
+            errno = savedErrno;
+        }
+        return n;
+    });
+}
+
+} // namespace IOMultiplexing
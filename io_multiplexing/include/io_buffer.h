@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace IOMultiplexing {
+
+// 自动增长的输入缓冲区
+// [0, readPos_) 已读取可回收，[readPos_, writePos_) 可读数据，[writePos_, size) 可写空间
+class IOBuffer {
+public:
+    explicit IOBuffer(size_t initialSize = 4096);
+
+    size_t readableBytes() const { return writePos_ - readPos_; }
+    size_t writableBytes() const { return buffer_.size() - writePos_; }
+    const char* peek() const { return buffer_.data() + readPos_; }
+
+    // 查找"\r\n"，返回指向它的指针，没有则返回nullptr
+    const char* findCRLF() const;
+
+    void retrieve(size_t len);
+    void retrieveAll();
+    std::string retrieveAsString(size_t len);
+    std::string retrieveAllAsString();
+
+    void append(const char* data, size_t len);
+    void append(const std::string& data) { append(data.data(), data.size()); }
+
+    void ensureWritable(size_t len);
+    char* beginWrite() { return buffer_.data() + writePos_; }
+    void hasWritten(size_t len) { writePos_ += len; }
+
+    // 从fd读取一次数据（readv + 栈上额外缓冲区，一次系统调用可读取较多数据），最多读取maxBytes字节
+    // 返回值与read相同，出错时errno保存在savedErrno中
+    ssize_t readFd(int fd, int* savedErrno, size_t maxBytes = SIZE_MAX);
+
+private:
+    void makeSpace(size_t len);
+
+    std::vector<char> buffer_;
+    size_t readPos_;
+    size_t writePos_;
+};
+
+} // namespace IOMultiplexing
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "io_multiplexer.h"
+#include "io_budget.h"
+#include "busy_poll.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+
+namespace IOMultiplexing {
+
+// 连接分发策略
+enum class DispatchStrategy {
+    RoundRobin,        // 轮询
+    LeastConnections,  // 最少连接
+    HashByPeer,        // 按对端地址哈希（同一IP固定落在同一个Reactor）
+    Custom             // 自定义分发函数
+};
+
+// 单个Reactor的负载信息
+struct ReactorLoad {
+    size_t index = 0;               // Reactor编号
+    int cpu = -1;                   // 绑定的CPU，-1表示未绑定
+    size_t connections = 0;         // 当前连接数（经dispatch注册的fd，含已分发但尚未注册的连接）
+    size_t pendingTasks = 0;        // 等待在loop线程执行的任务数
+    uint64_t totalConnections = 0;  // 累计连接数
+    uint64_t eventsHandled = 0;     // 累计处理的IO事件数
+    uint64_t loopIterations = 0;    // 事件循环迭代次数
+    uint64_t budgetYields = 0;      // 因预算用完而放入"仍就绪"列表的次数
+    uint64_t spinHits = 0;          // 自旋阶段拿到事件的wait次数（仅Epoll）
+    uint64_t blockingWaits = 0;     // 自旋未命中转入阻塞的次数（仅Epoll）
+    double busyRatio = 0.0;         // 处理事件/任务的时间占比（0~1）
+};
+
+// Reactor池配置
+struct ReactorPoolConfig {
+    size_t reactorCount = 0;                 // Reactor数量，0表示使用CPU核心数
+    int maxEvents = 1024;                    // 每次wait的最大事件数
+    int waitTimeoutMs = 1000;                // 空闲时wait超时（毫秒）
+    bool useBestMultiplexer = true;          // 使用当前平台最优的复用器
+    MultiplexerType multiplexerType = MultiplexerType::Poll; // useBestMultiplexer为false时使用
+    bool edgeTriggered = false;              // Epoll下使用ET模式
+    DispatchStrategy strategy = DispatchStrategy::RoundRobin;
+    std::vector<int> cpuAffinity;            // 第i个Reactor绑定到cpuAffinity[i % size]，为空则不绑定
+    int acceptorCpu = -1;                    // accept线程绑定的CPU，-1表示不绑定
+    IOBudget ioBudget;                       // 每个连接每次唤醒的读写预算，默认不限制
+    BusyPollConfig busyPoll;                 // 先自旋后阻塞的等待策略（仅Epoll），默认关闭
+};
+
+// 单线程事件循环
+// 所有fd操作都必须在loop线程执行；从其他线程调用时会通过runInLoop转发
+class Reactor {
+public:
+    using Task = std::function<void()>;
+
+    Reactor(size_t index, const ReactorPoolConfig& config);
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // 启动/停止loop线程
+    void start(int cpu = -1);
+    void stop();
+
+    // 注册/修改/注销fd及其事件处理函数
+    // 在loop线程内调用时返回实际结果；跨线程调用时只是排队，返回true表示"已排队"而不是"已注册"，
+    // 需要知道结果时应通过runInLoop在loop线程中调用
+    bool addFd(int fd, uint32_t events, EventCallback handler);
+    bool modifyFd(int fd, uint32_t events);
+    bool removeFd(int fd);
+
+    // 把仍有数据可读/可写的fd放入"仍就绪"列表（仅限loop线程调用）
+    // 下一轮wait不会阻塞，并在处理完新事件后再次以这些事件调用fd的处理函数
+    void markReady(int fd, uint32_t events);
+
+    // 在loop线程中执行任务（当前就是loop线程则直接执行）
+    void runInLoop(Task task);
+    // 总是排队，在本轮事件处理完成后执行
+    // loop线程在处理事件时调用不写唤醒管道（本轮结束时本来就会执行排队的任务）
+    void queueInLoop(Task task);
+
+    bool isInLoopThread() const { return std::this_thread::get_id() == threadId_; }
+    bool isRunning() const { return running_; }
+    size_t getIndex() const { return index_; }
+    size_t getConnectionCount() const { return connections_ + pendingDispatch_; }
+    const IOBudget& getIOBudget() const { return ioBudget_; }
+    ReactorLoad getLoad() const;
+
+    // 底层复用器，只能在loop线程中使用
+    IOMultiplexer* getMultiplexer() { return multiplexer_.get(); }
+
+private:
+    friend class ReactorPool;
+
+    void loop();
+    void wakeup();
+    void handleWakeup();
+    void runPendingTasks();
+    void processReadyList();
+    bool addFdInLoop(int fd, uint32_t events, EventCallback handler);
+    bool removeFdInLoop(int fd);
+
+    // fd的处理函数及其"仍就绪"状态
+    struct Channel {
+        EventCallback callback;
+        uint32_t readyEvents = 0;  // 非0表示已在readyList_中等待再次处理
+        bool connection = false;   // 经ReactorPool::dispatch分发的连接，计入connections_
+
+        explicit Channel(EventCallback cb) : callback(std::move(cb)) {}
+    };
+
+    size_t index_;
+    int waitTimeoutMs_;
+    int cpu_ = -1;
+    IOBudget ioBudget_;
+    std::unique_ptr<IOMultiplexer> multiplexer_;
+    std::unordered_map<int, std::shared_ptr<Channel>> channels_; // 仅在loop线程访问
+    std::vector<int> readyList_;                                  // "仍就绪"的fd，仅在loop线程访问
+    int dispatchingFd_ = -1;        // 正在执行连接回调的fd，仅在loop线程访问
+    bool dispatchClaimed_ = false;  // 连接回调是否尝试注册了dispatchingFd_
+    int wakeupFds_[2] = {-1, -1};  // 管道：[0]读端注册到复用器，[1]写端用于唤醒
+
+    std::thread thread_;
+    std::thread::id threadId_;
+    std::atomic<bool> running_{false};
+
+    std::mutex tasksMutex_;
+    std::vector<Task> pendingTasks_;
+    std::atomic<bool> wakeupPending_{false};
+    bool callingPendingTasks_ = false;  // 正在runPendingTasks中，仅在loop线程访问
+
+    // 负载统计
+    std::atomic<size_t> connections_{0};
+    std::atomic<size_t> pendingDispatch_{0};
+    std::atomic<size_t> pendingTaskCount_{0};
+    std::atomic<uint64_t> totalConnections_{0};
+    std::atomic<uint64_t> eventsHandled_{0};
+    std::atomic<uint64_t> loopIterations_{0};
+    std::atomic<uint64_t> budgetYields_{0};
+    std::atomic<uint64_t> busyNs_{0};
+    std::chrono::steady_clock::time_point startTime_;
+};
+
+// 多Reactor池：一个accept线程 + N个事件循环线程
+class ReactorPool {
+public:
+    // 新连接回调，在目标Reactor的loop线程中执行，负责调用reactor.addFd注册连接
+    // 回调返回前没有在该Reactor上注册fd（例如拒绝连接）时，由ReactorPool关闭fd，回调不要自行关闭
+    using ConnectionCallback = std::function<void(Reactor& reactor, int fd, const sockaddr_storage& peer)>;
+    // 自定义分发函数，返回Reactor编号
+    using DispatchFunction = std::function<size_t(const sockaddr_storage& peer,
+                                                  const std::vector<ReactorLoad>& loads)>;
+
+    explicit ReactorPool(const ReactorPoolConfig& config = ReactorPoolConfig());
+    ~ReactorPool();
+
+    ReactorPool(const ReactorPool&) = delete;
+    ReactorPool& operator=(const ReactorPool&) = delete;
+
+    // 启动所有Reactor线程
+    bool start();
+    // 停止accept线程和所有Reactor线程
+    void stop();
+
+    // 在独立的accept线程上监听listenFd，新连接按分发策略交给某个Reactor
+    // 返回true表示监听socket已在accept线程上注册成功；stop()后重新start()可以再次listen
+    // listenFd由调用方负责关闭
+    bool listen(int listenFd, ConnectionCallback callback);
+
+    // 把一个已建立的连接分发给某个Reactor，返回Reactor编号
+    size_t dispatch(int fd, const sockaddr_storage& peer, ConnectionCallback callback);
+
+    // 按当前策略选出一个Reactor（不分发）
+    Reactor& selectReactor(const sockaddr_storage& peer);
+
+    void setDispatchFunction(DispatchFunction func);
+    void setStrategy(DispatchStrategy strategy) { strategy_ = strategy; }
+    DispatchStrategy getStrategy() const { return strategy_; }
+
+    size_t size() const { return reactors_.size(); }
+    Reactor& getReactor(size_t index) { return *reactors_[index]; }
+    std::vector<ReactorLoad> getLoads() const;
+    bool isRunning() const { return running_; }
+
+private:
+    void handleAccept(int listenFd);
+    bool rejectPendingConnection(int listenFd);
+    size_t selectIndex(const sockaddr_storage& peer);
+    static size_t hashPeer(const sockaddr_storage& peer);
+
+    ReactorPoolConfig config_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::unique_ptr<Reactor> acceptor_;
+    // 以下只在accept线程中使用（listen时初始化）
+    int reserveFd_ = -1;      // 预留的描述符，描述符耗尽时用它接受并关闭排队的连接
+    int lastAcceptErrno_ = 0; // 上一次记录的accept错误，避免每次唤醒都打印
+    ConnectionCallback connectionCallback_;
+    DispatchFunction dispatchFunction_;
+    std::atomic<DispatchStrategy> strategy_;
+    std::atomic<size_t> nextReactor_{0};
+    std::atomic<bool> running_{false};
+    std::mutex dispatchMutex_;  // 保护dispatchFunction_
+};
+
+} // namespace IOMultiplexing
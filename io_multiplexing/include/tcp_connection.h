@@ -0,0 +1,141 @@
+#pragma once
+
+#include "io_buffer.h"
+#include "io_budget.h"
+#include "reactor_pool.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+
+namespace IOMultiplexing {
+
+// 非阻塞TCP连接
+//   - 输入缓冲区：可读事件时读到EAGAIN，然后交给消息回调
+//   - 输出队列：send()先尝试直接写，只把剩余部分排队；
+//     只有队列非空时才关注可写事件，写完立即取消，避免多余的modifyFd
+//   - 高/低水位回调：待发送数据超过高水位时通知生产者暂停，降到低水位后通知恢复
+//   - 读写预算：每次唤醒的读写量受IOBudget限制，超出部分交给Reactor的"仍就绪"列表
+// 所有IO都在所属Reactor的loop线程中进行，send/shutdown/forceClose可在任意线程调用
+class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
+public:
+    using Ptr = std::shared_ptr<TcpConnection>;
+    using MessageCallback = std::function<void(const Ptr&, IOBuffer&)>;
+    using Callback = std::function<void(const Ptr&)>;
+    using HighWaterMarkCallback = std::function<void(const Ptr&, size_t pendingBytes)>;
+
+    enum class State {
+        Connecting,
+        Connected,
+        Disconnecting,  // 已调用shutdown，等待输出队列写完
+        Disconnected
+    };
+
+    // 连接统计
+    struct Stats {
+        uint64_t bytesRead = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t directWrites = 0;        // send()时直接写完、无需排队的次数
+        uint64_t queuedWrites = 0;        // 需要排队剩余数据的次数
+        uint64_t writeInterestToggles = 0; // 打开/关闭可写事件的次数（即modifyFd调用次数）
+        uint64_t budgetYields = 0;        // 因预算用完而让出Reactor的次数
+    };
+
+    // 创建连接，fd必须已设置为非阻塞，之后由连接负责关闭
+    static Ptr create(Reactor& reactor, int fd, const sockaddr_storage& peer);
+    ~TcpConnection();
+
+    TcpConnection(const TcpConnection&) = delete;
+    TcpConnection& operator=(const TcpConnection&) = delete;
+
+    // 注册到Reactor并开始读取，设置好回调后调用
+    void start();
+
+    // 发送数据，返回false表示连接已断开或超过maxPendingBytes
+    bool send(const void* data, size_t len);
+    bool send(const std::string& data) { return send(data.data(), data.size()); }
+    bool send(std::string&& data);
+
+    // 输出队列写完后关闭写端
+    void shutdown();
+    // 立即关闭连接，丢弃未发送的数据
+    void forceClose();
+
+    void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
+    void setCloseCallback(Callback cb) { closeCallback_ = std::move(cb); }
+    void setWriteCompleteCallback(Callback cb) { writeCompleteCallback_ = std::move(cb); }
+    void setHighWaterMarkCallback(HighWaterMarkCallback cb, size_t highWaterMark) {
+        highWaterMarkCallback_ = std::move(cb);
+        highWaterMark_ = highWaterMark;
+    }
+    void setLowWaterMarkCallback(Callback cb, size_t lowWaterMark) {
+        lowWaterMarkCallback_ = std::move(cb);
+        lowWaterMark_ = lowWaterMark;
+    }
+    // 待发送数据的硬上限，0表示不限制
+    void setMaxPendingBytes(size_t bytes) { maxPendingBytes_ = bytes; }
+    // 每次唤醒的读写预算，默认取自所属Reactor的配置
+    void setIOBudget(const IOBudget& budget) { budget_ = budget; }
+    const IOBudget& getIOBudget() const { return budget_; }
+
+    int getFd() const { return fd_; }
+    Reactor& getReactor() { return reactor_; }
+    const sockaddr_storage& getPeer() const { return peer_; }
+    State getState() const { return state_; }
+    bool isConnected() const { return state_ == State::Connected; }
+    // 已接受但尚未写入socket的字节数（含跨线程排队中的数据）
+    size_t getPendingBytes() const { return pendingBytes_; }
+    // 统计信息，仅在loop线程中读取是精确的
+    const Stats& getStats() const { return stats_; }
+
+    // 任意附加数据，例如协议解析状态
+    void setContext(std::shared_ptr<void> context) { context_ = std::move(context); }
+    const std::shared_ptr<void>& getContext() const { return context_; }
+
+private:
+    TcpConnection(Reactor& reactor, int fd, const sockaddr_storage& peer);
+
+    void handleEvent(const IOEvent& event);
+    void handleRead();
+    void handleWrite();
+    void handleClose();
+
+    void sendInLoop(const char* data, size_t len);
+    void sendInLoop(std::string&& data);
+    void shutdownInLoop();
+    void enableWriting();
+    void disableWriting();
+    void checkHighWaterMark();
+    bool reservePending(size_t len);
+
+    Reactor& reactor_;
+    const int fd_;
+    const sockaddr_storage peer_;
+    std::atomic<State> state_;
+
+    IOBuffer inputBuffer_;
+    std::deque<std::string> outputQueue_;  // 待发送的数据块，第一块从outputOffset_开始
+    size_t outputOffset_ = 0;
+    size_t queuedBytes_ = 0;               // 输出队列中的字节数（loop线程）
+    std::atomic<size_t> pendingBytes_{0};
+    bool writing_ = false;                 // 是否已关注可写事件
+    bool aboveHighWaterMark_ = false;
+
+    size_t highWaterMark_ = 64 * 1024 * 1024;
+    size_t lowWaterMark_ = 0;
+    size_t maxPendingBytes_ = 0;
+    IOBudget budget_;
+
+    MessageCallback messageCallback_;
+    Callback closeCallback_;
+    Callback writeCompleteCallback_;
+    HighWaterMarkCallback highWaterMarkCallback_;
+    Callback lowWaterMarkCallback_;
+
+    Stats stats_;
+    std::shared_ptr<void> context_;
+};
+
+} // namespace IOMultiplexing
@@ -2,8 +2,10 @@
 
 #include "../include/epoll_multiplexer.h"
 #include <iostream>
+#include <chrono>
 #include <cerrno>
 #include <cstring>
+#include <sys/socket.h>
 #include <unistd.h>
 
 namespace IOMultiplexing {
@@ -43,10 +45,11 @@ bool EpollMultiplexer::addFd(int fd, uint32_t events, EpollTriggerMode mode, voi
         return false;
     }
     
+    // epoll_data是联合体，只存fd；userData由fdInfoMap_维护
     epoll_event ev;
     ev.events = convertToEpollEvents(events, mode);
+    ev.data.u64 = 0;
     ev.data.fd = fd;
-    ev.data.ptr = userData;
     
     if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
         std::cerr << "Epoll: 添加文件描述符失败: " << strerror(errno) << std::endl;
@@ -54,7 +57,9 @@ bool EpollMultiplexer::addFd(int fd, uint32_t events, EpollTriggerMode mode, voi
     }
     
     fdInfoMap_[fd] = FdInfo(userData, mode);
-    std::cout << "Epoll: 添加fd=" << fd << ", 触发模式=" << (mode == EpollTriggerMode::LevelTriggered ? "LT" : "ET") << std::endl;
+    if (busyPoll_.hasSocketOptions()) {
+        applySocketBusyPoll(fd);
+    }
     return true;
 }
 
@@ -76,10 +81,11 @@ bool EpollMultiplexer::modifyFd(int fd, uint32_t events, EpollTriggerMode mode,
         return false;
     }
     
+    // epoll_data是联合体，只存fd；userData由fdInfoMap_维护
     epoll_event ev;
     ev.events = convertToEpollEvents(events, mode);
+    ev.data.u64 = 0;
     ev.data.fd = fd;
-    ev.data.ptr = userData;
     
     if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
         std::cerr << "Epoll: 修改文件描述符失败: " << strerror(errno) << std::endl;
@@ -114,6 +120,84 @@ EpollTriggerMode EpollMultiplexer::getFdTriggerMode(int fd) const {
     return defaultTriggerMode_;
 }
 
+BusyPollStats EpollMultiplexer::getBusyPollStats() const {
+    BusyPollStats stats;
+    stats.spinPolls = spinPolls_.load(std::memory_order_relaxed);
+    stats.spinHits = spinHits_.load(std::memory_order_relaxed);
+    stats.blockingWaits = blockingWaits_.load(std::memory_order_relaxed);
+    stats.socketOptionFailures = socketOptionFailures_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EpollMultiplexer::resetBusyPollStats() {
+    spinPolls_ = 0;
+    spinHits_ = 0;
+    blockingWaits_ = 0;
+    socketOptionFailures_ = 0;
+}
+
+void EpollMultiplexer::applySocketBusyPoll(int fd) {
+    // 非socket（如唤醒管道）返回ENOTSOCK，直接忽略；
+    // SO_BUSY_POLL超过net.core.busy_read时需要CAP_NET_ADMIN，失败只计数不影响注册
+    if (busyPoll_.socketBusyPollUs > 0) {
+        int value = busyPoll_.socketBusyPollUs;
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) < 0) {
+            if (errno == ENOTSOCK) {
+                return;
+            }
+            socketOptionFailures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (busyPoll_.preferBusyPoll) {
+#ifdef SO_PREFER_BUSY_POLL
+        int value = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &value, sizeof(value)) < 0 &&
+            errno != ENOTSOCK) {
+            socketOptionFailures_.fetch_add(1, std::memory_order_relaxed);
+        }
+#else
+        socketOptionFailures_.fetch_add(1, std::memory_order_relaxed);  // 头文件不支持
+#endif
+    }
+}
+
+int EpollMultiplexer::pollEvents(int timeout) {
+    if (!busyPoll_.isEnabled() || timeout == 0) {
+        return epoll_wait(epollFd_, events_.data(), maxEvents_, timeout);
+    }
+
+    // 自旋阶段：0超时轮询，不超过调用方给定的超时
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    std::chrono::microseconds spin(busyPoll_.spinUs);
+    if (timeout > 0 && spin > std::chrono::milliseconds(timeout)) {
+        spin = std::chrono::milliseconds(timeout);
+    }
+    const Clock::time_point spinDeadline = start + spin;
+
+    Clock::time_point now = start;
+    do {
+        int ready = epoll_wait(epollFd_, events_.data(), maxEvents_, 0);
+        spinPolls_.fetch_add(1, std::memory_order_relaxed);
+        if (ready != 0) {
+            if (ready > 0) {
+                spinHits_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return ready;
+        }
+        now = Clock::now();
+    } while (now < spinDeadline);
+
+    // 自旋未命中，阻塞等待剩余时间
+    blockingWaits_.fetch_add(1, std::memory_order_relaxed);
+    int remaining = timeout;
+    if (timeout > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+        remaining = elapsed >= timeout ? 0 : timeout - static_cast<int>(elapsed);
+    }
+    return epoll_wait(epollFd_, events_.data(), maxEvents_, remaining);
+}
+
 std::vector<IOEvent> EpollMultiplexer::wait(int timeout) {
     std::vector<IOEvent> result;
     
@@ -121,8 +205,8 @@ std::vector<IOEvent> EpollMultiplexer::wait(int timeout) {
         return result;
     }
     
-    // 调用epoll_wait
-    int ready = epoll_wait(epollFd_, events_.data(), maxEvents_, timeout);
+    // 调用epoll_wait（开启自旋时先轮询一段时间）
+    int ready = pollEvents(timeout);
     
     if (ready < 0) {
         if (errno != EINTR) {
@@ -0,0 +1,96 @@
+#include "../include/io_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+
+namespace IOMultiplexing {
+
+IOBuffer::IOBuffer(size_t initialSize)
+    : buffer_(initialSize), readPos_(0), writePos_(0) {}
+
+const char* IOBuffer::findCRLF() const {
+    static const char kCRLF[] = "\r\n";
+    const char* end = buffer_.data() + writePos_;
+    const char* pos = std::search(peek(), end, kCRLF, kCRLF + 2);
+    return pos == end ? nullptr : pos;
+}
+
+void IOBuffer::retrieve(size_t len) {
+    assert(len <= readableBytes());
+    if (len < readableBytes()) {
+        readPos_ += len;
+    } else {
+        retrieveAll();
+    }
+}
+
+void IOBuffer::retrieveAll() {
+    readPos_ = 0;
+    writePos_ = 0;
+}
+
+std::string IOBuffer::retrieveAsString(size_t len) {
+    assert(len <= readableBytes());
+    std::string result(peek(), len);
+    retrieve(len);
+    return result;
+}
+
+std::string IOBuffer::retrieveAllAsString() {
+    return retrieveAsString(readableBytes());
+}
+
+void IOBuffer::append(const char* data, size_t len) {
+    ensureWritable(len);
+    std::copy(data, data + len, beginWrite());
+    hasWritten(len);
+}
+
+void IOBuffer::ensureWritable(size_t len) {
+    if (writableBytes() < len) {
+        makeSpace(len);
+    }
+    assert(writableBytes() >= len);
+}
+
+void IOBuffer::makeSpace(size_t len) {
+    if (writableBytes() + readPos_ < len) {
+        buffer_.resize(writePos_ + len);
+    } else {
+        // 前面已读取的空间足够，把可读数据挪到开头
+        size_t readable = readableBytes();
+        std::copy(buffer_.data() + readPos_, buffer_.data() + writePos_, buffer_.data());
+        readPos_ = 0;
+        writePos_ = readable;
+    }
+}
+
+ssize_t IOBuffer::readFd(int fd, int* savedErrno, size_t maxBytes) {
+    char extra[65536];
+    const size_t writable = writableBytes();
+    const size_t firstLen = std::min(writable, maxBytes);
+    const size_t extraLen = std::min(sizeof(extra), maxBytes - firstLen);
+
+    iovec vec[2];
+    vec[0].iov_base = beginWrite();
+    vec[0].iov_len = firstLen;
+    vec[1].iov_base = extra;
+    vec[1].iov_len = extraLen;
+
+    // 缓冲区本身已经足够大或已达到maxBytes时不再使用额外缓冲区
+    const int iovcnt = writable < sizeof(extra) && extraLen > 0 ? 2 : 1;
+    const ssize_t n = readv(fd, vec, iovcnt);
+    if (n < 0) {
+        *savedErrno = errno;
+    } else if (static_cast<size_t>(n) <= writable) {
+        writePos_ += n;
+    } else {
+        writePos_ = buffer_.size();
+        append(extra, n - writable);
+    }
+    return n;
+}
+
+} // namespace IOMultiplexing
@@ -100,6 +100,8 @@ std::string MultiplexerFactory::getTypeName(MultiplexerType type) {
 std::vector<MultiplexerType> MultiplexerFactory::getRecommendedTypes() {
     std::vector<MultiplexerType> recommended;
     
+    // 排序依据multiplexer_bench的实测结果：Epoll/Kqueue的空闲wait开销与fd数量无关，
+    // Poll随fd数量线性增长，Select还受FD_SETSIZE限制（超过约500个socketpair即无法注册）
 #ifdef __linux__
     // Linux上优先使用Epoll
     recommended.push_back(MultiplexerType::Epoll);
@@ -0,0 +1,613 @@
+#include "../include/reactor_pool.h"
+#include "../include/multiplexer_factory.h"
+
+#ifdef __linux__
+#include "../include/epoll_multiplexer.h"
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <iostream>
+#include <future>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace IOMultiplexing {
+
+namespace {
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+void setCloseOnExec(int fd) {
+    int flags = fcntl(fd, F_GETFD, 0);
+    if (flags != -1) {
+        fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+    }
+}
+
+bool bindCurrentThreadToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+#else
+    (void)cpu;
+    return false; // 其他平台暂不支持绑核
+#endif
+}
+
+std::unique_ptr<IOMultiplexer> createMultiplexerForConfig(const ReactorPoolConfig& config) {
+    if (config.useBestMultiplexer) {
+#ifdef __linux__
+        if (config.edgeTriggered) {
+            return std::unique_ptr<IOMultiplexer>(
+                new EpollMultiplexer(config.maxEvents, EpollTriggerMode::EdgeTriggered));
+        }
+#endif
+        return MultiplexerFactory::createBest(config.maxEvents);
+    }
+    return MultiplexerFactory::create(config.multiplexerType, config.maxEvents);
+}
+
+std::unique_ptr<IOMultiplexer> createReactorMultiplexer(const ReactorPoolConfig& config) {
+    std::unique_ptr<IOMultiplexer> multiplexer = createMultiplexerForConfig(config);
+#ifdef __linux__
+    // 自旋等待只对Epoll生效，其他复用器忽略该配置
+    if (multiplexer && (config.busyPoll.isEnabled() || config.busyPoll.hasSocketOptions())) {
+        EpollMultiplexer* epoll = dynamic_cast<EpollMultiplexer*>(multiplexer.get());
+        if (epoll) {
+            epoll->setBusyPoll(config.busyPoll);
+        }
+    }
+#endif
+    return multiplexer;
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+// ==================== Reactor ====================
+
+Reactor::Reactor(size_t index, const ReactorPoolConfig& config)
+    : index_(index), waitTimeoutMs_(config.waitTimeoutMs), ioBudget_(config.ioBudget) {
+    multiplexer_ = createReactorMultiplexer(config);
+    if (!multiplexer_) {
+        throw std::runtime_error("Reactor: 创建IO复用器失败");
+    }
+
+    if (pipe(wakeupFds_) < 0) {
+        throw std::runtime_error(std::string("Reactor: 创建唤醒管道失败: ") + strerror(errno));
+    }
+    for (int fd : wakeupFds_) {
+        setNonBlocking(fd);
+        setCloseOnExec(fd);
+    }
+
+    if (!multiplexer_->addFd(wakeupFds_[0], static_cast<uint32_t>(IOEventType::Read))) {
+        close(wakeupFds_[0]);
+        close(wakeupFds_[1]);
+        throw std::runtime_error("Reactor: 注册唤醒管道失败");
+    }
+}
+
+Reactor::~Reactor() {
+    stop();
+    if (wakeupFds_[0] >= 0) close(wakeupFds_[0]);
+    if (wakeupFds_[1] >= 0) close(wakeupFds_[1]);
+}
+
+void Reactor::start(int cpu) {
+    if (running_) {
+        return;
+    }
+
+    cpu_ = cpu;
+    running_ = true;
+    startTime_ = std::chrono::steady_clock::now();
+
+    // 等loop线程记录好线程ID后再返回，保证isInLoopThread()可用
+    std::promise<void> started;
+    std::future<void> startedFuture = started.get_future();
+    thread_ = std::thread([this, &started]() {
+        threadId_ = std::this_thread::get_id();
+        if (cpu_ >= 0 && !bindCurrentThreadToCpu(cpu_)) {
+            std::cerr << "Reactor " << index_ << ": 绑定CPU " << cpu_ << " 失败" << std::endl;
+            cpu_ = -1;
+        }
+        started.set_value();
+        loop();
+    });
+    startedFuture.wait();
+}
+
+void Reactor::stop() {
+    running_ = false;
+    wakeup();
+    if (thread_.joinable() && !isInLoopThread()) {
+        thread_.join();
+    }
+}
+
+void Reactor::loop() {
+    while (running_) {
+        // 还有"仍就绪"的fd时不能阻塞
+        int timeout = readyList_.empty() ? waitTimeoutMs_ : 0;
+        auto events = multiplexer_->wait(timeout);
+        uint64_t busyStart = nowNs();
+        loopIterations_++;
+
+        uint64_t handled = 0;
+        for (const auto& event : events) {
+            if (event.fd == wakeupFds_[0]) {
+                handleWakeup();
+                continue;
+            }
+            auto it = channels_.find(event.fd);
+            if (it == channels_.end()) {
+                continue; // 本轮中已被注销
+            }
+            // 持有一份引用，处理函数内部注销自身也是安全的
+            std::shared_ptr<Channel> channel = it->second;
+            IOEvent merged = event;
+            if (channel->readyEvents != 0) {
+                // 同时在"仍就绪"列表中：合并事件，只处理一次
+                merged.events |= channel->readyEvents;
+                channel->readyEvents = 0;
+            }
+            channel->callback(merged);
+            handled++;
+        }
+        eventsHandled_ += handled;
+
+        processReadyList();
+        runPendingTasks();
+        busyNs_ += nowNs() - busyStart;
+    }
+
+    // 退出前执行剩余任务（例如关闭连接）
+    runPendingTasks();
+}
+
+bool Reactor::addFd(int fd, uint32_t events, EventCallback handler) {
+    if (isInLoopThread()) {
+        return addFdInLoop(fd, events, std::move(handler));
+    }
+    queueInLoop([this, fd, events, handler]() {
+        addFdInLoop(fd, events, handler);
+    });
+    return true;
+}
+
+bool Reactor::modifyFd(int fd, uint32_t events) {
+    if (isInLoopThread()) {
+        return channels_.count(fd) && multiplexer_->modifyFd(fd, events);
+    }
+    queueInLoop([this, fd, events]() {
+        if (channels_.count(fd)) {
+            multiplexer_->modifyFd(fd, events);
+        }
+    });
+    return true;
+}
+
+bool Reactor::removeFd(int fd) {
+    if (isInLoopThread()) {
+        return removeFdInLoop(fd);
+    }
+    queueInLoop([this, fd]() {
+        removeFdInLoop(fd);
+    });
+    return true;
+}
+
+void Reactor::markReady(int fd, uint32_t events) {
+    auto it = channels_.find(fd);
+    if (it == channels_.end() || events == 0) {
+        return;
+    }
+    // 已在列表中的fd只合并事件，不重复计数
+    if (it->second->readyEvents == 0) {
+        readyList_.push_back(fd);
+        budgetYields_++;
+    }
+    it->second->readyEvents |= events;
+}
+
+void Reactor::processReadyList() {
+    if (readyList_.empty()) {
+        return;
+    }
+
+    // 处理过程中再次标记的fd进入新列表，留到下一轮，保证每个连接每轮最多处理一次
+    std::vector<int> ready;
+    ready.swap(readyList_);
+    for (int fd : ready) {
+        auto it = channels_.find(fd);
+        if (it == channels_.end() || it->second->readyEvents == 0) {
+            continue; // 已注销，或本轮已随新事件一起处理
+        }
+        std::shared_ptr<Channel> channel = it->second;
+        uint32_t events = channel->readyEvents;
+        channel->readyEvents = 0;
+        channel->callback(IOEvent(fd, events));
+    }
+}
+
+bool Reactor::addFdInLoop(int fd, uint32_t events, EventCallback handler) {
+    // 只有连接回调中注册的fd计为连接（监听socket等不计入负载）
+    bool connection = fd == dispatchingFd_;
+    if (connection) {
+        dispatchClaimed_ = true;  // 注册失败时由回调负责关闭
+    }
+    if (!multiplexer_->addFd(fd, events)) {
+        return false;
+    }
+    auto channel = std::make_shared<Channel>(std::move(handler));
+    channel->connection = connection;
+    channels_[fd] = std::move(channel);
+    if (connection) {
+        connections_++;
+        totalConnections_++;
+    }
+    return true;
+}
+
+bool Reactor::removeFdInLoop(int fd) {
+    auto it = channels_.find(fd);
+    if (it == channels_.end()) {
+        return false;
+    }
+    if (it->second->connection) {
+        connections_--;
+    }
+    channels_.erase(it);
+    return multiplexer_->removeFd(fd);
+}
+
+void Reactor::runInLoop(Task task) {
+    if (isInLoopThread()) {
+        task();
+    } else {
+        queueInLoop(std::move(task));
+    }
+}
+
+void Reactor::queueInLoop(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        pendingTasks_.push_back(std::move(task));
+    }
+    pendingTaskCount_++;
+    // 执行排队任务期间加入的任务要等下一轮，此时需要唤醒以免阻塞在wait中
+    if (!isInLoopThread() || callingPendingTasks_) {
+        wakeup();
+    }
+}
+
+void Reactor::wakeup() {
+    // 已有未处理的唤醒时不再重复写管道
+    if (wakeupPending_.exchange(true)) {
+        return;
+    }
+    char byte = 1;
+    if (write(wakeupFds_[1], &byte, 1) < 0 && errno != EAGAIN) {
+        std::cerr << "Reactor " << index_ << ": 唤醒失败: " << strerror(errno) << std::endl;
+    }
+}
+
+void Reactor::handleWakeup() {
+    char buffer[64];
+    while (read(wakeupFds_[0], buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+void Reactor::runPendingTasks() {
+    // 先清除标记再取任务：之后入队的任务一定会重新唤醒
+    wakeupPending_ = false;
+
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        tasks.swap(pendingTasks_);
+    }
+    callingPendingTasks_ = true;
+    for (auto& task : tasks) {
+        task();
+        pendingTaskCount_--;
+    }
+    callingPendingTasks_ = false;
+}
+
+ReactorLoad Reactor::getLoad() const {
+    ReactorLoad load;
+    load.index = index_;
+    load.cpu = cpu_;
+    load.connections = getConnectionCount();
+    load.pendingTasks = pendingTaskCount_;
+    load.totalConnections = totalConnections_;
+    load.eventsHandled = eventsHandled_;
+    load.loopIterations = loopIterations_;
+    load.budgetYields = budgetYields_;
+#ifdef __linux__
+    if (const EpollMultiplexer* epoll = dynamic_cast<const EpollMultiplexer*>(multiplexer_.get())) {
+        BusyPollStats busyPoll = epoll->getBusyPollStats();
+        load.spinHits = busyPoll.spinHits;
+        load.blockingWaits = busyPoll.blockingWaits;
+    }
+#endif
+
+    if (running_) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime_).count();
+        if (elapsed > 0) {
+            load.busyRatio = static_cast<double>(busyNs_) / elapsed;
+        }
+    }
+    return load;
+}
+
+// ==================== ReactorPool ====================
+
+ReactorPool::ReactorPool(const ReactorPoolConfig& config)
+    : config_(config), strategy_(config.strategy) {
+    size_t count = config_.reactorCount;
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        reactors_.emplace_back(new Reactor(i, config_));
+    }
+}
+
+ReactorPool::~ReactorPool() {
+    stop();
+    if (reserveFd_ >= 0) {
+        close(reserveFd_);
+    }
+}
+
+bool ReactorPool::start() {
+    if (running_) {
+        return false;
+    }
+
+    for (size_t i = 0; i < reactors_.size(); i++) {
+        int cpu = -1;
+        if (!config_.cpuAffinity.empty()) {
+            cpu = config_.cpuAffinity[i % config_.cpuAffinity.size()];
+        }
+        reactors_[i]->start(cpu);
+    }
+
+    running_ = true;
+    return true;
+}
+
+void ReactorPool::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // 先停止accept，避免停止过程中还有新连接被分发；重新start后可以再次listen
+    if (acceptor_) {
+        acceptor_->stop();
+        acceptor_.reset();
+    }
+    for (auto& reactor : reactors_) {
+        reactor->stop();
+    }
+}
+
+bool ReactorPool::listen(int listenFd, ConnectionCallback callback) {
+    if (!running_ || acceptor_ || listenFd < 0) {
+        return false;
+    }
+    if (!setNonBlocking(listenFd)) {
+        std::cerr << "ReactorPool: 设置监听socket非阻塞失败" << std::endl;
+        return false;
+    }
+
+    connectionCallback_ = std::move(callback);
+    lastAcceptErrno_ = 0;
+    if (reserveFd_ < 0) {
+        reserveFd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    // accept线程只处理监听socket，使用LT模式即可
+    ReactorPoolConfig acceptorConfig = config_;
+    acceptorConfig.edgeTriggered = false;
+    acceptorConfig.maxEvents = 16;
+    acceptor_.reset(new Reactor(reactors_.size(), acceptorConfig));
+    acceptor_->start(config_.acceptorCpu);
+
+    // 跨线程的addFd只是排队，这里在accept线程上注册并等待实际结果
+    Reactor* acceptor = acceptor_.get();
+    std::promise<bool> added;
+    std::future<bool> addedFuture = added.get_future();
+    acceptor->runInLoop([this, acceptor, listenFd, &added]() {
+        added.set_value(acceptor->addFdInLoop(listenFd, static_cast<uint32_t>(IOEventType::Read),
+                                              [this, listenFd](const IOEvent&) { handleAccept(listenFd); }));
+    });
+    if (!addedFuture.get()) {
+        std::cerr << "ReactorPool: 注册监听socket失败" << std::endl;
+        acceptor_->stop();
+        acceptor_.reset();
+        return false;
+    }
+    return true;
+}
+
+void ReactorPool::handleAccept(int listenFd) {
+    while (running_) {
+        sockaddr_storage peer{};
+        socklen_t len = sizeof(peer);
+        int clientFd = accept(listenFd, reinterpret_cast<sockaddr*>(&peer), &len);
+
+        if (clientFd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EMFILE || errno == ENFILE) && rejectPendingConnection(listenFd)) {
+                continue;
+            }
+            // 同一种错误连续出现时只记录一次
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != lastAcceptErrno_) {
+                std::cerr << "ReactorPool: accept失败: " << strerror(errno) << std::endl;
+                lastAcceptErrno_ = errno;
+            }
+            break;
+        }
+        lastAcceptErrno_ = 0;
+
+        if (!setNonBlocking(clientFd)) {
+            close(clientFd);
+            continue;
+        }
+
+        dispatch(clientFd, peer, connectionCallback_);
+    }
+}
+
+// 描述符耗尽时排队的连接无法接受，监听socket是水平触发的，会让accept线程空转。
+// 释放预留的描述符，接受一个连接并立即关闭，再重新预留；返回false表示没有可以处理的连接
+bool ReactorPool::rejectPendingConnection(int listenFd) {
+    if (reserveFd_ < 0) {
+        reserveFd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (reserveFd_ < 0) {
+            return false;
+        }
+    }
+
+    close(reserveFd_);
+    int clientFd = accept(listenFd, nullptr, nullptr);
+    if (clientFd >= 0) {
+        close(clientFd);
+    }
+    reserveFd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (clientFd >= 0 && lastAcceptErrno_ != EMFILE) {
+        std::cerr << "ReactorPool: 文件描述符耗尽，拒绝新连接" << std::endl;
+        lastAcceptErrno_ = EMFILE;
+    }
+    return clientFd >= 0;
+}
+
+size_t ReactorPool::dispatch(int fd, const sockaddr_storage& peer, ConnectionCallback callback) {
+    size_t index = selectIndex(peer);
+    Reactor* reactor = reactors_[index].get();
+
+    // 注册完成前先计入负载，避免最少连接策略把一批连接都分给同一个Reactor
+    reactor->pendingDispatch_++;
+    reactor->runInLoop([reactor, fd, peer, callback]() {
+        reactor->pendingDispatch_--;
+        reactor->dispatchingFd_ = fd;
+        reactor->dispatchClaimed_ = false;
+        if (callback) {
+            callback(*reactor, fd, peer);
+        }
+        reactor->dispatchingFd_ = -1;
+        // 回调没有注册这个连接，关闭它以免泄漏描述符
+        if (!reactor->dispatchClaimed_) {
+            close(fd);
+        }
+    });
+    return index;
+}
+
+Reactor& ReactorPool::selectReactor(const sockaddr_storage& peer) {
+    return *reactors_[selectIndex(peer)];
+}
+
+void ReactorPool::setDispatchFunction(DispatchFunction func) {
+    std::lock_guard<std::mutex> lock(dispatchMutex_);
+    dispatchFunction_ = std::move(func);
+    strategy_ = DispatchStrategy::Custom;
+}
+
+size_t ReactorPool::selectIndex(const sockaddr_storage& peer) {
+    size_t count = reactors_.size();
+
+    switch (strategy_.load()) {
+        case DispatchStrategy::LeastConnections: {
+            size_t best = 0;
+            size_t bestLoad = reactors_[0]->getConnectionCount();
+            for (size_t i = 1; i < count; i++) {
+                size_t load = reactors_[i]->getConnectionCount();
+                if (load < bestLoad) {
+                    best = i;
+                    bestLoad = load;
+                }
+            }
+            return best;
+        }
+
+        case DispatchStrategy::HashByPeer:
+            return hashPeer(peer) % count;
+
+        case DispatchStrategy::Custom: {
+            DispatchFunction func;
+            {
+                std::lock_guard<std::mutex> lock(dispatchMutex_);
+                func = dispatchFunction_;
+            }
+            if (func) {
+                return func(peer, getLoads()) % count;
+            }
+            return nextReactor_++ % count;
+        }
+
+        case DispatchStrategy::RoundRobin:
+        default:
+            return nextReactor_++ % count;
+    }
+}
+
+size_t ReactorPool::hashPeer(const sockaddr_storage& peer) {
+    // 只对IP做哈希（不含端口），同一客户端的多个连接落在同一个Reactor
+    const unsigned char* bytes = nullptr;
+    size_t len = 0;
+
+    if (peer.ss_family == AF_INET) {
+        const sockaddr_in* addr = reinterpret_cast<const sockaddr_in*>(&peer);
+        bytes = reinterpret_cast<const unsigned char*>(&addr->sin_addr);
+        len = sizeof(addr->sin_addr);
+    } else if (peer.ss_family == AF_INET6) {
+        const sockaddr_in6* addr = reinterpret_cast<const sockaddr_in6*>(&peer);
+        bytes = reinterpret_cast<const unsigned char*>(&addr->sin6_addr);
+        len = sizeof(addr->sin6_addr);
+    }
+
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+std::vector<ReactorLoad> ReactorPool::getLoads() const {
+    std::vector<ReactorLoad> loads;
+    loads.reserve(reactors_.size());
+    for (const auto& reactor : reactors_) {
+        loads.push_back(reactor->getLoad());
+    }
+    return loads;
+}
+
+} // namespace IOMultiplexing
@@ -0,0 +1,365 @@
+#include "../include/tcp_connection.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace IOMultiplexing {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;  // 对端关闭时返回EPIPE而不是触发SIGPIPE
+#else
+const int kSendFlags = 0;
+#endif
+
+const size_t kMaxIovecs = 64;           // 一次sendmsg最多聚合的数据块数
+const size_t kCoalesceLimit = 4096;     // 小于该大小的尾部数据块会被合并，减少iovec数量
+
+const uint32_t kReadEvents = static_cast<uint32_t>(IOEventType::Read);
+const uint32_t kReadWriteEvents =
+    static_cast<uint32_t>(IOEventType::Read) | static_cast<uint32_t>(IOEventType::Write);
+
+bool wouldBlock(int err) {
+    return err == EAGAIN || err == EWOULDBLOCK || err == EINTR;
+}
+
+} // namespace
+
+TcpConnection::Ptr TcpConnection::create(Reactor& reactor, int fd, const sockaddr_storage& peer) {
+    return Ptr(new TcpConnection(reactor, fd, peer));
+}
+
+TcpConnection::TcpConnection(Reactor& reactor, int fd, const sockaddr_storage& peer)
+    : reactor_(reactor), fd_(fd), peer_(peer), state_(State::Connecting),
+      budget_(reactor.getIOBudget()) {}
+
+TcpConnection::~TcpConnection() {
+    if (state_ != State::Disconnected) {
+        close(fd_);
+    }
+}
+
+void TcpConnection::start() {
+    Ptr self = shared_from_this();
+    reactor_.runInLoop([self]() {
+        self->state_ = State::Connected;
+        // 处理函数持有连接的引用，直到handleClose中从Reactor注销
+        bool added = self->reactor_.addFd(self->fd_, kReadEvents, [self](const IOEvent& event) {
+            self->handleEvent(event);
+        });
+        if (!added) {
+            self->handleClose();
+        }
+    });
+}
+
+bool TcpConnection::reservePending(size_t len) {
+    size_t current = pendingBytes_.load();
+    do {
+        if (maxPendingBytes_ > 0 && current + len > maxPendingBytes_) {
+            return false;
+        }
+    } while (!pendingBytes_.compare_exchange_weak(current, current + len));
+    return true;
+}
+
+bool TcpConnection::send(const void* data, size_t len) {
+    if (state_ != State::Connected || !reservePending(len)) {
+        return false;
+    }
+
+    if (reactor_.isInLoopThread()) {
+        sendInLoop(static_cast<const char*>(data), len);
+    } else {
+        Ptr self = shared_from_this();
+        std::shared_ptr<std::string> copy =
+            std::make_shared<std::string>(static_cast<const char*>(data), len);
+        reactor_.queueInLoop([self, copy]() {
+            self->sendInLoop(std::move(*copy));
+        });
+    }
+    return true;
+}
+
+bool TcpConnection::send(std::string&& data) {
+    if (state_ != State::Connected || !reservePending(data.size())) {
+        return false;
+    }
+
+    if (reactor_.isInLoopThread()) {
+        sendInLoop(std::move(data));
+    } else {
+        Ptr self = shared_from_this();
+        std::shared_ptr<std::string> owned = std::make_shared<std::string>(std::move(data));
+        reactor_.queueInLoop([self, owned]() {
+            self->sendInLoop(std::move(*owned));
+        });
+    }
+    return true;
+}
+
+void TcpConnection::sendInLoop(const char* data, size_t len) {
+    if (state_ == State::Disconnected) {
+        pendingBytes_ -= len;
+        return;
+    }
+
+    // 没有排队数据时先直接写，多数情况下一次系统调用即可完成
+    size_t written = 0;
+    if (!writing_ && outputQueue_.empty()) {
+        ssize_t n = ::send(fd_, data, len, kSendFlags);
+        if (n >= 0) {
+            written = static_cast<size_t>(n);
+            stats_.bytesWritten += written;
+            pendingBytes_ -= written;
+            if (written == len) {
+                stats_.directWrites++;
+                if (writeCompleteCallback_) {
+                    // 排队执行避免在send()调用方中重入；loop线程内排队不写唤醒管道
+                    Ptr self = shared_from_this();
+                    reactor_.queueInLoop([self]() { self->writeCompleteCallback_(self); });
+                }
+                return;
+            }
+        } else if (!wouldBlock(errno)) {
+            pendingBytes_ -= len;
+            handleClose();
+            return;
+        }
+    }
+
+    // 剩余部分进入输出队列
+    size_t remaining = len - written;
+    if (!outputQueue_.empty() && outputQueue_.back().size() < kCoalesceLimit) {
+        outputQueue_.back().append(data + written, remaining);
+    } else {
+        outputQueue_.emplace_back(data + written, remaining);
+    }
+    queuedBytes_ += remaining;
+    stats_.queuedWrites++;
+
+    checkHighWaterMark();
+    if (!writing_) {
+        enableWriting();
+    }
+}
+
+void TcpConnection::sendInLoop(std::string&& data) {
+    // 需要排队且无法合并时直接接管字符串，避免再拷贝一次
+    if (state_ != State::Disconnected && (writing_ || !outputQueue_.empty()) &&
+        (outputQueue_.empty() || outputQueue_.back().size() >= kCoalesceLimit)) {
+        queuedBytes_ += data.size();
+        outputQueue_.push_back(std::move(data));
+        stats_.queuedWrites++;
+        checkHighWaterMark();
+        if (!writing_) {
+            enableWriting();
+        }
+        return;
+    }
+    sendInLoop(data.data(), data.size());
+}
+
+void TcpConnection::checkHighWaterMark() {
+    if (!aboveHighWaterMark_ && highWaterMark_ > 0 && pendingBytes_ >= highWaterMark_) {
+        aboveHighWaterMark_ = true;
+        // 同步通知，让正在循环send的生产者能立即停下
+        if (highWaterMarkCallback_) {
+            highWaterMarkCallback_(shared_from_this(), pendingBytes_);
+        }
+    }
+}
+
+void TcpConnection::handleEvent(const IOEvent& event) {
+    Ptr self = shared_from_this();  // 回调中可能关闭连接，保证处理期间对象存活
+
+    const uint32_t readMask = static_cast<uint32_t>(IOEventType::Read);
+    const uint32_t writeMask = static_cast<uint32_t>(IOEventType::Write);
+    const uint32_t errorMask = static_cast<uint32_t>(IOEventType::Error);
+    const uint32_t hangUpMask = static_cast<uint32_t>(IOEventType::HangUp);
+
+    if ((event.events & hangUpMask) && !(event.events & readMask)) {
+        handleClose();
+        return;
+    }
+    if (event.events & errorMask) {
+        handleClose();
+        return;
+    }
+    if (event.events & readMask) {
+        handleRead();
+    }
+    if ((event.events & writeMask) && state_ != State::Disconnected) {
+        handleWrite();
+    }
+}
+
+void TcpConnection::handleRead() {
+    // 读到EAGAIN（LT和ET模式下都适用）或预算用完
+    DrainResult result = readWithBudget(fd_, inputBuffer_, budget_);
+
+    stats_.bytesRead += result.bytes;
+    if (result.bytes > 0 && messageCallback_) {
+        messageCallback_(shared_from_this(), inputBuffer_);
+    }
+
+    if (result.status == DrainStatus::PeerClosed || result.status == DrainStatus::Error) {
+        handleClose();
+    } else if (result.status == DrainStatus::BudgetExhausted && state_ != State::Disconnected) {
+        stats_.budgetYields++;
+        reactor_.markReady(fd_, static_cast<uint32_t>(IOEventType::Read));
+    }
+}
+
+void TcpConnection::handleWrite() {
+    if (!writing_) {
+        return;
+    }
+
+    size_t bytes = 0;
+    size_t iterations = 0;
+    while (!outputQueue_.empty()) {
+        if (budget_.exhausted(bytes, iterations)) {
+            // 预算用完，剩余数据留到下一轮；可写事件仍在关注中，不需要modifyFd
+            stats_.budgetYields++;
+            reactor_.markReady(fd_, static_cast<uint32_t>(IOEventType::Write));
+            break;
+        }
+
+        // 聚合多个数据块，一次sendmsg写出，总量不超过剩余预算
+        iovec iov[kMaxIovecs];
+        size_t iovcnt = 0;
+        size_t batchBytes = 0;
+        const size_t batchLimit = budget_.remainingBytes(bytes);
+        for (auto it = outputQueue_.begin();
+             it != outputQueue_.end() && iovcnt < kMaxIovecs && batchBytes < batchLimit; ++it) {
+            size_t offset = iovcnt == 0 ? outputOffset_ : 0;
+            iov[iovcnt].iov_base = const_cast<char*>(it->data()) + offset;
+            iov[iovcnt].iov_len = std::min(it->size() - offset, batchLimit - batchBytes);
+            batchBytes += iov[iovcnt].iov_len;
+            iovcnt++;
+        }
+
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
+
+        ssize_t n = sendmsg(fd_, &msg, kSendFlags);
+        iterations++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            handleClose();
+            return;
+        }
+
+        // 释放已写出的数据块
+        size_t remaining = static_cast<size_t>(n);
+        bytes += remaining;
+        queuedBytes_ -= remaining;
+        pendingBytes_ -= remaining;
+        stats_.bytesWritten += remaining;
+        while (remaining > 0) {
+            size_t front = outputQueue_.front().size() - outputOffset_;
+            if (remaining >= front) {
+                remaining -= front;
+                outputQueue_.pop_front();
+                outputOffset_ = 0;
+            } else {
+                outputOffset_ += remaining;
+                remaining = 0;
+            }
+        }
+
+        if (static_cast<size_t>(n) < batchBytes) {
+            break;  // socket发送缓冲区已满
+        }
+    }
+
+    Ptr self = shared_from_this();
+    if (aboveHighWaterMark_ && pendingBytes_ <= lowWaterMark_) {
+        aboveHighWaterMark_ = false;
+        if (lowWaterMarkCallback_) {
+            lowWaterMarkCallback_(self);
+        }
+    }
+
+    if (outputQueue_.empty()) {
+        disableWriting();
+        if (writeCompleteCallback_) {
+            writeCompleteCallback_(self);
+        }
+        if (state_ == State::Disconnecting) {
+            ::shutdown(fd_, SHUT_WR);
+        }
+    }
+}
+
+void TcpConnection::enableWriting() {
+    writing_ = true;
+    stats_.writeInterestToggles++;
+    reactor_.modifyFd(fd_, kReadWriteEvents);
+}
+
+void TcpConnection::disableWriting() {
+    writing_ = false;
+    stats_.writeInterestToggles++;
+    reactor_.modifyFd(fd_, kReadEvents);
+}
+
+void TcpConnection::shutdown() {
+    State expected = State::Connected;
+    if (state_.compare_exchange_strong(expected, State::Disconnecting)) {
+        Ptr self = shared_from_this();
+        reactor_.runInLoop([self]() { self->shutdownInLoop(); });
+    }
+}
+
+void TcpConnection::shutdownInLoop() {
+    // 仍有数据待发送时，由handleWrite在写完后关闭写端
+    if (!writing_ && outputQueue_.empty()) {
+        ::shutdown(fd_, SHUT_WR);
+    }
+}
+
+void TcpConnection::forceClose() {
+    State state = state_;
+    if (state == State::Connected || state == State::Disconnecting) {
+        state_ = State::Disconnecting;
+        Ptr self = shared_from_this();
+        reactor_.queueInLoop([self]() { self->handleClose(); });
+    }
+}
+
+void TcpConnection::handleClose() {
+    if (state_ == State::Disconnected) {
+        return;
+    }
+    Ptr self = shared_from_this();
+    state_ = State::Disconnected;
+
+    reactor_.removeFd(fd_);
+    close(fd_);
+
+    // 跨线程排队中的数据会在sendInLoop中自行扣除，这里只扣除已入队部分
+    pendingBytes_ -= queuedBytes_;
+    outputQueue_.clear();
+    outputOffset_ = 0;
+    queuedBytes_ = 0;
+    writing_ = false;
+
+    if (closeCallback_) {
+        closeCallback_(self);
+    }
+}
+
+} // namespace IOMultiplexing
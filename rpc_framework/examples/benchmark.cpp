@@ -9,6 +9,7 @@
 #include <vector>
 #include <future>
 #include <iomanip>
+#include <algorithm>
 
 using namespace rpc;
 
@@ -0,0 +1,215 @@
+#include "../include/rpc_client.h"
+#include "../include/rpc_server.h"
+#include "../../threadpool/examples/test_util.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <memory>
+
+using namespace rpc;
+using namespace test_util;
+
+// 客户端连接池测试：预先连接、自动归还、达到上限时限时等待、并发借用、空闲回收、
+// 健康检查发现断开的连接并在服务器恢复后补齐
+
+namespace {
+
+const int kPort = 8096;
+std::atomic<int> ping_count{0};
+
+ServiceEndpoint endpoint() {
+    return ServiceEndpoint("127.0.0.1", kPort);
+}
+
+void registerMethods(RpcServer& server) {
+    server.registerMethod("echo", [](const std::vector<AnyValue>& params) -> AnyValue {
+        return params[0];
+    });
+    server.registerMethod("ping", [](const std::vector<AnyValue>&) -> AnyValue {
+        ping_count++;
+        return AnyValue(true);
+    });
+}
+
+// 等待条件成立，最多等待timeout
+template<typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+void testWarmUpAndLease() {
+    std::cout << "\n1. 预先连接与自动归还" << std::endl;
+    RpcClientPool pool(endpoint(), 4);
+    pool.setMinPoolSize(2);
+    bool started = pool.start();
+    auto status = pool.getStatus();
+    check(started && status.total_clients == 2 && status.available_clients == 2, "start()预先建立最小数量的连接");
+
+    {
+        auto lease = pool.acquire();
+        RpcResponse response = lease ? lease->call("echo", {AnyValue(7)}) : RpcResponse();
+        check(response.isSuccess() && response.result.cast<int>() == 7, "借出的客户端可以直接调用");
+        check(pool.getStatus().busy_clients == 1, "借出期间计为忙碌");
+    }
+    status = pool.getStatus();
+    check(status.available_clients == 2 && status.busy_clients == 0 && status.created_clients == 2,
+          "Lease析构时自动归还，复用已有连接");
+
+    // 兼容的getClient/releaseClient接口
+    auto client = pool.getClient();
+    bool ok = client && client->call("echo", {AnyValue(1)}).isSuccess();
+    pool.releaseClient(client);
+    check(ok && pool.getStatus().available_clients == 2, "getClient/releaseClient");
+}
+
+void testBoundedWait() {
+    std::cout << "\n2. 达到上限时限时等待" << std::endl;
+    RpcClientPool pool(endpoint(), 2);
+
+    std::vector<RpcClientPool::Lease> leases;
+    leases.push_back(pool.acquire());
+    leases.push_back(pool.acquire());
+    check(leases[0] && leases[1], "借出全部2个客户端");
+
+    auto start = std::chrono::steady_clock::now();
+    auto extra = pool.acquire(std::chrono::milliseconds(100));
+    double waited = elapsedMs(start);
+    auto status = pool.getStatus();
+    std::cout << "   等待 " << waited << " ms" << std::endl;
+    check(!extra && waited >= 90 && status.total_clients == 2 && status.acquire_timeouts == 1,
+          "没有空闲客户端时等待到期返回空，不新建连接");
+
+    // 另一个线程归还后，等待者拿到同一个客户端
+    RpcClient* returned = leases[0].get().get();
+    std::thread releaser([&leases]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        leases[0].release();
+    });
+    start = std::chrono::steady_clock::now();
+    auto waiter = pool.acquire(std::chrono::milliseconds(2000));
+    waited = elapsedMs(start);
+    releaser.join();
+    check(waiter && waiter.get().get() == returned && waited < 1000 && pool.getStatus().created_clients == 2,
+          "等待中的调用者在客户端归还后立即得到它");
+}
+
+void testConcurrentUse() {
+    std::cout << "\n3. 多线程共享小连接池" << std::endl;
+    RpcClientPool pool(endpoint(), 3);
+    pool.setAcquireTimeout(std::chrono::milliseconds(5000));
+
+    const int kThreads = 8;
+    const int kCalls = 200;
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, &succeeded, t]() {
+            for (int i = 0; i < kCalls; ++i) {
+                auto lease = pool.acquire();
+                if (lease && lease->call("echo", {AnyValue(t * kCalls + i)}).result.cast<int>() == t * kCalls + i) {
+                    succeeded++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double ms = elapsedMs(start);
+    auto status = pool.getStatus();
+    std::cout << "   " << succeeded << " 次调用，" << ms << " ms，建立连接 " << status.created_clients << " 个" << std::endl;
+    check(succeeded == kThreads * kCalls && status.created_clients <= 3 && status.busy_clients == 0,
+          "并发调用全部成功，连接数不超过池大小");
+}
+
+void testIdleEviction() {
+    std::cout << "\n4. 空闲连接回收" << std::endl;
+    RpcClientPool pool(endpoint(), 4);
+    pool.setMinPoolSize(1);
+    pool.setIdleTimeout(std::chrono::milliseconds(100));
+    pool.setHealthCheckInterval(std::chrono::milliseconds(50));
+    pool.start();
+
+    {
+        std::vector<RpcClientPool::Lease> leases;
+        for (int i = 0; i < 4; ++i) {
+            leases.push_back(pool.acquire());
+        }
+    }
+    check(pool.getStatus().available_clients == 4, "突发借用后有4个空闲连接");
+    bool shrunk = waitFor([&pool]() { return pool.getStatus().total_clients == 1; }, std::chrono::milliseconds(2000));
+    check(shrunk && pool.getStatus().closed_clients == 3, "空闲超时的连接被关闭，保留最小数量");
+}
+
+void testHealthCheck() {
+    std::cout << "\n5. 健康检查" << std::endl;
+    auto server = std::make_unique<RpcServer>();
+    registerMethods(*server);
+    server->start(ServiceEndpoint("127.0.0.1", kPort + 1));
+
+    RpcClientPool pool(ServiceEndpoint("127.0.0.1", kPort + 1), 4);
+    pool.setMinPoolSize(2);
+    pool.setHealthCheckInterval(std::chrono::milliseconds(50));
+    pool.setHealthCheckMethod("ping");
+    pool.setClientTimeout(std::chrono::milliseconds(500));
+    pool.start();
+
+    int before = ping_count;
+    check(waitFor([before]() { return ping_count >= before + 4; }, std::chrono::milliseconds(2000)),
+          "空闲连接定期用探测方法检查");
+
+    // 服务器停止后，断开的连接被移除
+    server->stop();
+    server.reset();
+    bool removed = waitFor([&pool]() { return pool.getStatus().available_clients == 0; },
+                           std::chrono::milliseconds(3000));
+    check(removed, "服务器停止后断开的连接被移除");
+    check(!pool.acquire(std::chrono::milliseconds(100)), "服务器不可用时借用失败而不是挂起");
+
+    // 服务器恢复后补齐到最小数量
+    server = std::make_unique<RpcServer>();
+    registerMethods(*server);
+    server->start(ServiceEndpoint("127.0.0.1", kPort + 1));
+    bool refilled = waitFor([&pool]() { return pool.getStatus().available_clients == 2; },
+                            std::chrono::milliseconds(3000));
+    check(refilled, "服务器恢复后连接补齐到最小数量");
+    auto lease = pool.acquire();
+    check(lease && lease->call("echo", {AnyValue(3)}).isSuccess(), "恢复后调用成功");
+    lease.release();
+
+    pool.shutdown();
+    server->stop();
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 客户端连接池测试 ===" << std::endl;
+
+    RpcServer server;
+    registerMethods(server);
+    if (!server.start(endpoint())) {
+        std::cerr << "服务器启动失败" << std::endl;
+        return 1;
+    }
+
+    testWarmUpAndLease();
+    testBoundedWait();
+    testConcurrentUse();
+    testIdleEviction();
+    testHealthCheck();
+
+    server.stop();
+
+    return finish();
+}
@@ -0,0 +1,191 @@
+#include "../include/rpc_client.h"
+#include "../include/rpc_server.h"
+#include "../../threadpool/examples/test_util.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+using namespace rpc;
+using namespace test_util;
+
+// 方法分派并发测试：方法ID调用、慢处理器不阻塞其他请求、吞吐量随客户端数的变化
+
+namespace {
+
+const int kPort = 8091;
+
+void testMethodIds(RpcServer& server, uint32_t spin_id) {
+    RpcClient client;
+    client.connect(ServiceEndpoint("127.0.0.1", kPort));
+
+    check(client.resolveMethod("spin") == spin_id, "rpc.resolve返回注册时分配的方法ID");
+    auto response = client.call(spin_id, {AnyValue(0)});
+    check(response.isSuccess() && response.result.cast<int>() == 0, "按方法ID调用");
+
+    uint32_t temp_id = server.registerMethod("temp", [](const std::vector<AnyValue>&) -> AnyValue {
+        return AnyValue(std::string("temp"));
+    });
+    check(server.registerMethod("temp", [](const std::vector<AnyValue>&) -> AnyValue {
+        return AnyValue(std::string("temp2"));
+    }) == temp_id, "重复注册同名方法保留原ID");
+    check(client.call(temp_id).result.cast<std::string>() == "temp2", "重复注册后调用新的处理器");
+
+    server.unregisterMethod("temp");
+    check(client.call(temp_id).error_code == ErrorCode::METHOD_NOT_FOUND &&
+          client.call("temp").error_code == ErrorCode::METHOD_NOT_FOUND, "取消注册后按ID和方法名都找不到");
+    check(client.call(9999u).error_code == ErrorCode::METHOD_NOT_FOUND, "未知方法ID返回METHOD_NOT_FOUND");
+    check(server.registerMethod("temp", [](const std::vector<AnyValue>&) -> AnyValue {
+        return AnyValue();
+    }) != temp_id, "取消注册后ID不复用");
+
+    // 另一个服务器按不同顺序注册，同名方法的ID不同；重新连接后缓存的ID作废
+    RpcServer other;
+    other.registerMethod("other", [](const std::vector<AnyValue>&) -> AnyValue { return AnyValue(); });
+    uint32_t other_spin_id = other.registerMethod("spin", [](const std::vector<AnyValue>&) -> AnyValue {
+        return AnyValue(std::string("other"));
+    });
+    if (other.start(ServiceEndpoint("127.0.0.1", kPort - 1))) {
+        client.connect(ServiceEndpoint("127.0.0.1", kPort - 1));
+        uint32_t resolved = client.resolveMethod("spin");
+        check(resolved == other_spin_id && resolved != spin_id &&
+              client.call(resolved).result.cast<std::string>() == "other",
+              "连接到其他服务器后重新查询方法ID");
+        client.disconnect();
+        other.stop();
+    } else {
+        check(false, "启动第二个服务器");
+    }
+
+    client.disconnect();
+}
+
+// 一个连接上的慢请求执行期间，另一个连接上的请求不应该被阻塞
+void testSlowHandlerIsolation() {
+    std::thread slow([]() {
+        RpcClient client;
+        client.connect(ServiceEndpoint("127.0.0.1", kPort));
+        client.call("stall");
+        client.disconnect();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    RpcClient client;
+    client.connect(ServiceEndpoint("127.0.0.1", kPort));
+    double max_ms = 0.0;
+    for (int i = 0; i < 20; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        client.call("echo", {AnyValue(i)});
+        max_ms = std::max(max_ms, elapsedMs(start));
+    }
+    client.disconnect();
+    slow.join();
+
+    std::cout << "慢处理器（300ms）执行期间，其他连接的最大延迟: " << std::fixed << std::setprecision(2)
+              << max_ms << " ms" << std::endl;
+    check(max_ms < 150.0, "慢处理器不阻塞其他连接上的请求");
+}
+
+// clients个客户端线程在duration内持续按ID调用method_id，返回每秒调用数
+double measure(uint32_t method_id, int clients, std::chrono::milliseconds duration, std::atomic<int>& errors) {
+    std::atomic<bool> stop{false};
+    std::atomic<long> calls{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c]() {
+            RpcClient client;
+            if (!client.connect(ServiceEndpoint("127.0.0.1", kPort))) {
+                ++errors;
+                return;
+            }
+            long local = 0;
+            while (!stop.load()) {
+                auto response = client.call(method_id, {AnyValue(c)});
+                if (!response.isSuccess() || response.result.cast<int>() != c) {
+                    ++errors;
+                }
+                ++local;
+            }
+            calls += local;
+            client.disconnect();
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return calls.load() / elapsedMs(start) * 1000.0;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 方法分派并发测试 ===" << std::endl;
+
+    RpcServer server;
+    uint32_t spin_id = server.registerMethod("spin", [](const std::vector<AnyValue>& params) -> AnyValue {
+        busyWork(50);   // CPU密集的处理器
+        return params[0];
+    });
+    uint32_t wait_id = server.registerMethod("wait", [](const std::vector<AnyValue>& params) -> AnyValue {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));  // 等待下游的处理器
+        return params[0];
+    });
+    server.registerMethod("echo", [](const std::vector<AnyValue>& params) -> AnyValue {
+        return params.empty() ? AnyValue() : params[0];
+    });
+    server.registerMethod("stall", [](const std::vector<AnyValue>&) -> AnyValue {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return AnyValue();
+    });
+
+    if (!server.start(ServiceEndpoint("127.0.0.1", kPort))) {
+        std::cerr << "服务器启动失败" << std::endl;
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    testMethodIds(server, spin_id);
+    testSlowHandlerIsolation();
+
+    // 测量期间不断注册/取消注册其他方法，分派快照被反复替换
+    std::atomic<bool> churning{true};
+    std::thread churn([&]() {
+        while (churning.load()) {
+            server.registerMethod("churn", [](const std::vector<AnyValue>&) -> AnyValue { return AnyValue(); });
+            server.unregisterMethod("churn");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::atomic<int> errors{0};
+    std::cout << "\nCPU核心数: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "客户端数    spin(50us CPU) 调用/秒    wait(1ms) 调用/秒" << std::endl;
+    const int client_counts[] = {1, 2, 4, 8};
+    double wait_single = 0.0, wait_max = 0.0;
+    for (int clients : client_counts) {
+        double spin_rate = measure(spin_id, clients, std::chrono::milliseconds(300), errors);
+        double wait_rate = measure(wait_id, clients, std::chrono::milliseconds(300), errors);
+        if (clients == 1) {
+            wait_single = wait_rate;
+        }
+        wait_max = std::max(wait_max, wait_rate);
+        std::cout << std::setw(8) << clients << std::fixed << std::setprecision(0)
+                  << std::setw(22) << spin_rate << std::setw(21) << wait_rate << std::endl;
+    }
+    churning = false;
+    churn.join();
+
+    check(errors.load() == 0, "方法表被反复替换期间所有调用都成功");
+    // 处理器并发执行时，等待型处理器的吞吐量随客户端数增加；串行执行时不变
+    check(wait_max > wait_single * 3, "处理器在多个连接上并发执行");
+
+    server.stop();
+
+    return finish();
+}
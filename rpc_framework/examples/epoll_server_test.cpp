@@ -0,0 +1,260 @@
+#include "../include/rpc_server.h"
+#include "../include/serializer.h"
+#include "../../threadpool/examples/test_util.h"
+#include "proc_status.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <set>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/resource.h>
+
+using namespace rpc;
+using namespace test_util;
+
+// epoll服务器传输层测试：用原始socket验证分帧、流水线、大量连接和队列满时的处理
+
+namespace {
+
+const int kPort = 8092;
+JsonSerializer serializer;
+
+int connectTo(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::string frameRequest(const std::string& id, const std::string& method, int value) {
+    RpcRequest request(method);
+    request.id = id;
+    request.params.push_back(AnyValue(value));
+    std::string body = serializer.serialize(request);
+    uint32_t length = htonl(static_cast<uint32_t>(body.size()));
+    return std::string(reinterpret_cast<const char*>(&length), sizeof(length)) + body;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+bool readResponse(int fd, RpcResponse& response) {
+    uint32_t length;
+    if (recv(fd, &length, sizeof(length), MSG_WAITALL) != sizeof(length)) {
+        return false;
+    }
+    length = ntohl(length);
+    std::string body(length, '\0');
+    if (recv(fd, &body[0], length, MSG_WAITALL) != static_cast<ssize_t>(length)) {
+        return false;
+    }
+    return serializer.deserialize(body, response);
+}
+
+void testFraming() {
+    int fd = connectTo(kPort);
+
+    // 一个字节一个字节地发送，服务器要能拼出完整帧
+    std::string frame = frameRequest("slow-1", "echo", 7);
+    bool sent = true;
+    for (char c : frame) {
+        sent = sent && send(fd, &c, 1, MSG_NOSIGNAL) == 1;
+    }
+    RpcResponse response;
+    check(sent && readResponse(fd, response) && response.id == "slow-1" && response.result.cast<int>() == 7,
+          "逐字节发送的请求被正确分帧");
+
+    // 三个请求一次写入，响应可能乱序，按ID匹配
+    std::string batch = frameRequest("p-1", "echo", 1) + frameRequest("p-2", "echo", 2) + frameRequest("p-3", "echo", 3);
+    sendAll(fd, batch);
+    std::set<std::string> ids;
+    for (int i = 0; i < 3 && readResponse(fd, response); ++i) {
+        if (response.result.cast<int>() == std::stoi(response.id.substr(2))) {
+            ids.insert(response.id);
+        }
+    }
+    check(ids.size() == 3, "同一连接上流水线发送的请求全部得到响应");
+    close(fd);
+}
+
+void testManyConnections() {
+    const int kConnections = 2000;
+    int threads_before = processThreadCount();
+
+    std::vector<int> fds;
+    for (int i = 0; i < kConnections; ++i) {
+        int fd = connectTo(kPort);
+        if (fd < 0) {
+            break;
+        }
+        fds.push_back(fd);
+    }
+    for (size_t i = 0; i < fds.size(); ++i) {
+        sendAll(fds[i], frameRequest("c-" + std::to_string(i), "echo", static_cast<int>(i)));
+    }
+    int ok = 0;
+    for (size_t i = 0; i < fds.size(); ++i) {
+        RpcResponse response;
+        if (readResponse(fds[i], response) && response.result.cast<int>() == static_cast<int>(i)) {
+            ++ok;
+        }
+    }
+    int threads_during = processThreadCount();
+    for (int fd : fds) {
+        close(fd);
+    }
+
+    std::cout << kConnections << " 个连接，服务器线程数: " << threads_before << " -> " << threads_during << std::endl;
+    check(ok == kConnections, "所有连接上的请求都得到正确响应");
+    check(threads_during == threads_before, "连接数增加不会创建新线程");
+}
+
+void testQueueFull() {
+    RpcServer server;
+    server.setThreadPoolSize(1);
+    server.setRequestQueueSize(2);
+    server.registerMethod("block", [](const std::vector<AnyValue>& params) -> AnyValue {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return params[0];
+    });
+    server.start(ServiceEndpoint("127.0.0.1", kPort + 1));
+
+    int fd = connectTo(kPort + 1);
+    std::string batch;
+    for (int i = 0; i < 10; ++i) {
+        batch += frameRequest("q-" + std::to_string(i), "block", i);
+    }
+    sendAll(fd, batch);
+
+    int done = 0, busy = 0;
+    std::set<std::string> ids;
+    RpcResponse response;
+    for (int i = 0; i < 10 && readResponse(fd, response); ++i) {
+        ids.insert(response.id);
+        if (response.isSuccess()) {
+            ++done;
+        } else if (response.error_message.find("busy") != std::string::npos) {
+            ++busy;
+        }
+    }
+    close(fd);
+    server.stop();
+
+    std::cout << "队列长度2、1个工作线程：完成 " << done << "，拒绝 " << busy << std::endl;
+    check(ids.size() == 10 && done + busy == 10 && busy > 0, "请求队列满时立即返回带请求ID的错误");
+}
+
+int openFdCount() {
+    int count = 0;
+    if (DIR* dir = opendir("/proc/self/fd")) {
+        while (readdir(dir)) {
+            ++count;
+        }
+        closedir(dir);
+    }
+    return count - 3;  // "."、".."和opendir自身
+}
+
+double cpuMs() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+// 进程描述符耗尽时，排队的连接被接受后立即关闭，I/O线程不会空转；描述符释放后恢复正常
+void testDescriptorExhaustion() {
+    rlimit original;
+    getrlimit(RLIMIT_NOFILE, &original);
+    rlimit limited = original;
+    limited.rlim_cur = openFdCount() + 16;
+    setrlimit(RLIMIT_NOFILE, &limited);
+
+    // 客户端和服务器端各占一个描述符，直到客户端自己也无法创建socket
+    std::vector<int> fds;
+    for (int i = 0; i < 64; ++i) {
+        int fd = connectTo(kPort);
+        if (fd < 0) {
+            break;
+        }
+        fds.push_back(fd);
+    }
+
+    double cpu_before = cpuMs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double cpu_used = cpuMs() - cpu_before;
+
+    // 最后一个连接在服务器端描述符耗尽时到达，应被关闭
+    bool last_closed = false;
+    if (!fds.empty()) {
+        struct timeval timeout = {1, 0};
+        setsockopt(fds.back(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        char byte;
+        last_closed = recv(fds.back(), &byte, 1, 0) == 0;
+    }
+    for (int fd : fds) {
+        close(fd);
+    }
+    setrlimit(RLIMIT_NOFILE, &original);
+
+    std::cout << "描述符上限内建立 " << fds.size() << " 个连接，300ms内CPU时间 " << cpu_used << " ms" << std::endl;
+    check(last_closed && cpu_used < 100, "描述符耗尽时关闭排队的连接，I/O线程不空转");
+
+    int fd = connectTo(kPort);
+    RpcResponse response;
+    bool ok = fd >= 0 && sendAll(fd, frameRequest("after", "echo", 5)) && readResponse(fd, response) &&
+              response.result.cast<int>() == 5;
+    if (fd >= 0) {
+        close(fd);
+    }
+    check(ok, "描述符释放后正常接受新连接");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== epoll服务器传输层测试 ===" << std::endl;
+
+    RpcServer server;
+    server.registerMethod("echo", [](const std::vector<AnyValue>& params) -> AnyValue {
+        return params[0];
+    });
+    if (!server.start(ServiceEndpoint("127.0.0.1", kPort))) {
+        std::cerr << "服务器启动失败" << std::endl;
+        return 1;
+    }
+
+    testFraming();
+    testManyConnections();
+    testQueueFull();
+    testDescriptorExhaustion();
+
+    server.stop();
+
+    return finish();
+}
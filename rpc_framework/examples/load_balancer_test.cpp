@@ -0,0 +1,257 @@
+#include "../include/rpc_client.h"
+#include "../include/rpc_server.h"
+#include "../../threadpool/examples/test_util.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <future>
+#include <algorithm>
+
+using namespace rpc;
+using namespace test_util;
+
+// 负载均衡客户端测试：各策略的分配、快慢不均的后端上各策略的延迟对比、
+// 连续失败的端点被摘除后逐步恢复流量、移除端点、异步调用
+
+namespace {
+
+const int kBasePort = 8098;
+const int kServers = 4;     // 0、1为快节点，2为慢节点，3只在摘除测试中启动
+std::atomic<int> hits[kServers];
+
+ServiceEndpoint endpoint(int id) {
+    return ServiceEndpoint("127.0.0.1", kBasePort + id);
+}
+
+void resetHits() {
+    for (auto& count : hits) {
+        count = 0;
+    }
+}
+
+// "whoami"立即返回节点编号；"work"模拟业务处理，慢节点耗时是快节点的10倍
+std::unique_ptr<RpcServer> startServer(int id, int work_ms) {
+    auto server = std::make_unique<RpcServer>();
+    server->setThreadPoolSize(16);
+    server->registerMethod("whoami", [id](const std::vector<AnyValue>&) -> AnyValue {
+        hits[id]++;
+        return AnyValue(id);
+    });
+    server->registerMethod("work", [id, work_ms](const std::vector<AnyValue>&) -> AnyValue {
+        hits[id]++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(work_ms));
+        return AnyValue(id);
+    });
+    if (!server->start(endpoint(id))) {
+        return nullptr;
+    }
+    return server;
+}
+
+int callMany(LoadBalancedRpcClient& client, const char* method, int count) {
+    int succeeded = 0;
+    for (int i = 0; i < count; ++i) {
+        if (client.call(method).isSuccess()) {
+            ++succeeded;
+        }
+    }
+    return succeeded;
+}
+
+void testBasicStrategies() {
+    std::cout << "\n1. 基本策略" << std::endl;
+
+    LoadBalancedRpcClient round_robin(LoadBalancedRpcClient::LoadBalanceStrategy::ROUND_ROBIN);
+    for (int id = 0; id < 3; ++id) {
+        round_robin.addEndpoint(endpoint(id));
+    }
+    resetHits();
+    int succeeded = callMany(round_robin, "whoami", 30);
+    check(succeeded == 30 && hits[0] == 10 && hits[1] == 10 && hits[2] == 10, "轮询: 30次调用平均分到3个端点");
+
+    LoadBalancedRpcClient weighted(LoadBalancedRpcClient::LoadBalanceStrategy::WEIGHTED_ROUND_ROBIN);
+    for (int id = 0; id < 3; ++id) {
+        weighted.addEndpoint(endpoint(id), id + 1);
+    }
+    resetHits();
+    succeeded = callMany(weighted, "whoami", 60);
+    check(succeeded == 60 && hits[0] == 10 && hits[1] == 20 && hits[2] == 30, "加权轮询: 权重1:2:3按比例分配");
+
+    LoadBalancedRpcClient random(LoadBalancedRpcClient::LoadBalanceStrategy::RANDOM);
+    for (int id = 0; id < 3; ++id) {
+        random.addEndpoint(endpoint(id));
+    }
+    resetHits();
+    succeeded = callMany(random, "whoami", 300);
+    check(succeeded == 300 && hits[0] > 50 && hits[1] > 50 && hits[2] > 50, "随机: 每个端点都分到调用");
+
+    // 移除端点后不再分配
+    round_robin.removeEndpoint(endpoint(2));
+    resetHits();
+    succeeded = callMany(round_robin, "whoami", 20);
+    check(succeeded == 20 && hits[2] == 0 && hits[0] == 10, "移除端点后调用只分到剩余端点");
+}
+
+struct LoadResult {
+    double slow_share;
+    double avg_ms;
+    double p99_ms;
+};
+
+// 8个线程并发调用"work"，统计慢节点分到的比例和调用延迟
+LoadResult runLoad(LoadBalancedRpcClient::LoadBalanceStrategy strategy) {
+    LoadBalancedRpcClient client(strategy);
+    for (int id = 0; id < 3; ++id) {
+        client.addEndpoint(endpoint(id));
+    }
+
+    const int kThreads = 8;
+    const int kCalls = 50;
+    std::vector<std::vector<double>> latencies(kThreads);
+    std::vector<std::thread> threads;
+    resetHits();
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&client, &latencies, t]() {
+            for (int i = 0; i < kCalls; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                client.call("work");
+                latencies[t].push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    double total = 0;
+    for (double ms : all) {
+        total += ms;
+    }
+    LoadResult result;
+    result.slow_share = static_cast<double>(hits[2]) / (hits[0] + hits[1] + hits[2]);
+    result.avg_ms = total / all.size();
+    result.p99_ms = all[all.size() * 99 / 100];
+    return result;
+}
+
+void testUnevenBackends() {
+    std::cout << "\n2. 快慢不均的后端（快节点1ms，慢节点10ms，8线程并发）" << std::endl;
+    const std::pair<const char*, LoadBalancedRpcClient::LoadBalanceStrategy> strategies[] = {
+        {"轮询", LoadBalancedRpcClient::LoadBalanceStrategy::ROUND_ROBIN},
+        {"最少连接", LoadBalancedRpcClient::LoadBalanceStrategy::LEAST_CONNECTIONS},
+        {"P2C+EWMA", LoadBalancedRpcClient::LoadBalanceStrategy::POWER_OF_TWO_CHOICES},
+    };
+
+    std::vector<LoadResult> results;
+    std::cout << "策略        慢节点占比   平均(ms)    p99(ms)" << std::endl;
+    for (const auto& strategy : strategies) {
+        LoadResult result = runLoad(strategy.second);
+        results.push_back(result);
+        std::cout << std::left << std::setw(12) << strategy.first << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(9) << result.slow_share * 100 << "%"
+                  << std::setprecision(2) << std::setw(11) << result.avg_ms
+                  << std::setw(11) << result.p99_ms << std::endl;
+    }
+    check(results[2].slow_share < 0.15 && results[2].avg_ms < results[0].avg_ms,
+          "P2C+EWMA把流量从慢节点移开，平均延迟低于轮询");
+}
+
+void testEjectionAndRampUp() {
+    std::cout << "\n3. 故障摘除与逐步恢复" << std::endl;
+    LoadBalancedRpcClient client(LoadBalancedRpcClient::LoadBalanceStrategy::ROUND_ROBIN);
+    client.addEndpoint(endpoint(0));
+    client.addEndpoint(endpoint(1));
+    client.addEndpoint(endpoint(3));    // 尚未启动
+    client.setFailureThreshold(3);
+    client.setEjectionTime(std::chrono::milliseconds(300));
+    client.setRampUpTime(std::chrono::milliseconds(1000));
+
+    int succeeded = callMany(client, "whoami", 30);
+    auto status = client.getEndpointStatus();
+    check(succeeded == 27 && status[2].failed_requests == 3 && status[2].ejected && status[2].ejections == 1,
+          "连续失败3次后摘除，之后的调用不再分到该端点");
+
+    auto server = startServer(3, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+
+    // 恢复期开始时只接受少量流量
+    resetHits();
+    succeeded = callMany(client, "whoami", 300);
+    int early = hits[3];
+    status = client.getEndpointStatus();
+    std::cout << "   恢复期初: 300次中分到 " << early << " 次，当前比例 " << std::setprecision(2)
+              << status[2].traffic_share << std::endl;
+    check(succeeded == 300 && early > 0 && early < 60 && !status[2].ejected, "摘除结束后按比例逐步接入流量");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    resetHits();
+    succeeded = callMany(client, "whoami", 300);
+    std::cout << "   恢复期后: 300次中分到 " << hits[3] << " 次" << std::endl;
+    check(succeeded == 300 && hits[3] >= 90, "恢复期结束后恢复完整流量");
+
+    server->stop();
+}
+
+void testAsync() {
+    std::cout << "\n4. 异步调用" << std::endl;
+    LoadBalancedRpcClient client(LoadBalancedRpcClient::LoadBalanceStrategy::POWER_OF_TWO_CHOICES);
+    for (int id = 0; id < 3; ++id) {
+        client.addEndpoint(endpoint(id));
+    }
+
+    resetHits();
+    std::vector<std::future<RpcResponse>> futures;
+    for (int i = 0; i < 200; ++i) {
+        futures.push_back(client.callAsync("whoami"));
+    }
+    int succeeded = 0;
+    for (auto& future : futures) {
+        if (future.get().isSuccess()) {
+            ++succeeded;
+        }
+    }
+    int in_flight = 0;
+    for (const auto& status : client.getEndpointStatus()) {
+        in_flight += status.active_requests;
+    }
+    check(succeeded == 200 && hits[0] + hits[1] + hits[2] == 200 && in_flight == 0,
+          "200个异步调用全部完成，在途计数归零");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 负载均衡客户端测试 ===" << std::endl;
+
+    std::vector<std::unique_ptr<RpcServer>> servers;
+    servers.push_back(startServer(0, 1));
+    servers.push_back(startServer(1, 1));
+    servers.push_back(startServer(2, 10));
+    for (const auto& server : servers) {
+        if (!server) {
+            std::cerr << "服务器启动失败" << std::endl;
+            return 1;
+        }
+    }
+
+    testBasicStrategies();
+    testUnevenBackends();
+    testEjectionAndRampUp();
+    testAsync();
+
+    for (auto& server : servers) {
+        server->stop();
+    }
+
+    return finish();
+}
@@ -0,0 +1,239 @@
+#include "../include/rpc_client.h"
+#include "../include/rpc_server.h"
+#include "../../threadpool/examples/test_util.h"
+#include "proc_status.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <future>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace rpc;
+using namespace test_util;
+
+// 连接多路复用测试：多线程共享一个连接、乱序完成、按请求超时、断开时失败所有未完成请求、
+// 异步调用不创建线程、回调交给执行器
+
+namespace {
+
+const int kPort = 8093;
+
+// 单线程执行器，代替线程池执行回调
+class SerialExecutor {
+public:
+    SerialExecutor() : worker_([this]() { run(); }) {}
+    ~SerialExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_one();
+        worker_.join();
+    }
+    bool submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        condition_.notify_one();
+        return true;
+    }
+    std::thread::id threadId() const { return worker_.get_id(); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+// 慢请求先发、快请求后发，快请求应先完成
+void testOutOfOrder(RpcClient& client) {
+    auto start = std::chrono::steady_clock::now();
+    auto slow = client.callAsync("sleep", {AnyValue(200)});
+    auto fast = client.call("echo", {AnyValue(1)});
+    double fast_ms = elapsedMs(start);
+    auto slow_response = slow.get();
+
+    std::cout << "200ms慢请求在前，同一连接上快请求耗时: " << std::fixed << std::setprecision(2)
+              << fast_ms << " ms" << std::endl;
+    check(fast.isSuccess() && fast.result.cast<int>() == 1 && fast_ms < 100.0, "快请求不排在慢请求之后");
+    check(slow_response.isSuccess() && slow_response.result.cast<int>() == 200, "慢请求随后正常完成");
+}
+
+void testThroughput(RpcClient& client) {
+    const int kThreads = 8;
+    const int kCallsPerThread = 2000;
+    std::atomic<int> errors{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            // 每个线程同时保持最多64个未完成请求
+            std::vector<std::future<RpcResponse>> window;
+            for (int i = 0; i < kCallsPerThread; ++i) {
+                window.push_back(client.callAsync("echo", {AnyValue(t * kCallsPerThread + i)}));
+                if (window.size() == 64 || i == kCallsPerThread - 1) {
+                    for (size_t j = 0; j < window.size(); ++j) {
+                        auto response = window[j].get();
+                        int expected = t * kCallsPerThread + i - static_cast<int>(window.size() - 1 - j);
+                        if (!response.isSuccess() || response.result.cast<int>() != expected) {
+                            ++errors;
+                        }
+                    }
+                    window.clear();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double ms = elapsedMs(start);
+    int total = kThreads * kCallsPerThread;
+
+    std::cout << kThreads << " 个线程共享一个连接完成 " << total << " 次调用，耗时 " << std::fixed
+              << std::setprecision(0) << ms << " ms，" << total / ms * 1000.0 << " 调用/秒" << std::endl;
+    check(errors.load() == 0, "并发调用的响应全部按ID匹配到各自的请求");
+}
+
+void testPerRequestTimeout(RpcClient& client) {
+    client.setTimeout(std::chrono::milliseconds(100));
+    auto start = std::chrono::steady_clock::now();
+    auto slow = client.callAsync("sleep", {AnyValue(500)});
+    auto response = slow.get();
+    double ms = elapsedMs(start);
+    client.setTimeout(std::chrono::milliseconds(5000));
+
+    std::cout << "超时100ms的请求在 " << std::fixed << std::setprecision(0) << ms << " ms 后返回" << std::endl;
+    check(response.error_code == ErrorCode::TIMEOUT && ms < 300.0, "超时的请求由定时器单独完成");
+
+    // 迟到的响应被丢弃，连接继续可用
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    auto echo = client.call("echo", {AnyValue(42)});
+    check(client.isConnected() && echo.isSuccess() && echo.result.cast<int>() == 42, "超时后连接仍然可用");
+}
+
+void testDisconnectFailsPending() {
+    RpcClient client;
+    client.connect(ServiceEndpoint("127.0.0.1", kPort));
+    std::atomic<int> network_errors{0};
+    std::promise<void> done;
+    client.callAsync("sleep", {AnyValue(300)}, [&](const RpcResponse& response) {
+        if (response.error_code == ErrorCode::NETWORK_ERROR) {
+            ++network_errors;
+        }
+        done.set_value();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    client.disconnect();
+    done.get_future().wait();
+    check(network_errors.load() == 1, "断开连接时未完成的请求以NETWORK_ERROR结束");
+}
+
+// 突发的异步调用只入队，不创建线程；回调在执行器线程上执行，可以在回调里发起同步调用
+void testCallbackExecutor() {
+    SerialExecutor executor;
+    RpcClient client;
+    client.setCallbackExecutor([&executor](std::function<void()> task) { return executor.submit(std::move(task)); });
+    client.connect(ServiceEndpoint("127.0.0.1", kPort));
+
+    const int kCalls = 5000;
+    std::atomic<int> done{0}, errors{0}, off_executor{0};
+    int max_threads = processThreadCount();
+    int threads_before = max_threads;
+    for (int i = 0; i < kCalls; ++i) {
+        client.callAsync("echo", {AnyValue(i)}, [&, i](const RpcResponse& response) {
+            if (std::this_thread::get_id() != executor.threadId()) {
+                ++off_executor;
+            }
+            if (!response.isSuccess() || response.result.cast<int>() != i) {
+                ++errors;
+            }
+            ++done;
+        });
+        if (i % 500 == 0) {
+            max_threads = std::max(max_threads, processThreadCount());
+        }
+    }
+    std::promise<RpcResponse> nested;
+    client.callAsync("echo", {AnyValue(0)}, [&](const RpcResponse&) {
+        nested.set_value(client.call("echo", {AnyValue(7)}));
+    });
+    auto nested_response = nested.get_future().get();
+    while (done.load() < kCalls) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << kCalls << " 次异步调用期间进程线程数: " << threads_before << " -> " << max_threads << std::endl;
+    check(max_threads == threads_before, "异步调用不创建线程");
+    check(errors.load() == 0 && off_executor.load() == 0, "回调全部在执行器线程上执行且结果正确");
+    check(nested_response.isSuccess() && nested_response.result.cast<int>() == 7, "执行器上的回调可以发起同步调用");
+    client.disconnect();
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 连接多路复用测试 ===" << std::endl;
+
+    RpcServer server;
+    server.setRequestQueueSize(10000);  // 突发的异步调用一次到达，不触发"Server busy"
+    server.registerMethod("echo", [](const std::vector<AnyValue>& params) -> AnyValue {
+        return params[0];
+    });
+    server.registerMethod("sleep", [](const std::vector<AnyValue>& params) -> AnyValue {
+        std::this_thread::sleep_for(std::chrono::milliseconds(params[0].cast<int>()));
+        return params[0];
+    });
+    if (!server.start(ServiceEndpoint("127.0.0.1", kPort))) {
+        std::cerr << "服务器启动失败" << std::endl;
+        return 1;
+    }
+
+    RpcClient client;
+    if (!client.connect(ServiceEndpoint("127.0.0.1", kPort))) {
+        std::cerr << "连接失败" << std::endl;
+        return 1;
+    }
+
+    testOutOfOrder(client);
+    testThroughput(client);
+    testPerRequestTimeout(client);
+    testDisconnectFailsPending();
+    testCallbackExecutor();
+
+    const auto& stats = client.getStatistics();
+    std::cout << "客户端统计: 总数 " << stats.total_requests << "，成功 " << stats.successful_requests
+              << "，超时 " << stats.timeout_requests << "，失败 " << stats.failed_requests << std::endl;
+    client.disconnect();
+    server.stop();
+
+    return finish();
+}
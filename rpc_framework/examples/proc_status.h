@@ -0,0 +1,22 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+// 读取/proc/self/status的测试辅助函数，配合threadpool/examples/test_util.h使用
+
+namespace test_util {
+
+// 当前进程的线程数（读取/proc/self/status），读取失败返回-1
+inline int processThreadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return -1;
+}
+
+} // namespace test_util
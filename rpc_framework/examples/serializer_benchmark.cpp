@@ -0,0 +1,432 @@
+#include "../include/serializer.h"
+#include "../include/rpc_client.h"
+#include "../include/rpc_server.h"
+#include "../../threadpool/examples/test_util.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace rpc;
+using namespace test_util;
+
+// 序列化器测试与性能对比：二进制和MessagePack格式的往返正确性、损坏输入的处理、
+// MessagePack规范编码、JSON解析器，以及各格式的编解码耗时对比
+
+namespace {
+
+const int kPort = 8094;
+volatile size_t g_sink = 0;  // 防止被测的编解码被优化掉
+
+// 一个典型的业务请求：几个标量参数、一段较长的文本和若干请求头
+RpcRequest sampleRequest() {
+    RpcRequest request("user.updateProfile");
+    request.id = "1048576";
+    request.params.push_back(AnyValue(123456));
+    request.params.push_back(AnyValue(std::string("张三 <zhangsan@example.com>")));
+    request.params.push_back(AnyValue(98.625));
+    request.params.push_back(AnyValue(true));
+    request.params.push_back(AnyValue(std::string(200, 'x') + "\"quoted\"\n\ttabbed\\"));
+    request.headers["trace-id"] = "5f0c3a1e9b7d4c21";
+    request.headers["client"] = "mobile/3.2.1";
+    request.call_type = CallType::ASYNC;
+    request.timeout = std::chrono::milliseconds(1500);
+    return request;
+}
+
+RpcResponse sampleResponse() {
+    RpcResponse response;
+    response.id = "1048576";
+    response.result = AnyValue(std::string("{\"updated\":true,\"version\":42}"));
+    response.headers["server"] = "node-7";
+    return response;
+}
+
+bool sameValue(const AnyValue& a, const AnyValue& b) {
+    if (a.has_value() != b.has_value()) {
+        return false;
+    }
+    if (!a.has_value()) {
+        return true;
+    }
+    if (a.is<int>()) {
+        return b.is<int>() && a.cast<int>() == b.cast<int>();
+    }
+    if (a.is<double>()) {
+        return b.is<double>() && a.cast<double>() == b.cast<double>();
+    }
+    if (a.is<bool>()) {
+        return b.is<bool>() && a.cast<bool>() == b.cast<bool>();
+    }
+    return b.is<std::string>() && a.cast<std::string>() == b.cast<std::string>();
+}
+
+template<typename SerializerType>
+void testRoundTrip(const std::string& name) {
+    SerializerType serializer;
+
+    RpcRequest request = sampleRequest();
+    request.method_id = 70000;
+    request.params.push_back(AnyValue(INT_MIN));
+    request.params.push_back(AnyValue(INT_MAX));
+    request.params.push_back(AnyValue(-1e300));
+    request.params.push_back(AnyValue(std::string()));
+    request.params.push_back(AnyValue(std::string("a\0b", 3)));
+    request.params.push_back(AnyValue());
+
+    RpcRequest decoded;
+    bool ok = serializer.deserialize(serializer.serialize(request), decoded);
+    bool same = ok && decoded.id == request.id && decoded.method == request.method &&
+                decoded.method_id == request.method_id && decoded.call_type == request.call_type &&
+                decoded.timeout == request.timeout && decoded.headers == request.headers &&
+                decoded.params.size() == request.params.size();
+    for (size_t i = 0; same && i < request.params.size(); ++i) {
+        same = sameValue(request.params[i], decoded.params[i]);
+    }
+    check(same, name + ": 请求往返后所有字段和各类参数（含边界整数、空串、内嵌\\0）一致");
+
+    RpcResponse response = sampleResponse();
+    RpcResponse error;
+    error.id = "7";
+    error.error_code = ErrorCode::METHOD_NOT_FOUND;
+    error.error_message = "Method not found: x";
+    RpcResponse decoded_response, decoded_error;
+    check(serializer.deserialize(serializer.serialize(response), decoded_response) &&
+          decoded_response.id == response.id && sameValue(decoded_response.result, response.result) &&
+          decoded_response.headers == response.headers && decoded_response.isSuccess(),
+          name + ": 成功响应往返一致");
+    check(serializer.deserialize(serializer.serialize(error), decoded_error) &&
+          decoded_error.error_code == ErrorCode::METHOD_NOT_FOUND && !decoded_error.result.has_value() &&
+          decoded_error.error_message == error.error_message,
+          name + ": 错误响应往返一致");
+
+    // serializeTo追加到复用的缓冲区
+    std::string buffer = "prefix";
+    serializer.serializeTo(request, buffer);
+    check(buffer.compare(6, std::string::npos, serializer.serialize(request)) == 0,
+          name + ": serializeTo追加到调用者的缓冲区");
+
+    bool all_rejected = true;
+    std::string data = serializer.serialize(request);
+    for (size_t length = 0; length < data.size(); ++length) {
+        all_rejected = all_rejected && !serializer.deserialize(data.substr(0, length), decoded);
+    }
+    check(all_rejected, name + ": 任意位置截断的消息都被拒绝");
+}
+
+void testMalformedInput() {
+    BinarySerializer serializer;
+    std::string data = serializer.serialize(sampleRequest());
+    RpcRequest request;
+
+    std::string bad_magic = data;
+    bad_magic[0] = '{';
+    std::string newer = data;
+    newer[1] = static_cast<char>(BinarySerializer::kVersion + 1);
+    RpcResponse response;
+    check(!serializer.deserialize(bad_magic, request) && !serializer.deserialize(newer, request) &&
+          !serializer.deserialize(data, response),
+          "魔数错误、版本更新或消息类型不符时拒绝");
+
+    // 参数个数声明得很大但数据不足：不应尝试分配
+    std::string huge = data.substr(0, 3);
+    huge += std::string(1, '\0');                     // id
+    huge += std::string(1, '\0');                     // method
+    huge += std::string(1, '\0');                     // method_id
+    huge += std::string(1, '\0');                     // call_type
+    huge += std::string(1, '\0');                     // timeout
+    huge += std::string("\xff\xff\xff\xff\x0f", 5);   // 参数个数约40亿
+    check(!serializer.deserialize(huge, request), "声明的元素个数超过剩余数据时拒绝");
+}
+
+std::string hex(const std::string& bytes) {
+    static const char* digits = "0123456789abcdef";
+    std::string text;
+    for (unsigned char c : bytes) {
+        text += digits[c >> 4];
+        text += digits[c & 15];
+    }
+    return text;
+}
+
+// 按规范检查各种宽度的编码，并解码一条由其他msgpack实现生成的消息
+void testMessagePackSpec() {
+    struct Case {
+        std::function<void(MsgPackWriter&)> pack;
+        const char* expected;
+    };
+    const Case cases[] = {
+        {[](MsgPackWriter& w) { w.packInt(0); }, "00"},
+        {[](MsgPackWriter& w) { w.packInt(127); }, "7f"},
+        {[](MsgPackWriter& w) { w.packInt(128); }, "cc80"},
+        {[](MsgPackWriter& w) { w.packInt(256); }, "cd0100"},
+        {[](MsgPackWriter& w) { w.packInt(65536); }, "ce00010000"},
+        {[](MsgPackWriter& w) { w.packInt(4294967296LL); }, "cf0000000100000000"},
+        {[](MsgPackWriter& w) { w.packInt(-1); }, "ff"},
+        {[](MsgPackWriter& w) { w.packInt(-32); }, "e0"},
+        {[](MsgPackWriter& w) { w.packInt(-33); }, "d0df"},
+        {[](MsgPackWriter& w) { w.packInt(-129); }, "d1ff7f"},
+        {[](MsgPackWriter& w) { w.packInt(-32769); }, "d2ffff7fff"},
+        {[](MsgPackWriter& w) { w.packInt(INT64_MIN); }, "d38000000000000000"},
+        {[](MsgPackWriter& w) { w.packNil(); w.packBool(false); w.packBool(true); }, "c0c2c3"},
+        {[](MsgPackWriter& w) { w.packFloat(1.5f); }, "ca3fc00000"},
+        {[](MsgPackWriter& w) { w.packDouble(1.5); }, "cb3ff8000000000000"},
+        {[](MsgPackWriter& w) { w.packString("abc"); }, "a3616263"},
+        {[](MsgPackWriter& w) { w.packString(""); }, "a0"},
+        {[](MsgPackWriter& w) { w.packBinary("\x01", 1); }, "c40101"},
+        {[](MsgPackWriter& w) { w.packArray(15); }, "9f"},
+        {[](MsgPackWriter& w) { w.packArray(16); }, "dc0010"},
+        {[](MsgPackWriter& w) { w.packArray(65536); }, "dd00010000"},
+        {[](MsgPackWriter& w) { w.packMap(15); }, "8f"},
+        {[](MsgPackWriter& w) { w.packMap(16); }, "de0010"},
+    };
+    bool all_match = true;
+    for (const auto& c : cases) {
+        std::string buffer;
+        MsgPackWriter writer(buffer);
+        c.pack(writer);
+        if (hex(buffer) != c.expected) {
+            std::cout << "   期望 " << c.expected << "，实际 " << hex(buffer) << std::endl;
+            all_match = false;
+        }
+    }
+    std::string str8, str16;
+    MsgPackWriter(str8).packString(std::string(32, 'a'));
+    MsgPackWriter(str16).packString(std::string(256, 'a'));
+    check(all_match && hex(str8.substr(0, 2)) == "d920" && hex(str16.substr(0, 3)) == "da0100",
+          "MessagePack: 整数、浮点、字符串、数组、映射按规范选择最短编码");
+
+    // 另一种实现的写法：str8的键、float32、bin、uint64，以及带嵌套数组和ext的未知字段
+    std::string foreign;
+    MsgPackWriter writer(foreign);
+    writer.packMap(6);
+    writer.packString("extra");
+    writer.packArray(2);
+    writer.packMap(1);
+    writer.packString("k");
+    writer.packArray(1);
+    writer.packNil();
+    foreign += std::string("\xd6\x01\x00\x00\x00\x00", 6);   // fixext 4
+    writer.packString("id");
+    writer.packString("99");
+    writer.packString("method");
+    writer.packString("echo");
+    writer.packString("params");
+    writer.packArray(4);
+    writer.packFloat(0.25f);
+    writer.packBinary("\x00\xff", 2);
+    writer.packUint(3000000000ULL);
+    writer.packInt(-5);
+    writer.packString("headers");
+    writer.packMap(0);
+    writer.packString("timeout");
+    writer.packUint(250);
+
+    MessagePackSerializer serializer;
+    RpcRequest request;
+    bool ok = serializer.deserialize(foreign, request);
+    check(ok && request.id == "99" && request.method == "echo" && request.timeout.count() == 250 &&
+          request.params.size() == 4 && request.params[0].cast<double>() == 0.25 &&
+          request.params[1].cast<std::string>() == std::string("\x00\xff", 2) &&
+          request.params[2].cast<double>() == 3000000000.0 && request.params[3].cast<int>() == -5,
+          "MessagePack: 解码其他实现生成的消息，跳过未知字段");
+}
+
+void testJsonParser() {
+    JsonSerializer serializer;
+    RpcRequest request;
+
+    // 转义、\u和代理对、各种数字写法、空白
+    std::string json = " { \"id\" : \"a\\\"b\\\\c\\/\\u00e9\\ud83d\\ude00\" , \"method\":\"m\",\n"
+                       "\"params\":[1e3,-0.5,0.1,12345678901,-2147483648,true,null,\"\\n\\t\",[1,[2]],{\"k\":{}}],"
+                       "\"headers\":{\"x\":\"1\"},\"call_type\":1,\"timeout\":250,\"unknown\":[{},[]]}\t";
+    bool ok = serializer.deserialize(json, request);
+    const auto& params = request.params;
+    check(ok && request.id == "a\"b\\c/\xc3\xa9\xf0\x9f\x98\x80" && request.method == "m" &&
+          request.timeout.count() == 250 && request.call_type == CallType::ASYNC && request.headers.at("x") == "1",
+          "JSON: 转义、\\u代理对、空白和未知字段");
+    check(ok && params.size() == 10 && params[0].cast<double>() == 1000.0 && params[1].cast<double>() == -0.5 &&
+          params[2].cast<double>() == 0.1 && params[3].cast<double>() == 12345678901.0 &&
+          params[4].cast<int>() == INT_MIN && params[5].cast<bool>() && !params[6].has_value() &&
+          params[7].cast<std::string>() == "\n\t" && params[8].cast<std::string>() == "[1,[2]]" &&
+          params[9].cast<std::string>() == "{\"k\":{}}",
+          "JSON: 数字、字面量、嵌套数组/对象（按原文返回）");
+
+    const char* malformed[] = {
+        "", "{", "{\"id\":}", "{\"id\":\"x}", "{\"params\":[1,]}", "{\"id\":1}}", "{\"id\" 1}",
+        "{\"id\":\"\\q\"}", "{\"id\":\"\\ud800\"}", "{\"n\":-}", "{\"n\":1.}", "{\"n\":1e}", "[1,2]", "nul",
+    };
+    bool all_rejected = true;
+    for (const char* text : malformed) {
+        if (serializer.deserialize(std::string(text), request)) {
+            std::cout << "   未拒绝: " << text << std::endl;
+            all_rejected = false;
+        }
+    }
+    std::string deep = "{\"params\":" + std::string(100000, '[') + std::string(100000, ']') + "}";
+    all_rejected = all_rejected && !serializer.deserialize(deep, request);
+    check(all_rejected, "JSON: 格式错误和过深的嵌套被拒绝");
+
+    // 自己编码的消息往返
+    RpcRequest sample = sampleRequest();
+    RpcRequest decoded;
+    ok = serializer.deserialize(serializer.serialize(sample), decoded);
+    bool same = ok && decoded.id == sample.id && decoded.headers == sample.headers &&
+                decoded.params.size() == sample.params.size();
+    for (size_t i = 0; same && i < sample.params.size(); ++i) {
+        same = sameValue(sample.params[i], decoded.params[i]);
+    }
+    check(same, "JSON: 请求往返一致");
+}
+
+template<typename Fn>
+double nsPerOp(int iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+struct BenchmarkRow {
+    size_t request_bytes;
+    size_t response_bytes;
+    double request_encode;
+    double request_decode;
+    double response_decode;
+};
+
+BenchmarkRow measureSerializer(Serializer& serializer, const RpcRequest& request, const RpcResponse& response) {
+    const int kIterations = 20000;
+    std::string request_data = serializer.serialize(request);
+    std::string response_data = serializer.serialize(response);
+    RpcRequest decoded_request;
+    RpcResponse decoded_response;
+    size_t sink = 0;
+
+    BenchmarkRow row;
+    row.request_bytes = request_data.size();
+    row.response_bytes = response_data.size();
+    row.request_encode = nsPerOp(kIterations, [&]() { sink += serializer.serialize(request).size(); });
+    row.request_decode = nsPerOp(kIterations, [&]() { sink += serializer.deserialize(request_data, decoded_request); });
+    row.response_decode = nsPerOp(kIterations, [&]() {
+        sink += serializer.deserialize(response_data, decoded_response);
+    });
+    g_sink = sink;
+    return row;
+}
+
+void benchmark() {
+    RpcRequest request = sampleRequest();
+    RpcResponse response = sampleResponse();
+    JsonSerializer json;
+    BinarySerializer binary;
+    MessagePackSerializer msgpack;
+
+    BenchmarkRow json_row = measureSerializer(json, request, response);
+    BenchmarkRow binary_row = measureSerializer(binary, request, response);
+    BenchmarkRow msgpack_row = measureSerializer(msgpack, request, response);
+
+    std::string reused;
+    double binary_reuse = nsPerOp(20000, [&]() {
+        reused.clear();
+        binary.serializeTo(request, reused);
+    });
+    double msgpack_reuse = nsPerOp(20000, [&]() {
+        reused.clear();
+        msgpack.serializeTo(request, reused);
+    });
+
+    std::cout << "\n格式          请求字节  响应字节  请求编码(ns)  请求解码(ns)  响应解码(ns)" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    const std::pair<const char*, BenchmarkRow*> rows[] = {
+        {"JSON        ", &json_row}, {"Binary      ", &binary_row}, {"MessagePack ", &msgpack_row}};
+    for (const auto& row : rows) {
+        std::cout << row.first << std::setw(10) << row.second->request_bytes
+                  << std::setw(10) << row.second->response_bytes
+                  << std::setw(14) << row.second->request_encode << std::setw(14) << row.second->request_decode
+                  << std::setw(14) << row.second->response_decode << std::endl;
+    }
+    std::cout << "复用缓冲区编码请求: Binary " << binary_reuse << " ns，MessagePack " << msgpack_reuse << " ns" << std::endl;
+
+    check(binary_row.request_bytes < json_row.request_bytes && msgpack_row.request_bytes < json_row.request_bytes,
+          "二进制和MessagePack请求都比JSON小");
+    check(binary_row.request_encode + binary_row.request_decode < json_row.request_encode + json_row.request_decode &&
+          msgpack_row.request_encode + msgpack_row.request_decode < json_row.request_encode + json_row.request_decode,
+          "二进制和MessagePack编解码都比JSON快");
+}
+
+// JSON解析微基准：对象数组（其他服务返回的典型结果）和长文本两种负载
+void benchmarkJsonParser() {
+    std::string records = "[";
+    for (int i = 0; i < 200; ++i) {
+        records += (i ? "," : "");
+        records += "{\"id\":" + std::to_string(i) + ",\"name\":\"user " + std::to_string(i) +
+                   "\",\"tags\":[\"a\",\"b\"],\"score\":" + std::to_string(i) + ".5,\"active\":true}";
+    }
+    records += "]";
+    std::string text = "[\"";
+    for (int i = 0; i < 200; ++i) {
+        text += "The quick brown fox jumps over the lazy dog. ";
+    }
+    text += "\\n\"]";
+
+    JsonDocument document;
+    const std::pair<const char*, const std::string*> payloads[] = {{"对象数组", &records}, {"长文本", &text}};
+    std::cout << "\nJSON解析        字节    耗时(us)      MB/s" << std::endl;
+    for (const auto& payload : payloads) {
+        size_t nodes = 0;
+        double ns = nsPerOp(2000, [&]() {
+            document.parse(*payload.second);
+            nodes += document.root().child_count;
+        });
+        g_sink = nodes;
+        std::cout << std::left << std::setw(12) << payload.first << std::right << std::setw(8) << payload.second->size()
+                  << std::setw(12) << std::setprecision(1) << ns / 1000.0
+                  << std::setw(10) << std::setprecision(0) << payload.second->size() / (ns / 1e3) << std::endl;
+    }
+}
+
+void testEndToEnd(SerializationType type, int port, const std::string& name) {
+    RpcServer server(ProtocolType::TCP, type);
+    server.registerMethod("concat", [](const std::vector<AnyValue>& params) -> AnyValue {
+        return AnyValue(params[0].cast<std::string>() + std::to_string(params[1].cast<int>()));
+    });
+    server.start(ServiceEndpoint("127.0.0.1", port));
+
+    RpcClient client(ProtocolType::TCP, type);
+    client.connect(ServiceEndpoint("127.0.0.1", port));
+    auto response = client.call("concat", {AnyValue(std::string("v")), AnyValue(2)});
+    auto missing = client.call("missing");
+    client.disconnect();
+    server.stop();
+
+    check(response.isSuccess() && response.result.cast<std::string>() == "v2" &&
+          missing.error_code == ErrorCode::METHOD_NOT_FOUND,
+          name + ": 客户端和服务器完成调用");
+    check(SerializerFactory::fromContentType(SerializerFactory::create(type)->getContentType()) == type &&
+          SerializerFactory::isSupported(type),
+          name + ": SerializerFactory按类型和内容类型创建序列化器");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 序列化器测试 ===" << std::endl;
+
+    testRoundTrip<BinarySerializer>("Binary");
+    testRoundTrip<MessagePackSerializer>("MessagePack");
+    testMessagePackSpec();
+    testJsonParser();
+    testMalformedInput();
+    testEndToEnd(SerializationType::BINARY, kPort, "Binary");
+    testEndToEnd(SerializationType::MESSAGEPACK, kPort + 1, "MessagePack");
+    benchmark();
+    benchmarkJsonParser();
+
+    return finish();
+}
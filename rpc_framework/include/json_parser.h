@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rpc {
+
+// JSON值类型
+enum class JsonType : uint8_t {
+    Null,
+    False,
+    True,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+// JSON文档中的一个节点，所有节点按出现顺序存放在JsonDocument的数组中，
+// 子节点通过下标链接，不单独分配内存
+struct JsonNode {
+    static const uint32_t kNone = 0xffffffffu;
+
+    JsonType type = JsonType::Null;
+    bool escaped = false;       // 字符串含转义，内容在文档的字符串缓冲区中，否则直接指向输入
+    bool key_escaped = false;
+    bool is_integer = false;    // 数字没有小数和指数部分，且在int64范围内
+
+    uint32_t offset = 0;        // 字符串：内容；数字、数组、对象：在输入中的原文（数组和对象含括号）
+    uint32_t length = 0;
+    uint32_t key_offset = 0;    // 对象成员的键
+    uint32_t key_length = 0;
+
+    uint32_t first_child = kNone;
+    uint32_t next_sibling = kNone;
+    uint32_t child_count = 0;
+
+    int64_t integer = 0;
+    double number = 0.0;
+};
+
+// 单遍解析的JSON文档
+// 解析时一次扫描建立节点数组，数字在扫描时直接转换，不含转义的字符串不复制；
+// 节点数组和反转义后的字符串缓冲区在多次parse之间复用，稳定后解析不再分配内存。
+// 解析结果引用输入数据，输入在使用文档期间必须保持有效。
+class JsonDocument {
+public:
+    static const int kMaxDepth = 512;
+
+    bool parse(const std::string& json) { return parse(json.data(), json.size()); }
+    bool parse(const char* data, size_t length);
+
+    const JsonNode& root() const { return nodes_[0]; }
+
+    // 对象中按键查找成员，不存在返回nullptr
+    const JsonNode* find(const JsonNode& object, const char* key, size_t key_length) const;
+    const JsonNode* find(const JsonNode& object, const std::string& key) const {
+        return find(object, key.data(), key.size());
+    }
+
+    // 遍历数组元素或对象成员
+    const JsonNode* firstChild(const JsonNode& node) const { return at(node.first_child); }
+    const JsonNode* nextSibling(const JsonNode& node) const { return at(node.next_sibling); }
+
+    // 字符串节点的内容（已反转义）
+    const char* stringData(const JsonNode& node) const;
+    std::string string(const JsonNode& node) const { return std::string(stringData(node), node.length); }
+    std::string key(const JsonNode& node) const;
+
+    // 节点在输入中的原文；字符串返回内容
+    std::string text(const JsonNode& node) const;
+
+private:
+    const char* input_ = nullptr;
+    std::vector<JsonNode> nodes_;
+    std::string scratch_;   // 反转义后的字符串
+
+    const JsonNode* at(uint32_t index) const { return index == JsonNode::kNone ? nullptr : &nodes_[index]; }
+
+    friend class JsonParser;
+};
+
+} // namespace rpc
@@ -6,13 +6,24 @@
 #include <memory>
 #include <future>
 #include <unordered_map>
+#include <map>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <chrono>
 #include <condition_variable>
 
 namespace rpc {
 
+// 执行异步回调的执行器，接受任务时返回true，例如把任务提交到线程池：
+//   client.setCallbackExecutor([&pool](std::function<void()> task) { return pool.submit(task); });
+using CallbackExecutor = std::function<bool(std::function<void()>)>;
+
 // RPC客户端
+// 一个连接上可以同时有任意多个未完成的请求，请求按ID登记，响应按ID完成对应的future或回调；
+// 超时由定时器按请求检查，与socket超时无关。
+// 连接后有一个I/O线程负责接收响应、检查超时，并批量发送异步调用放入队列的请求：
+// callAsync只登记请求并入队，不创建线程也不在调用线程上写socket。
 class RpcClient {
 public:
     RpcClient(ProtocolType protocol = ProtocolType::TCP, 
@@ -31,6 +42,13 @@ public:
     // 同步调用
     RpcResponse call(const std::string& method, const std::vector<AnyValue>& params = {});
     
+    // 按方法ID同步调用，服务器直接按下标分派。
+    // 方法ID由每个服务器按注册顺序分配，只在当前连接上有效，重新连接后需要重新查询
+    RpcResponse call(uint32_t method_id, const std::vector<AnyValue>& params = {});
+    
+    // 向服务器查询方法ID（结果按方法名缓存，连接或断开时清空），失败返回0
+    uint32_t resolveMethod(const std::string& method);
+    
     // 异步调用
     std::future<RpcResponse> callAsync(const std::string& method, 
                                       const std::vector<AnyValue>& params = {});
@@ -40,6 +58,10 @@ public:
                    const std::vector<AnyValue>& params,
                    AsyncCallback callback);
     
+    // 设置执行异步回调的执行器，未设置时回调在I/O线程中执行（此时回调里不能发起同步调用）。
+    // 应在connect之前设置
+    void setCallbackExecutor(CallbackExecutor executor);
+    
     // 单向调用（不等待响应）
     bool callOneWay(const std::string& method, const std::vector<AnyValue>& params = {});
     
@@ -68,12 +90,29 @@ private:
     ServiceEndpoint current_endpoint_;
     std::chrono::milliseconds timeout_;
     
-    // 请求管理
-    std::atomic<uint32_t> next_request_id_;
-    std::unordered_map<std::string, std::promise<RpcResponse>> pending_requests_;
-    std::unordered_map<std::string, AsyncCallback> async_callbacks_;
+    // 请求管理：未完成的请求按ID登记，超时时间点按顺序放在request_timers_中
+    using TimerQueue = std::multimap<std::chrono::steady_clock::time_point, uint64_t>;
+    struct PendingCall {
+        AsyncCallback callback;
+        TimerQueue::iterator timer;
+        bool use_executor = false;  // 用户回调交给执行器，future直接在I/O线程完成
+    };
+    std::atomic<uint64_t> next_request_id_;
+    std::unordered_map<uint64_t, PendingCall> pending_requests_;
+    TimerQueue request_timers_;
     std::mutex requests_mutex_;
     
+    // 等待I/O线程发送的请求（请求ID，序列化后的数据）
+    std::vector<std::pair<uint64_t, std::string>> outgoing_;
+    std::mutex outgoing_mutex_;
+    CallbackExecutor callback_executor_;
+    
+    // 已查询到的方法ID只属于当前连接，generation在连接和断开时递增，
+    // 查询期间连接发生变化时结果不写入缓存
+    std::unordered_map<std::string, uint32_t> method_ids_;
+    uint64_t method_ids_generation_;
+    std::mutex method_ids_mutex_;
+    
     // 响应处理线程
     std::thread response_thread_;
     std::atomic<bool> running_;
@@ -83,9 +122,16 @@ private:
     
     // 内部方法
     std::string generateRequestId();
+    RpcResponse invoke(RpcRequest& request);
+    void startCall(RpcRequest& request, AsyncCallback callback, bool queued, bool use_executor);
+    bool takePending(uint64_t id, PendingCall& call);
     void responseHandler();
-    RpcResponse processResponse(const std::string& response_data);
-    void handleAsyncResponse(const RpcResponse& response);
+    void flushOutgoing();
+    void handleResponse(const std::string& response_data);
+    void expireRequests();
+    void failPendingRequests(ErrorCode code, const std::string& message);
+    void complete(PendingCall& call, const RpcResponse& response);
+    void clearMethodIds();
     
     // 工具方法
     template<typename T>
@@ -99,60 +145,172 @@ private:
 };
 
 // RPC客户端池（用于连接复用）
+// 池中的客户端各自保持一个到同一端点的连接，借出后由一个调用者独占，归还后供下一个调用者使用。
+// - 连接数在[最小, 最大]之间：start()预先建立最小数量的连接，不够时按需新建，不超过最大值
+// - 没有空闲客户端且已达上限时，调用者等待其他客户端归还，超过等待时间返回空
+// - 后台线程定期检查空闲客户端：断开的移除，空闲超时且多于最小数量的关闭，不足最小数量的补齐
+// - 空闲客户端按后进先出复用，常用的连接保持活跃，多余的连接自然空闲超时
 class RpcClientPool {
 public:
+    // 借出的客户端，析构时自动归还。不能比池的生命周期更长
+    class Lease {
+    public:
+        Lease() : pool_(nullptr) {}
+        Lease(RpcClientPool* pool, std::shared_ptr<RpcClient> client)
+            : pool_(pool), client_(std::move(client)) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), client_(std::move(other.client_)) {
+            other.pool_ = nullptr;
+        }
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                release();
+                pool_ = other.pool_;
+                client_ = std::move(other.client_);
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { release(); }
+        
+        RpcClient* operator->() const { return client_.get(); }
+        RpcClient& operator*() const { return *client_; }
+        explicit operator bool() const { return client_ != nullptr; }
+        const std::shared_ptr<RpcClient>& get() const { return client_; }
+        
+        // 提前归还
+        void release() {
+            if (pool_ && client_) {
+                pool_->releaseClient(std::move(client_));
+            }
+            client_.reset();
+            pool_ = nullptr;
+        }
+    
+    private:
+        RpcClientPool* pool_;
+        std::shared_ptr<RpcClient> client_;
+    };
+    
     RpcClientPool(const ServiceEndpoint& endpoint, 
                   size_t pool_size = 10,
                   ProtocolType protocol = ProtocolType::TCP,
                   SerializationType serialization = SerializationType::JSON);
     ~RpcClientPool();
     
-    // 获取客户端（自动管理连接）
+    // 预先建立最小数量的连接并启动健康检查线程，全部连接成功返回true。
+    // 不调用start时按需建立连接，也不做后台检查
+    bool start();
+    
+    // 关闭所有空闲连接并停止健康检查，等待中的调用者立即返回空
+    void shutdown();
+    
+    // 借出客户端，等待时间默认为setAcquireTimeout的值；超时或无法连接时返回空的Lease
+    Lease acquire();
+    Lease acquire(std::chrono::milliseconds wait);
+    
+    // 获取客户端（自动管理连接），超时或无法连接时返回nullptr，用完必须releaseClient
     std::shared_ptr<RpcClient> getClient();
     
-    // 释放客户端
+    // 释放客户端，已断开的客户端直接丢弃
     void releaseClient(std::shared_ptr<RpcClient> client);
     
-    // 设置池大小
+    // 设置池大小（最大连接数），缩小后多出的连接在归还时关闭
     void setPoolSize(size_t size);
     
+    // 设置最小连接数，健康检查线程会补齐（默认0）
+    void setMinPoolSize(size_t size);
+    
+    // 没有可用客户端时的最长等待时间（默认1秒）
+    void setAcquireTimeout(std::chrono::milliseconds timeout);
+    
+    // 空闲超过该时间的连接在多于最小数量时关闭（默认60秒）
+    void setIdleTimeout(std::chrono::milliseconds timeout);
+    
+    // 健康检查间隔（默认5秒），应在start之前设置
+    void setHealthCheckInterval(std::chrono::milliseconds interval);
+    
+    // 健康检查时调用的方法（无参数），收到任何响应即认为连接健康；
+    // 为空时（默认）只检查连接状态
+    void setHealthCheckMethod(const std::string& method);
+    
+    // 新建客户端的调用超时时间
+    void setClientTimeout(std::chrono::milliseconds timeout);
+    
     // 获取池状态
     struct PoolStatus {
         size_t total_clients;
         size_t available_clients;
         size_t busy_clients;
+        size_t waiting_callers;         // 正在等待客户端的调用者
+        uint64_t created_clients;       // 累计建立的连接
+        uint64_t closed_clients;        // 累计关闭的连接（断开、健康检查失败、空闲超时、超出池大小）
+        uint64_t acquire_timeouts;      // 等待超时次数
     };
     
     PoolStatus getStatus() const;
 
 private:
+    struct IdleClient {
+        std::shared_ptr<RpcClient> client;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+    
     ServiceEndpoint endpoint_;
     ProtocolType protocol_;
     SerializationType serialization_;
     size_t max_pool_size_;
-    
-    std::vector<std::shared_ptr<RpcClient>> available_clients_;
+    size_t min_pool_size_;
+    std::chrono::milliseconds acquire_timeout_;
+    std::chrono::milliseconds idle_timeout_;
+    std::chrono::milliseconds health_check_interval_;
+    std::chrono::milliseconds client_timeout_;
+    std::string health_check_method_;
+    
+    // 空闲客户端按归还顺序存放，末尾最近使用；正在连接和健康检查中的客户端只计数
+    std::vector<IdleClient> available_clients_;
     std::vector<std::shared_ptr<RpcClient>> busy_clients_;
+    size_t pending_clients_;
+    size_t waiting_callers_;
+    uint64_t created_clients_;
+    uint64_t closed_clients_;
+    uint64_t acquire_timeouts_;
+    bool stopped_;
     mutable std::mutex pool_mutex_;
     std::condition_variable pool_condition_;
     
+    std::thread health_thread_;
+    bool health_running_;
+    std::condition_variable health_condition_;
+    
     std::shared_ptr<RpcClient> createClient();
+    std::shared_ptr<RpcClient> acquireClient(std::chrono::milliseconds wait);
+    size_t totalClients() const;
+    bool probe(RpcClient& client);
+    void healthCheckLoop();
+    void checkIdleClients();
+    bool fillToMinimum();
 };
 
 // 负载均衡RPC客户端
+// 每个端点一个客户端池，每次调用按策略选择端点。
+// 连续失败（网络错误或超时）达到阈值的端点被摘除一段时间，之后在恢复期内流量从10%线性回升到100%；
+// 所有端点都被摘除时忽略摘除状态，避免误判导致整体不可用。
 class LoadBalancedRpcClient {
 public:
     enum class LoadBalanceStrategy {
         ROUND_ROBIN,    // 轮询
         RANDOM,         // 随机
         LEAST_CONNECTIONS, // 最少连接
-        WEIGHTED_ROUND_ROBIN // 加权轮询
+        WEIGHTED_ROUND_ROBIN, // 加权轮询
+        POWER_OF_TWO_CHOICES  // 随机取两个端点，选 延迟EWMA × (在途请求数+1) 较小的
     };
     
     LoadBalancedRpcClient(LoadBalanceStrategy strategy = LoadBalanceStrategy::ROUND_ROBIN);
     ~LoadBalancedRpcClient();
     
-    // 添加服务端点
+    // 添加服务端点，按端点的协议和序列化类型创建客户端池
     void addEndpoint(const ServiceEndpoint& endpoint, int weight = 1);
     
     // 移除服务端点
@@ -168,27 +326,74 @@ public:
     
     // 设置超时时间
     void setTimeout(std::chrono::milliseconds timeout);
+    
+    // 连续失败多少次后摘除端点（默认5）
+    void setFailureThreshold(int failures);
+    
+    // 摘除时长（默认10秒）
+    void setEjectionTime(std::chrono::milliseconds duration);
+    
+    // 摘除结束后流量回升到100%所用的时间（默认10秒）
+    void setRampUpTime(std::chrono::milliseconds duration);
+    
+    // 端点状态
+    struct EndpointStatus {
+        ServiceEndpoint endpoint;
+        int weight;
+        int active_requests;        // 在途请求数
+        double latency_ms;          // 延迟EWMA
+        uint64_t total_requests;
+        uint64_t failed_requests;   // 网络错误和超时
+        uint64_t ejections;         // 被摘除的次数
+        bool ejected;
+        double traffic_share;       // 当前接受流量的比例：摘除中为0，恢复期内从0.1升到1
+    };
+    
+    std::vector<EndpointStatus> getEndpointStatus() const;
 
 private:
     LoadBalanceStrategy strategy_;
     std::chrono::milliseconds timeout_;
+    std::atomic<int> failure_threshold_;
+    std::chrono::milliseconds ejection_time_;
+    std::chrono::milliseconds ramp_up_time_;
     
     struct EndpointInfo {
         ServiceEndpoint endpoint;
         int weight;
         std::shared_ptr<RpcClientPool> client_pool;
         std::atomic<int> active_connections{0};
+        
+        // 延迟和故障状态，更新时持有health_mutex，选择时只读原子变量
+        std::mutex health_mutex;
+        std::atomic<double> latency_ewma_us{0.0};
+        std::atomic<int64_t> last_sample_ns{0};
+        std::atomic<int64_t> ejected_until_ns{0};  // 0表示从未被摘除
+        int consecutive_failures = 0;
+        std::atomic<uint64_t> total_requests{0};
+        std::atomic<uint64_t> failed_requests{0};
+        std::atomic<uint64_t> ejections{0};
+        
+        double current_weight = 0.0;   // 平滑加权轮询的当前权重，由endpoints_mutex_保护
     };
     
-    std::vector<EndpointInfo> endpoints_;
+    // 端点移除时正在进行的调用仍持有其EndpointInfo
+    std::vector<std::shared_ptr<EndpointInfo>> endpoints_;
+    std::vector<double> traffic_shares_;   // 本次选择时各端点接受流量的比例
     std::atomic<size_t> round_robin_index_{0};
     mutable std::mutex endpoints_mutex_;
     
-    EndpointInfo* selectEndpoint();
-    EndpointInfo* selectRoundRobin();
-    EndpointInfo* selectRandom();
-    EndpointInfo* selectLeastConnections();
-    EndpointInfo* selectWeightedRoundRobin();
+    std::shared_ptr<EndpointInfo> selectEndpoint();
+    std::shared_ptr<EndpointInfo> selectRoundRobin();
+    std::shared_ptr<EndpointInfo> selectRandom();
+    std::shared_ptr<EndpointInfo> selectLeastConnections();
+    std::shared_ptr<EndpointInfo> selectWeightedRoundRobin();
+    std::shared_ptr<EndpointInfo> selectPowerOfTwoChoices();
+    
+    double trafficShare(const EndpointInfo& info, int64_t now_ns) const;
+    double latencyScore(const EndpointInfo& info, int64_t now_ns) const;
+    void finishCall(EndpointInfo& info, const RpcResponse& response,
+                    std::chrono::steady_clock::time_point start);
 };
 
 } // namespace rpc 
\ No newline at end of file
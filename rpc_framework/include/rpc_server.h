@@ -29,6 +29,9 @@ using AdvancedMethodHandler = std::function<AnyValue(const std::vector<AnyValue>
 using Middleware = std::function<bool(const RpcRequest&, RpcResponse&, const CallContext&)>;
 
 // RPC服务器
+// 方法表是不可变的快照，注册/取消注册时复制一份修改后整体替换（写时复制）。
+// 请求处理时不加锁：每个线程缓存最近一次看到的快照，只比较版本号；
+// 处理器在快照之外执行，不同连接上的请求可以并发执行。
 class RpcServer {
 public:
     RpcServer(ProtocolType protocol = ProtocolType::TCP,
@@ -44,13 +47,17 @@ public:
     // 检查服务器状态
     bool isRunning() const;
     
-    // 注册方法
-    void registerMethod(const std::string& method_name, MethodHandler handler);
-    void registerMethod(const std::string& method_name, AdvancedMethodHandler handler);
+    // 注册方法，返回方法ID（从1开始）。客户端可以用ID代替方法名调用，服务器按下标分派，不做字符串哈希。
+    // 重复注册同名方法时保留原ID；取消注册后ID不会被复用。
+    uint32_t registerMethod(const std::string& method_name, MethodHandler handler);
+    uint32_t registerMethod(const std::string& method_name, AdvancedMethodHandler handler);
     
     // 取消注册方法
     void unregisterMethod(const std::string& method_name);
     
+    // 查询方法ID，未注册返回0。客户端也可以调用内置方法"rpc.resolve"（参数为方法名）查询
+    uint32_t getMethodId(const std::string& method_name) const;
+    
     // 注册中间件
     void addMiddleware(Middleware middleware);
     
@@ -60,6 +67,9 @@ public:
     // 设置请求队列大小
     void setRequestQueueSize(size_t size);
     
+    // 设置I/O线程数（仅epoll传输层，start之前调用）
+    void setIoThreadCount(size_t count);
+    
     // 获取统计信息
     struct Statistics {
         std::atomic<uint64_t> total_requests{0};
@@ -83,15 +93,30 @@ private:
     ServiceEndpoint current_endpoint_;
     
     // 方法注册表
-    std::unordered_map<std::string, MethodHandler> methods_;
-    std::unordered_map<std::string, AdvancedMethodHandler> advanced_methods_;
-    std::mutex methods_mutex_;
+    struct MethodEntry {
+        uint32_t id = 0;
+        std::string name;
+        MethodHandler handler;
+        AdvancedMethodHandler advanced_handler;  // 同名时优先于handler
+    };
+    
+    // 不可变的方法表快照，version全局唯一
+    struct DispatchTable {
+        uint64_t version = 0;
+        std::unordered_map<std::string, std::shared_ptr<const MethodEntry>> by_name;
+        std::vector<std::shared_ptr<const MethodEntry>> by_id;  // 下标为方法ID，已取消注册的为空
+    };
+    
+    std::shared_ptr<const DispatchTable> dispatch_table_;  // 通过std::atomic_load/atomic_store访问
+    std::atomic<uint64_t> dispatch_version_;
+    std::mutex methods_mutex_;  // 只串行化注册/取消注册
     
     // 中间件
     std::vector<Middleware> middlewares_;
     std::mutex middlewares_mutex_;
     
-    // 线程池
+    // 工作线程池：传输层支持异步处理时（Linux下的epoll传输层），完整的请求在这里执行，
+    // 队列长度上限为max_queue_size_，队列满时直接返回错误
     std::vector<std::thread> worker_threads_;
     std::queue<std::function<void()>> task_queue_;
     std::mutex queue_mutex_;
@@ -107,7 +132,14 @@ private:
     // 内部方法
     std::string handleRequest(const std::string& request_data);
     RpcResponse processRequest(const RpcRequest& request, const CallContext& context);
+    RpcResponse resolveMethod(const RpcRequest& request, const DispatchTable& table);
+    std::shared_ptr<const DispatchTable> loadDispatchTable() const;
+    uint32_t updateMethod(const std::string& method_name, MethodHandler handler,
+                          AdvancedMethodHandler advanced_handler);
+    void publishDispatchTable(std::shared_ptr<DispatchTable> table);
     void workerThread();
+    void stopWorkers();
+    void enqueueRequest(std::string request_data, MessageReply reply);
     bool runMiddlewares(const RpcRequest& request, RpcResponse& response, const CallContext& context);
     void updateStatistics(const std::chrono::steady_clock::time_point& start_time, bool success);
     
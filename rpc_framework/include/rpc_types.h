@@ -6,6 +6,9 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
 
 // C++17 std::any支持检查
 #if __cplusplus >= 201703L
@@ -47,6 +50,7 @@ public:
     AnyValue(double value) : type_(DOUBLE), double_val(value) {}
     AnyValue(bool value) : type_(BOOL), bool_val(value) {}
     AnyValue(const std::string& value) : type_(STRING), string_val(value) {}
+    AnyValue(std::string&& value) : type_(STRING), string_val(std::move(value)) {}
     AnyValue(const char* value) : type_(STRING), string_val(value) {}
     
     // 拷贝构造函数
@@ -75,13 +79,47 @@ public:
         return *this;
     }
     
+    // 移动构造/赋值：字符串值不复制
+    AnyValue(AnyValue&& other) noexcept : type_(other.type_) {
+        switch (type_) {
+            case INT: int_val = other.int_val; break;
+            case DOUBLE: double_val = other.double_val; break;
+            case BOOL: bool_val = other.bool_val; break;
+            case STRING: string_val = std::move(other.string_val); break;
+            default: break;
+        }
+    }
+    
+    AnyValue& operator=(AnyValue&& other) noexcept {
+        if (this != &other) {
+            type_ = other.type_;
+            switch (type_) {
+                case INT: int_val = other.int_val; break;
+                case DOUBLE: double_val = other.double_val; break;
+                case BOOL: bool_val = other.bool_val; break;
+                case STRING: string_val = std::move(other.string_val); break;
+                default: break;
+            }
+        }
+        return *this;
+    }
+    
     template<typename T>
     T cast() const;
     
+    // 检查保存的值是否为T类型，不抛出异常
+    template<typename T>
+    bool is() const;
+    
     bool has_value() const { return type_ != NONE; }
 };
 
 // 模板特化
+template<> inline bool AnyValue::is<int>() const { return type_ == INT; }
+template<> inline bool AnyValue::is<double>() const { return type_ == DOUBLE; }
+template<> inline bool AnyValue::is<bool>() const { return type_ == BOOL; }
+template<> inline bool AnyValue::is<std::string>() const { return type_ == STRING; }
+
 template<>
 inline int AnyValue::cast<int>() const {
     if (type_ != INT) throw std::runtime_error("Type mismatch: expected int");
@@ -155,6 +193,7 @@ enum class ErrorCode {
 struct RpcRequest {
     std::string id;                             // 请求ID
     std::string method;                         // 方法名
+    uint32_t method_id = 0;                     // 方法ID，非0时服务器按ID分派（见RpcServer::registerMethod）
     std::vector<AnyValue> params;              // 参数列表
     std::map<std::string, std::string> headers; // 请求头
     CallType call_type = CallType::SYNC;        // 调用类型
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "rpc_types.h"
+#include "json_parser.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <map>
+#include <cstdint>
 
 namespace rpc {
 
@@ -48,28 +51,25 @@ public:
 
 private:
     std::string serializeAnyValue(const AnyValue& value);
-    AnyValue deserializeAnyValue(const std::string& json_str);
     std::string anyValueToJsonString(const AnyValue& value);
-    AnyValue jsonStringToAnyValue(const std::string& json_str);
-    
-    // JSON解析辅助函数
     std::string escapeString(const std::string& str);
-    std::string unescapeString(const std::string& str);
-    std::string trim(const std::string& str);
-    std::map<std::string, std::string> parseJson(const std::string& json);
-    size_t findValueEnd(const std::string& content, size_t start);
-    
-    // JSON值提取函数
-    std::string getString(const std::map<std::string, std::string>& json, const std::string& key);
-    int getInt(const std::map<std::string, std::string>& json, const std::string& key);
-    std::vector<std::string> getArray(const std::map<std::string, std::string>& json, const std::string& key);
-    std::map<std::string, std::string> getObject(const std::map<std::string, std::string>& json, const std::string& key);
-    bool hasKey(const std::map<std::string, std::string>& json, const std::string& key);
+    
+    // 解析结果转换（见json_parser.h）
+    AnyValue toAnyValue(const JsonDocument& document, const JsonNode& node);
+    std::string getString(const JsonDocument& document, const char* key);
+    int64_t getInt(const JsonDocument& document, const char* key);
+    void getHeaders(const JsonDocument& document, std::map<std::string, std::string>& headers);
 };
 
 // 二进制序列化器
+// 格式：魔数0xB7、版本号、消息类型各1字节，之后按字段顺序排列；
+// 整数用LEB128变长编码（有符号数先做zigzag），字符串为变长长度+内容，
+// AnyValue以1字节类型标签开头，headers为变长个数+若干(键,值)字符串对。
 class BinarySerializer : public Serializer {
 public:
+    static const uint8_t kMagic = 0xB7;
+    static const uint8_t kVersion = 1;
+    
     BinarySerializer();
     ~BinarySerializer() override = default;
     
@@ -79,19 +79,83 @@ public:
     std::string serialize(const RpcResponse& response) override;
     bool deserialize(const std::string& data, RpcResponse& response) override;
     
+    // 追加到调用者提供的缓冲区，缓冲区可以跨调用复用以避免重复分配
+    void serializeTo(const RpcRequest& request, std::string& buffer);
+    void serializeTo(const RpcResponse& response, std::string& buffer);
+    
     SerializationType getType() const override { return SerializationType::BINARY; }
     std::string getContentType() const override { return "application/octet-stream"; }
 
 private:
-    void writeString(std::vector<uint8_t>& buffer, const std::string& str);
-    std::string readString(const uint8_t*& data, size_t& remaining);
-    void writeInt32(std::vector<uint8_t>& buffer, int32_t value);
+    void writeVarint(std::string& buffer, uint64_t value);
+    uint64_t readVarint(const uint8_t*& data, size_t& remaining);
+    void writeString(std::string& buffer, const std::string& str);
+    void readString(const uint8_t*& data, size_t& remaining, std::string& str);
+    void writeInt32(std::string& buffer, int32_t value);
     int32_t readInt32(const uint8_t*& data, size_t& remaining);
-    void writeInt64(std::vector<uint8_t>& buffer, int64_t value);
+    void writeInt64(std::string& buffer, int64_t value);
     int64_t readInt64(const uint8_t*& data, size_t& remaining);
+    void writeValue(std::string& buffer, const AnyValue& value);
+    AnyValue readValue(const uint8_t*& data, size_t& remaining);
+    void writeHeaders(std::string& buffer, const std::map<std::string, std::string>& headers);
+    void readHeaders(const uint8_t*& data, size_t& remaining, std::map<std::string, std::string>& headers);
+    void readHeader(const uint8_t*& data, size_t& remaining, uint8_t type);
 };
 
-// MessagePack序列化器（简化版本）
+// MessagePack流式编码器：按规范选择最短的编码，直接追加到调用者提供的缓冲区
+class MsgPackWriter {
+public:
+    explicit MsgPackWriter(std::string& buffer) : buffer_(buffer) {}
+    
+    void packNil();
+    void packBool(bool value);
+    void packInt(int64_t value);        // 非负数按uint编码
+    void packUint(uint64_t value);
+    void packFloat(float value);
+    void packDouble(double value);
+    void packString(const char* data, size_t length);
+    void packString(const std::string& str) { packString(str.data(), str.size()); }
+    void packBinary(const char* data, size_t length);
+    void packArray(size_t size);        // 之后依次写入size个元素
+    void packMap(size_t size);          // 之后依次写入size个键值对
+
+private:
+    std::string& buffer_;
+    
+    void put(uint8_t byte) { buffer_.push_back(static_cast<char>(byte)); }
+    void putBigEndian(uint64_t value, int bytes);
+};
+
+// MessagePack流式解码器，数据不足或类型不符时抛出std::runtime_error
+class MsgPackReader {
+public:
+    MsgPackReader(const char* data, size_t length)
+        : data_(reinterpret_cast<const uint8_t*>(data)), remaining_(length) {}
+    
+    bool atEnd() const { return remaining_ == 0; }
+    uint8_t peek() const;
+    
+    bool isNil() const { return peek() == 0xc0; }
+    void readNil();
+    bool readBool();
+    int64_t readInt();                  // 接受所有整数编码，超出int64范围时抛出
+    double readDouble();                // 接受float32/float64
+    void readString(std::string& str);  // 接受str和bin
+    size_t readArray();
+    size_t readMap();
+    void skip();                        // 跳过一个任意类型的完整值（含嵌套的数组/映射、ext）
+
+private:
+    const uint8_t* data_;
+    size_t remaining_;
+    
+    const uint8_t* take(size_t length);
+    uint64_t readBigEndian(int bytes);
+};
+
+// MessagePack序列化器
+// 请求和响应编码为以字段名为键的map，字段与JSON格式相同，便于其他语言的msgpack库直接读写；
+// 解码时忽略不认识的键
 class MessagePackSerializer : public Serializer {
 public:
     MessagePackSerializer();
@@ -103,14 +167,18 @@ public:
     std::string serialize(const RpcResponse& response) override;
     bool deserialize(const std::string& data, RpcResponse& response) override;
     
+    // 追加到调用者提供的缓冲区
+    void serializeTo(const RpcRequest& request, std::string& buffer);
+    void serializeTo(const RpcResponse& response, std::string& buffer);
+    
     SerializationType getType() const override { return SerializationType::MESSAGEPACK; }
     std::string getContentType() const override { return "application/msgpack"; }
 
 private:
-    std::string packString(const std::string& str);
-    std::string packInt(int64_t value);
-    std::string packArray(size_t size);
-    std::string packMap(size_t size);
+    void packValue(MsgPackWriter& writer, const AnyValue& value);
+    AnyValue unpackValue(MsgPackReader& reader);
+    void packHeaders(MsgPackWriter& writer, const std::map<std::string, std::string>& headers);
+    void unpackHeaders(MsgPackReader& reader, std::map<std::string, std::string>& headers);
 };
 
 // 序列化器工厂
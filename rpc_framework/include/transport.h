@@ -9,6 +9,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <map>
+#include <vector>
 
 namespace rpc {
 
@@ -20,9 +21,25 @@ public:
     // 发送数据
     virtual bool send(const std::string& data) = 0;
     
+    // 批量发送多帧，能合并时一次写入
+    virtual bool sendFrames(const std::vector<std::string>& frames) {
+        for (const auto& frame : frames) {
+            if (!send(frame)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
     // 接收数据（阻塞）
     virtual std::string receive() = 0;
     
+    // 等待可读数据，超时返回false。多路复用客户端的读线程用它定期检查超时的请求
+    virtual bool waitReadable(std::chrono::milliseconds /* timeout */) { return true; }
+    
+    // 让阻塞在waitReadable中的线程提前返回（返回false），可在任意线程调用
+    virtual void wakeup() {}
+    
     // 连接到服务器
     virtual bool connect(const ServiceEndpoint& endpoint) = 0;
     
@@ -42,6 +59,10 @@ public:
     virtual void setConnectionCallback(ConnectionCallback callback) = 0;
 };
 
+// 异步消息处理：处理完成后调用reply发送响应，reply可以在任意线程、在处理函数返回之后调用
+using MessageReply = std::function<void(const std::string& response)>;
+using AsyncMessageHandler = std::function<void(std::string request, MessageReply reply)>;
+
 // 服务器传输层接口
 class ServerTransport {
 public:
@@ -59,18 +80,26 @@ public:
     // 设置消息处理回调
     virtual void setMessageHandler(std::function<std::string(const std::string&)> handler) = 0;
     
+    // 设置异步消息处理回调，传输层不支持时返回false（此时只使用同步回调）
+    virtual bool setAsyncMessageHandler(AsyncMessageHandler /* handler */) { return false; }
+    
     // 获取协议类型
     virtual ProtocolType getProtocolType() const = 0;
 };
 
 // TCP传输实现
+// send和receive分别加锁，多个线程可以同时发送，同时由一个读线程接收；
+// receive在超时时间内没有收到新帧时返回空字符串且连接保持，帧读到一半超时或出错时连接断开。
 class TcpTransport : public Transport {
 public:
     TcpTransport();
     ~TcpTransport() override;
     
     bool send(const std::string& data) override;
+    bool sendFrames(const std::vector<std::string>& frames) override;
     std::string receive() override;
+    bool waitReadable(std::chrono::milliseconds timeout) override;
+    void wakeup() override;
     bool connect(const ServiceEndpoint& endpoint) override;
     void disconnect() override;
     bool isConnected() const override;
@@ -80,10 +109,13 @@ public:
 
 private:
     int socket_fd_;
+    int wakeup_fds_[2];         // 非阻塞管道，wakeup()写入、waitReadable()一起等待
     std::atomic<bool> connected_;
     std::chrono::milliseconds timeout_;
     ConnectionCallback connection_callback_;
-    mutable std::mutex mutex_;
+    std::mutex mutex_;          // 连接/断开
+    std::mutex send_mutex_;     // 保证一帧完整地写入
+    std::mutex receive_mutex_;  // 保证一帧完整地读出
     
     bool setSocketNonBlocking(int fd);
     bool waitForSocket(int fd, bool for_read, std::chrono::milliseconds timeout);
@@ -117,6 +149,62 @@ private:
     bool sendMessage(int fd, const std::string& message);
 };
 
+#ifdef __linux__
+// 基于epoll的TCP服务器传输实现
+// 少量I/O线程（默认1个）各自运行一个epoll循环，非阻塞地读取并切分长度前缀帧。
+// 设置了异步处理回调时，完整的请求交给回调（通常投递到有界工作线程池），
+// 响应通过reply写入连接的输出队列：队列为空时在调用线程直接发送，
+// 写不完的部分由所属I/O线程在可写时继续发送。未设置异步回调时在I/O线程上同步处理。
+// 同一连接上的多个请求可能并发处理，响应顺序不保证与请求顺序一致，客户端按请求ID匹配。
+class EpollServerTransport : public ServerTransport {
+public:
+    EpollServerTransport();
+    ~EpollServerTransport() override;
+    
+    bool start(const ServiceEndpoint& endpoint) override;
+    void stop() override;
+    bool isRunning() const override;
+    void setMessageHandler(std::function<std::string(const std::string&)> handler) override;
+    bool setAsyncMessageHandler(AsyncMessageHandler handler) override;
+    ProtocolType getProtocolType() const override { return ProtocolType::TCP; }
+    
+    // 设置I/O线程数（start之前调用）
+    void setIoThreadCount(size_t count);
+    
+    // 设置单帧最大长度，超过时断开连接
+    void setMaxFrameSize(size_t size);
+    
+    // 当前连接数
+    size_t getConnectionCount() const;
+
+private:
+    struct Connection;
+    struct IoLoop;
+    
+    int server_fd_;
+    int reserve_fd_;    // 预留的描述符，描述符耗尽时用它接受并关闭排队的连接
+    std::atomic<bool> running_;
+    size_t io_thread_count_;
+    size_t max_frame_size_;
+    std::vector<std::unique_ptr<IoLoop>> loops_;
+    std::atomic<size_t> next_loop_;
+    std::atomic<size_t> connection_count_;
+    std::function<std::string(const std::string&)> message_handler_;
+    AsyncMessageHandler async_handler_;
+    
+    void runLoop(IoLoop& loop);
+    void acceptConnections(IoLoop& loop);
+    bool rejectPendingConnection();
+    void addConnection(IoLoop& loop, int fd);
+    void handleReadable(IoLoop& loop, const std::shared_ptr<Connection>& conn);
+    void handleWritable(IoLoop& loop, const std::shared_ptr<Connection>& conn);
+    void dispatchFrame(const std::shared_ptr<Connection>& conn, std::string frame);
+    void sendResponse(const std::shared_ptr<Connection>& conn, const std::string& response);
+    void closeConnection(IoLoop& loop, const std::shared_ptr<Connection>& conn);
+    void wakeLoop(IoLoop& loop);
+};
+#endif
+
 // HTTP传输实现
 class HttpTransport : public Transport {
 public:
@@ -0,0 +1,342 @@
+#include "../include/serializer.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace rpc {
+
+namespace {
+
+// 消息类型
+const uint8_t kRequestMessage = 1;
+const uint8_t kResponseMessage = 2;
+
+// AnyValue类型标签
+enum ValueTag : uint8_t {
+    TAG_NULL = 0,
+    TAG_INT = 1,        // zigzag变长编码的32位整数
+    TAG_INT64 = 2,      // zigzag变长编码的64位整数
+    TAG_DOUBLE = 3,     // 8字节小端IEEE 754
+    TAG_FALSE = 4,
+    TAG_TRUE = 5,
+    TAG_STRING = 6      // 变长长度 + 内容
+};
+
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+[[noreturn]] void truncated() {
+    throw std::runtime_error("Truncated binary message");
+}
+
+} // namespace
+
+const uint8_t BinarySerializer::kMagic;
+const uint8_t BinarySerializer::kVersion;
+
+BinarySerializer::BinarySerializer() {}
+
+std::string BinarySerializer::serialize(const RpcRequest& request) {
+    std::string buffer;
+    buffer.reserve(64 + request.method.size() + request.params.size() * 8);
+    serializeTo(request, buffer);
+    return buffer;
+}
+
+std::string BinarySerializer::serialize(const RpcResponse& response) {
+    std::string buffer;
+    buffer.reserve(64 + response.error_message.size());
+    serializeTo(response, buffer);
+    return buffer;
+}
+
+void BinarySerializer::serializeTo(const RpcRequest& request, std::string& buffer) {
+    buffer.push_back(static_cast<char>(kMagic));
+    buffer.push_back(static_cast<char>(kVersion));
+    buffer.push_back(static_cast<char>(kRequestMessage));
+
+    writeString(buffer, request.id);
+    writeString(buffer, request.method);
+    writeVarint(buffer, request.method_id);
+    buffer.push_back(static_cast<char>(request.call_type));
+    writeInt64(buffer, request.timeout.count());
+
+    writeVarint(buffer, request.params.size());
+    for (const auto& param : request.params) {
+        writeValue(buffer, param);
+    }
+    writeHeaders(buffer, request.headers);
+}
+
+void BinarySerializer::serializeTo(const RpcResponse& response, std::string& buffer) {
+    buffer.push_back(static_cast<char>(kMagic));
+    buffer.push_back(static_cast<char>(kVersion));
+    buffer.push_back(static_cast<char>(kResponseMessage));
+
+    writeString(buffer, response.id);
+    writeValue(buffer, response.result);
+    writeVarint(buffer, static_cast<uint64_t>(response.error_code));
+    writeString(buffer, response.error_message);
+    writeHeaders(buffer, response.headers);
+}
+
+bool BinarySerializer::deserialize(const std::string& data, RpcRequest& request) {
+    try {
+        const uint8_t* cursor = reinterpret_cast<const uint8_t*>(data.data());
+        size_t remaining = data.size();
+        readHeader(cursor, remaining, kRequestMessage);
+
+        readString(cursor, remaining, request.id);
+        readString(cursor, remaining, request.method);
+        uint64_t method_id = readVarint(cursor, remaining);
+        if (method_id > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+        request.method_id = static_cast<uint32_t>(method_id);
+        if (remaining < 1) {
+            truncated();
+        }
+        request.call_type = static_cast<CallType>(*cursor++);
+        --remaining;
+        request.timeout = std::chrono::milliseconds(readInt64(cursor, remaining));
+
+        // 每个参数至少占1字节，先检查个数以免恶意的个数导致巨大的reserve
+        uint64_t count = readVarint(cursor, remaining);
+        if (count > remaining) {
+            truncated();
+        }
+        request.params.clear();
+        request.params.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) {
+            request.params.push_back(readValue(cursor, remaining));
+        }
+        readHeaders(cursor, remaining, request.headers);
+
+        // 同一版本号下新增的字段只会追加在末尾，旧版本读取时忽略
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool BinarySerializer::deserialize(const std::string& data, RpcResponse& response) {
+    try {
+        const uint8_t* cursor = reinterpret_cast<const uint8_t*>(data.data());
+        size_t remaining = data.size();
+        readHeader(cursor, remaining, kResponseMessage);
+
+        readString(cursor, remaining, response.id);
+        response.result = readValue(cursor, remaining);
+        response.error_code = static_cast<ErrorCode>(readVarint(cursor, remaining));
+        readString(cursor, remaining, response.error_message);
+        readHeaders(cursor, remaining, response.headers);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void BinarySerializer::readHeader(const uint8_t*& data, size_t& remaining, uint8_t type) {
+    if (remaining < 3) {
+        truncated();
+    }
+    if (data[0] != kMagic || data[1] == 0 || data[1] > kVersion || data[2] != type) {
+        throw std::runtime_error("Unsupported binary message header");
+    }
+    data += 3;
+    remaining -= 3;
+}
+
+void BinarySerializer::writeVarint(std::string& buffer, uint64_t value) {
+    char bytes[10];
+    size_t length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = static_cast<char>(value);
+    buffer.append(bytes, length);
+}
+
+uint64_t BinarySerializer::readVarint(const uint8_t*& data, size_t& remaining) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (remaining == 0) {
+            truncated();
+        }
+        uint8_t byte = *data++;
+        --remaining;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Varint too long");
+}
+
+void BinarySerializer::writeString(std::string& buffer, const std::string& str) {
+    writeVarint(buffer, str.size());
+    buffer.append(str);
+}
+
+// 直接从输入缓冲区赋值到目标字符串（复用其已有容量），不经过临时字符串
+void BinarySerializer::readString(const uint8_t*& data, size_t& remaining, std::string& str) {
+    uint64_t length = readVarint(data, remaining);
+    if (length > remaining) {
+        truncated();
+    }
+    str.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
+    data += length;
+    remaining -= static_cast<size_t>(length);
+}
+
+void BinarySerializer::writeInt32(std::string& buffer, int32_t value) {
+    writeVarint(buffer, zigzagEncode(value));
+}
+
+int32_t BinarySerializer::readInt32(const uint8_t*& data, size_t& remaining) {
+    int64_t value = zigzagDecode(readVarint(data, remaining));
+    if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+        throw std::runtime_error("Integer out of range");
+    }
+    return static_cast<int32_t>(value);
+}
+
+void BinarySerializer::writeInt64(std::string& buffer, int64_t value) {
+    writeVarint(buffer, zigzagEncode(value));
+}
+
+int64_t BinarySerializer::readInt64(const uint8_t*& data, size_t& remaining) {
+    return zigzagDecode(readVarint(data, remaining));
+}
+
+void BinarySerializer::writeValue(std::string& buffer, const AnyValue& value) {
+    if (!value.has_value()) {
+        buffer.push_back(static_cast<char>(TAG_NULL));
+        return;
+    }
+
+    #if HAS_STD_ANY
+    if (auto int_val = std::any_cast<int>(&value)) {
+        buffer.push_back(static_cast<char>(TAG_INT));
+        writeInt32(buffer, *int_val);
+    } else if (auto long_val = std::any_cast<long>(&value)) {
+        buffer.push_back(static_cast<char>(TAG_INT64));
+        writeInt64(buffer, *long_val);
+    } else if (auto double_val = std::any_cast<double>(&value)) {
+        uint64_t bits;
+        std::memcpy(&bits, double_val, sizeof(bits));
+        buffer.push_back(static_cast<char>(TAG_DOUBLE));
+        for (int i = 0; i < 8; ++i) {
+            buffer.push_back(static_cast<char>(bits >> (i * 8)));
+        }
+    } else if (auto bool_val = std::any_cast<bool>(&value)) {
+        buffer.push_back(static_cast<char>(*bool_val ? TAG_TRUE : TAG_FALSE));
+    } else if (auto str_val = std::any_cast<std::string>(&value)) {
+        buffer.push_back(static_cast<char>(TAG_STRING));
+        writeString(buffer, *str_val);
+    } else {
+        buffer.push_back(static_cast<char>(TAG_NULL));
+    }
+    #else
+    if (value.is<int>()) {
+        buffer.push_back(static_cast<char>(TAG_INT));
+        writeInt32(buffer, value.cast<int>());
+    } else if (value.is<double>()) {
+        double double_val = value.cast<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &double_val, sizeof(bits));
+        buffer.push_back(static_cast<char>(TAG_DOUBLE));
+        for (int i = 0; i < 8; ++i) {
+            buffer.push_back(static_cast<char>(bits >> (i * 8)));
+        }
+    } else if (value.is<bool>()) {
+        buffer.push_back(static_cast<char>(value.cast<bool>() ? TAG_TRUE : TAG_FALSE));
+    } else {
+        buffer.push_back(static_cast<char>(TAG_STRING));
+        writeString(buffer, value.cast<const std::string&>());
+    }
+    #endif
+}
+
+AnyValue BinarySerializer::readValue(const uint8_t*& data, size_t& remaining) {
+    if (remaining == 0) {
+        truncated();
+    }
+    uint8_t tag = *data++;
+    --remaining;
+
+    switch (tag) {
+        case TAG_NULL:
+            return AnyValue();
+        case TAG_INT:
+            return AnyValue(static_cast<int>(readInt32(data, remaining)));
+        case TAG_INT64: {
+            int64_t value = readInt64(data, remaining);
+            #if HAS_STD_ANY
+            return AnyValue(static_cast<long>(value));
+            #else
+            // 没有64位整数类型，放得下时按int返回
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+                throw std::runtime_error("Integer out of range");
+            }
+            return AnyValue(static_cast<int>(value));
+            #endif
+        }
+        case TAG_DOUBLE: {
+            if (remaining < 8) {
+                truncated();
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i) {
+                bits |= static_cast<uint64_t>(data[i]) << (i * 8);
+            }
+            data += 8;
+            remaining -= 8;
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return AnyValue(value);
+        }
+        case TAG_FALSE:
+            return AnyValue(false);
+        case TAG_TRUE:
+            return AnyValue(true);
+        case TAG_STRING: {
+            std::string value;
+            readString(data, remaining, value);
+            return AnyValue(std::move(value));
+        }
+        default:
+            throw std::runtime_error("Unknown value tag");
+    }
+}
+
+void BinarySerializer::writeHeaders(std::string& buffer, const std::map<std::string, std::string>& headers) {
+    writeVarint(buffer, headers.size());
+    for (const auto& header : headers) {
+        writeString(buffer, header.first);
+        writeString(buffer, header.second);
+    }
+}
+
+void BinarySerializer::readHeaders(const uint8_t*& data, size_t& remaining,
+                                   std::map<std::string, std::string>& headers) {
+    uint64_t count = readVarint(data, remaining);
+    if (count > remaining) {
+        truncated();
+    }
+    headers.clear();
+    std::string key;
+    for (uint64_t i = 0; i < count; ++i) {
+        readString(data, remaining, key);
+        readString(data, remaining, headers[key]);
+    }
+}
+
+} // namespace rpc
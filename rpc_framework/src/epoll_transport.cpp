@@ -0,0 +1,490 @@
+#include "../include/transport.h"
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+namespace rpc {
+
+namespace {
+
+const int kMaxEvents = 64;
+const size_t kReadChunk = 64 * 1024;
+const int kMaxReadsPerEvent = 16;   // 每次可读事件最多读这么多次，避免一个连接独占I/O线程
+
+std::string makeFrame(const std::string& message) {
+    uint32_t length = htonl(static_cast<uint32_t>(message.length()));
+    std::string frame(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame += message;
+    return frame;
+}
+
+} // namespace
+
+struct EpollServerTransport::Connection {
+    int fd;
+    IoLoop* loop;
+    std::string input;                  // 只由所属I/O线程访问
+
+    // 以下由output_mutex保护
+    std::mutex output_mutex;
+    std::deque<std::string> output;     // 待发送的帧，第一帧可能已发送了一部分
+    size_t output_offset = 0;
+    bool writing = false;               // 已交给I/O线程在可写时继续发送
+    bool closed = false;
+
+    Connection(int f, IoLoop* l) : fd(f), loop(l) {}
+};
+
+struct EpollServerTransport::IoLoop {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::thread thread;
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;  // 只由本I/O线程访问
+
+    // 其他线程交给本循环处理的事情
+    std::mutex pending_mutex;
+    std::vector<int> pending_accepts;                      // 新连接
+    std::vector<std::shared_ptr<Connection>> pending_writes;  // 需要监听可写事件的连接
+
+    ~IoLoop() {
+        if (wake_fd >= 0) {
+            close(wake_fd);
+        }
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+        }
+    }
+};
+
+EpollServerTransport::EpollServerTransport()
+    : server_fd_(-1), reserve_fd_(-1), running_(false), io_thread_count_(1), max_frame_size_(16 * 1024 * 1024),
+      next_loop_(0), connection_count_(0) {}
+
+EpollServerTransport::~EpollServerTransport() {
+    stop();
+}
+
+bool EpollServerTransport::start(const ServiceEndpoint& endpoint) {
+    if (running_) {
+        return true;
+    }
+
+    server_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server_fd_ < 0) {
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(endpoint.port);
+
+    bool ok = true;
+    if (endpoint.host == "0.0.0.0" || endpoint.host.empty()) {
+        server_addr.sin_addr.s_addr = INADDR_ANY;
+    } else {
+        ok = inet_pton(AF_INET, endpoint.host.c_str(), &server_addr.sin_addr) > 0;
+    }
+    ok = ok && bind(server_fd_, (struct sockaddr*)&server_addr, sizeof(server_addr)) == 0;
+    ok = ok && listen(server_fd_, SOMAXCONN) == 0;
+
+    // 每个I/O线程一个epoll实例和一个用于唤醒的eventfd，监听socket由第一个I/O线程负责
+    for (size_t i = 0; ok && i < io_thread_count_; ++i) {
+        std::unique_ptr<IoLoop> loop(new IoLoop());
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = loop->wake_fd;
+        ok = loop->epoll_fd >= 0 && loop->wake_fd >= 0 &&
+             epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &ev) == 0;
+        if (ok && i == 0) {
+            ev.data.fd = server_fd_;
+            ok = epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, server_fd_, &ev) == 0;
+        }
+        loops_.push_back(std::move(loop));
+    }
+
+    if (!ok) {
+        loops_.clear();
+        close(server_fd_);
+        server_fd_ = -1;
+        return false;
+    }
+
+    reserve_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    running_ = true;
+    for (auto& loop : loops_) {
+        IoLoop* raw = loop.get();
+        loop->thread = std::thread([this, raw]() { runLoop(*raw); });
+    }
+    return true;
+}
+
+void EpollServerTransport::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    for (auto& loop : loops_) {
+        wakeLoop(*loop);
+    }
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+    }
+    loops_.clear();
+
+    if (server_fd_ >= 0) {
+        close(server_fd_);
+        server_fd_ = -1;
+    }
+    if (reserve_fd_ >= 0) {
+        close(reserve_fd_);
+        reserve_fd_ = -1;
+    }
+}
+
+bool EpollServerTransport::isRunning() const {
+    return running_;
+}
+
+void EpollServerTransport::setMessageHandler(std::function<std::string(const std::string&)> handler) {
+    message_handler_ = handler;
+}
+
+bool EpollServerTransport::setAsyncMessageHandler(AsyncMessageHandler handler) {
+    async_handler_ = handler;
+    return true;
+}
+
+void EpollServerTransport::setIoThreadCount(size_t count) {
+    io_thread_count_ = count > 0 ? count : 1;
+}
+
+void EpollServerTransport::setMaxFrameSize(size_t size) {
+    max_frame_size_ = size;
+}
+
+size_t EpollServerTransport::getConnectionCount() const {
+    return connection_count_;
+}
+
+void EpollServerTransport::runLoop(IoLoop& loop) {
+    struct epoll_event events[kMaxEvents];
+
+    while (running_) {
+        int count = epoll_wait(loop.epoll_fd, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+
+            if (fd == loop.wake_fd) {
+                uint64_t value;
+                while (read(loop.wake_fd, &value, sizeof(value)) > 0) {
+                }
+
+                std::vector<int> accepts;
+                std::vector<std::shared_ptr<Connection>> writes;
+                {
+                    std::lock_guard<std::mutex> lock(loop.pending_mutex);
+                    accepts.swap(loop.pending_accepts);
+                    writes.swap(loop.pending_writes);
+                }
+                for (int client_fd : accepts) {
+                    addConnection(loop, client_fd);
+                }
+                for (auto& conn : writes) {
+                    std::lock_guard<std::mutex> lock(conn->output_mutex);
+                    if (!conn->closed) {
+                        struct epoll_event ev;
+                        memset(&ev, 0, sizeof(ev));
+                        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+                        ev.data.fd = conn->fd;
+                        epoll_ctl(loop.epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+                    }
+                }
+                continue;
+            }
+
+            if (fd == server_fd_) {
+                acceptConnections(loop);
+                continue;
+            }
+
+            auto it = loop.connections.find(fd);
+            if (it == loop.connections.end()) {
+                continue;
+            }
+            std::shared_ptr<Connection> conn = it->second;
+
+            // 先读完对端关闭前发来的数据，读到EOF时关闭连接
+            if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                handleReadable(loop, conn);
+            }
+            if ((flags & EPOLLOUT) && loop.connections.count(fd)) {
+                handleWritable(loop, conn);
+            }
+        }
+    }
+
+    // 退出时关闭本循环的所有连接
+    std::vector<std::shared_ptr<Connection>> remaining;
+    for (auto& entry : loop.connections) {
+        remaining.push_back(entry.second);
+    }
+    for (auto& conn : remaining) {
+        closeConnection(loop, conn);
+    }
+    std::lock_guard<std::mutex> lock(loop.pending_mutex);
+    for (int client_fd : loop.pending_accepts) {
+        close(client_fd);
+    }
+    loop.pending_accepts.clear();
+    loop.pending_writes.clear();
+}
+
+void EpollServerTransport::acceptConnections(IoLoop& loop) {
+    while (running_) {
+        int client_fd = accept4(server_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EMFILE || errno == ENFILE) && rejectPendingConnection()) {
+                continue;
+            }
+            return;  // EAGAIN：已经接受完所有连接
+        }
+
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        // 轮流分配给各个I/O线程
+        IoLoop& target = *loops_[next_loop_++ % loops_.size()];
+        if (&target == &loop) {
+            addConnection(loop, client_fd);
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(target.pending_mutex);
+                target.pending_accepts.push_back(client_fd);
+            }
+            wakeLoop(target);
+        }
+    }
+}
+
+// 描述符耗尽时排队的连接无法接受，监听socket是水平触发的，会让I/O线程空转。
+// 释放预留的描述符，接受一个连接并立即关闭，再重新预留；返回false表示没有可以处理的连接
+bool EpollServerTransport::rejectPendingConnection() {
+    if (reserve_fd_ < 0) {
+        reserve_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (reserve_fd_ < 0) {
+            return false;
+        }
+    }
+
+    close(reserve_fd_);
+    int client_fd = accept4(server_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client_fd >= 0) {
+        close(client_fd);
+    }
+    reserve_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return client_fd >= 0;
+}
+
+void EpollServerTransport::addConnection(IoLoop& loop, int fd) {
+    auto conn = std::make_shared<Connection>(fd, &loop);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = fd;
+    if (epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return;
+    }
+
+    loop.connections[fd] = conn;
+    connection_count_++;
+}
+
+void EpollServerTransport::handleReadable(IoLoop& loop, const std::shared_ptr<Connection>& conn) {
+    char buffer[kReadChunk];
+    for (int reads = 0; reads < kMaxReadsPerEvent; ++reads) {
+        ssize_t n = recv(conn->fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn->input.append(buffer, n);
+            if (static_cast<size_t>(n) < sizeof(buffer)) {
+                break;
+            }
+        } else if (n == 0) {
+            closeConnection(loop, conn);
+            return;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            closeConnection(loop, conn);
+            return;
+        }
+    }
+
+    // 切分出所有完整的帧：4字节网络字节序长度 + 内容
+    size_t offset = 0;
+    while (conn->input.size() - offset >= sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, conn->input.data() + offset, sizeof(length));
+        length = ntohl(length);
+        if (length > max_frame_size_) {
+            closeConnection(loop, conn);
+            return;
+        }
+        if (conn->input.size() - offset - sizeof(length) < length) {
+            break;
+        }
+        std::string frame = conn->input.substr(offset + sizeof(length), length);
+        offset += sizeof(length) + length;
+        dispatchFrame(conn, std::move(frame));
+    }
+    conn->input.erase(0, offset);
+}
+
+void EpollServerTransport::handleWritable(IoLoop& loop, const std::shared_ptr<Connection>& conn) {
+    std::lock_guard<std::mutex> lock(conn->output_mutex);
+    while (!conn->output.empty()) {
+        const std::string& front = conn->output.front();
+        ssize_t n = send(conn->fd, front.data() + conn->output_offset,
+                         front.size() - conn->output_offset, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            conn->output.clear();  // 连接出错，等读事件发现后关闭
+            break;
+        }
+        conn->output_offset += n;
+        if (conn->output_offset == front.size()) {
+            conn->output.pop_front();
+            conn->output_offset = 0;
+        }
+    }
+
+    // 发送完毕，不再监听可写事件
+    conn->writing = false;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = conn->fd;
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+void EpollServerTransport::dispatchFrame(const std::shared_ptr<Connection>& conn, std::string frame) {
+    try {
+        if (async_handler_) {
+            async_handler_(std::move(frame), [this, conn](const std::string& response) {
+                sendResponse(conn, response);
+            });
+        } else if (message_handler_) {
+            sendResponse(conn, message_handler_(frame));
+        }
+    } catch (const std::exception&) {
+        // 处理器异常不能让I/O线程退出，丢弃这个请求
+    }
+}
+
+void EpollServerTransport::sendResponse(const std::shared_ptr<Connection>& conn, const std::string& response) {
+    std::string frame = makeFrame(response);
+
+    {
+        std::lock_guard<std::mutex> lock(conn->output_mutex);
+        if (conn->closed) {
+            return;
+        }
+        if (!conn->output.empty()) {
+            conn->output.push_back(std::move(frame));
+            return;
+        }
+
+        // 输出队列为空时直接在当前线程发送，大多数响应不需要经过I/O线程
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            ssize_t n = send(conn->fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                return;  // 连接出错，等读事件发现后关闭
+            }
+            sent += n;
+        }
+        if (sent == frame.size()) {
+            return;
+        }
+
+        conn->output.push_back(frame.substr(sent));
+        conn->output_offset = 0;
+        if (conn->writing) {
+            return;
+        }
+        conn->writing = true;
+    }
+
+    // 剩余部分交给所属I/O线程在可写时发送
+    IoLoop& loop = *conn->loop;
+    {
+        std::lock_guard<std::mutex> lock(loop.pending_mutex);
+        loop.pending_writes.push_back(conn);
+    }
+    wakeLoop(loop);
+}
+
+void EpollServerTransport::closeConnection(IoLoop& loop, const std::shared_ptr<Connection>& conn) {
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    {
+        // 持锁关闭，其他线程不会向已被复用的fd写入响应
+        std::lock_guard<std::mutex> lock(conn->output_mutex);
+        conn->closed = true;
+        conn->output.clear();
+        close(conn->fd);
+    }
+    loop.connections.erase(conn->fd);
+    connection_count_--;
+}
+
+void EpollServerTransport::wakeLoop(IoLoop& loop) {
+    uint64_t one = 1;
+    ssize_t written = write(loop.wake_fd, &one, sizeof(one));
+    (void)written;
+}
+
+} // namespace rpc
@@ -0,0 +1,449 @@
+#include "../include/json_parser.h"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rpc {
+
+const uint32_t JsonNode::kNone;
+const int JsonDocument::kMaxDepth;
+
+namespace {
+
+inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 找到第一个'"'或'\\'，字符串中其他字符都原样保留
+inline const char* findQuoteOrBackslash(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                  _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xc0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xe0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+// 10的0~22次方都能用double精确表示
+const double kPowersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+} // namespace
+
+// 递归下降解析器，节点直接写入文档的节点数组
+class JsonParser {
+public:
+    JsonParser(JsonDocument& document, const char* data, size_t length)
+        : document_(document), begin_(data), p_(data), end_(data + length) {}
+
+    bool run() {
+        skipWhitespace();
+        if (parseValue(0) == JsonNode::kNone) {
+            return false;
+        }
+        skipWhitespace();
+        return p_ == end_;
+    }
+
+private:
+    JsonDocument& document_;
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+
+    void skipWhitespace() {
+        while (p_ < end_ && isWhitespace(*p_)) {
+            ++p_;
+        }
+    }
+
+    uint32_t offsetOf(const char* p) const { return static_cast<uint32_t>(p - begin_); }
+
+    uint32_t newNode(JsonType type) {
+        document_.nodes_.emplace_back();
+        JsonNode& node = document_.nodes_.back();
+        node.type = type;
+        node.offset = offsetOf(p_);
+        return static_cast<uint32_t>(document_.nodes_.size() - 1);
+    }
+
+    bool consumeLiteral(const char* literal, size_t length) {
+        if (static_cast<size_t>(end_ - p_) < length || std::memcmp(p_, literal, length) != 0) {
+            return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+    uint32_t parseValue(int depth) {
+        if (p_ >= end_ || depth > JsonDocument::kMaxDepth) {
+            return JsonNode::kNone;
+        }
+        switch (*p_) {
+            case '{': return parseContainer(JsonType::Object, '}', depth);
+            case '[': return parseContainer(JsonType::Array, ']', depth);
+            case '"': {
+                uint32_t index = newNode(JsonType::String);
+                uint32_t offset, length;
+                bool escaped;
+                if (!parseString(offset, length, escaped)) {
+                    return JsonNode::kNone;
+                }
+                JsonNode& node = document_.nodes_[index];
+                node.offset = offset;
+                node.length = length;
+                node.escaped = escaped;
+                return index;
+            }
+            case 't': return consumeLiteral("true", 4) ? newLiteral(JsonType::True, 4) : JsonNode::kNone;
+            case 'f': return consumeLiteral("false", 5) ? newLiteral(JsonType::False, 5) : JsonNode::kNone;
+            case 'n': return consumeLiteral("null", 4) ? newLiteral(JsonType::Null, 4) : JsonNode::kNone;
+            default: return parseNumber();
+        }
+    }
+
+    uint32_t newLiteral(JsonType type, uint32_t length) {
+        uint32_t index = newNode(type);
+        document_.nodes_[index].offset -= length;
+        document_.nodes_[index].length = length;
+        return index;
+    }
+
+    uint32_t parseContainer(JsonType type, char close, int depth) {
+        uint32_t index = newNode(type);
+        ++p_;
+        skipWhitespace();
+
+        uint32_t last_child = JsonNode::kNone;
+        uint32_t count = 0;
+        if (p_ < end_ && *p_ == close) {
+            ++p_;
+        } else {
+            while (true) {
+                uint32_t key_offset = 0, key_length = 0;
+                bool key_escaped = false;
+                if (type == JsonType::Object) {
+                    if (p_ >= end_ || *p_ != '"' || !parseString(key_offset, key_length, key_escaped)) {
+                        return JsonNode::kNone;
+                    }
+                    skipWhitespace();
+                    if (p_ >= end_ || *p_ != ':') {
+                        return JsonNode::kNone;
+                    }
+                    ++p_;
+                    skipWhitespace();
+                }
+
+                uint32_t child = parseValue(depth + 1);
+                if (child == JsonNode::kNone) {
+                    return JsonNode::kNone;
+                }
+                // parseValue可能扩容节点数组，之前取得的引用失效，只通过下标访问
+                JsonNode& child_node = document_.nodes_[child];
+                child_node.key_offset = key_offset;
+                child_node.key_length = key_length;
+                child_node.key_escaped = key_escaped;
+                if (last_child == JsonNode::kNone) {
+                    document_.nodes_[index].first_child = child;
+                } else {
+                    document_.nodes_[last_child].next_sibling = child;
+                }
+                last_child = child;
+                ++count;
+
+                skipWhitespace();
+                if (p_ >= end_) {
+                    return JsonNode::kNone;
+                }
+                if (*p_ == ',') {
+                    ++p_;
+                    skipWhitespace();
+                    continue;
+                }
+                if (*p_ == close) {
+                    ++p_;
+                    break;
+                }
+                return JsonNode::kNone;
+            }
+        }
+
+        JsonNode& node = document_.nodes_[index];
+        node.child_count = count;
+        node.length = offsetOf(p_) - node.offset;
+        return index;
+    }
+
+    // p_指向开头的引号；不含转义时直接引用输入，否则反转义到文档的字符串缓冲区
+    bool parseString(uint32_t& offset, uint32_t& length, bool& escaped) {
+        const char* start = ++p_;
+        const char* stop = findQuoteOrBackslash(p_, end_);
+        if (stop < end_ && *stop == '"') {
+            offset = offsetOf(start);
+            length = static_cast<uint32_t>(stop - start);
+            escaped = false;
+            p_ = stop + 1;
+            return true;
+        }
+
+        std::string& scratch = document_.scratch_;
+        size_t scratch_start = scratch.size();
+        const char* segment = start;
+        while (true) {
+            if (stop >= end_) {
+                return false;
+            }
+            scratch.append(segment, stop - segment);
+            if (*stop == '"') {
+                p_ = stop + 1;
+                break;
+            }
+            // 转义序列
+            if (stop + 1 >= end_) {
+                return false;
+            }
+            const char* next = stop + 2;
+            switch (stop[1]) {
+                case '"': scratch += '"'; break;
+                case '\\': scratch += '\\'; break;
+                case '/': scratch += '/'; break;
+                case 'b': scratch += '\b'; break;
+                case 'f': scratch += '\f'; break;
+                case 'n': scratch += '\n'; break;
+                case 'r': scratch += '\r'; break;
+                case 't': scratch += '\t'; break;
+                case 'u': {
+                    uint32_t code;
+                    if (!parseHex4(stop + 2, code)) {
+                        return false;
+                    }
+                    next = stop + 6;
+                    // UTF-16代理对
+                    if (code >= 0xd800 && code <= 0xdbff) {
+                        uint32_t low;
+                        if (end_ - next < 6 || next[0] != '\\' || next[1] != 'u' ||
+                            !parseHex4(next + 2, low) || low < 0xdc00 || low > 0xdfff) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        next += 6;
+                    } else if (code >= 0xdc00 && code <= 0xdfff) {
+                        return false;
+                    }
+                    appendUtf8(scratch, code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+            segment = next;
+            stop = findQuoteOrBackslash(next, end_);
+        }
+
+        offset = static_cast<uint32_t>(scratch_start);
+        length = static_cast<uint32_t>(scratch.size() - scratch_start);
+        escaped = true;
+        return true;
+    }
+
+    bool parseHex4(const char* p, uint32_t& code) {
+        if (end_ - p < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            int value = hexValue(p[i]);
+            if (value < 0) {
+                return false;
+            }
+            code = (code << 4) | static_cast<uint32_t>(value);
+        }
+        return true;
+    }
+
+    // 整数直接累加；小数在尾数不超过2^53、十进制指数不超过22时一次乘除得到正确舍入的结果，
+    // 其余情况（很少见）交给strtod
+    uint32_t parseNumber() {
+        const char* start = p_;
+        bool negative = false;
+        if (p_ < end_ && *p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+        if (p_ >= end_ || !isDigit(*p_)) {
+            return JsonNode::kNone;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        while (p_ < end_ && isDigit(*p_)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p_ - '0');
+                if (mantissa != 0) {
+                    ++digits;
+                }
+            } else {
+                ++exponent;     // 超出19位的整数部分只记录数量级
+            }
+            ++p_;
+        }
+        bool integral = true;
+        if (p_ < end_ && *p_ == '.') {
+            integral = false;
+            ++p_;
+            if (p_ >= end_ || !isDigit(*p_)) {
+                return JsonNode::kNone;
+            }
+            while (p_ < end_ && isDigit(*p_)) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p_ - '0');
+                    if (mantissa != 0) {
+                        ++digits;
+                    }
+                    --exponent;
+                }
+                ++p_;
+            }
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            integral = false;
+            ++p_;
+            bool exp_negative = false;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+                exp_negative = *p_ == '-';
+                ++p_;
+            }
+            if (p_ >= end_ || !isDigit(*p_)) {
+                return JsonNode::kNone;
+            }
+            int exp_value = 0;
+            while (p_ < end_ && isDigit(*p_)) {
+                if (exp_value < 100000) {
+                    exp_value = exp_value * 10 + (*p_ - '0');
+                }
+                ++p_;
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+
+        uint32_t index = newNode(JsonType::Number);
+        JsonNode& node = document_.nodes_[index];
+        node.offset = offsetOf(start);
+        node.length = static_cast<uint32_t>(p_ - start);
+
+        if (integral && exponent == 0 &&
+            mantissa <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            node.is_integer = true;
+            node.integer = negative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa);
+            node.number = static_cast<double>(node.integer);
+        } else if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / kPowersOf10[-exponent] : value * kPowersOf10[exponent];
+            node.number = negative ? -value : value;
+        } else {
+            // 输入不一定以'\0'结尾，复制到局部缓冲区再交给strtod
+            std::string literal(start, p_ - start);
+            node.number = std::strtod(literal.c_str(), nullptr);
+        }
+        return index;
+    }
+};
+
+bool JsonDocument::parse(const char* data, size_t length) {
+    nodes_.clear();
+    scratch_.clear();
+    input_ = data;
+    if (length >= JsonNode::kNone) {
+        return false;
+    }
+    // 粗略估计节点数，避免解析过程中多次扩容
+    nodes_.reserve(length / 8 + 4);
+
+    JsonParser parser(*this, data, length);
+    if (!parser.run()) {
+        nodes_.clear();
+        nodes_.emplace_back();  // 失败后root()仍然可以安全访问（null）
+        return false;
+    }
+    return true;
+}
+
+const JsonNode* JsonDocument::find(const JsonNode& object, const char* key, size_t key_length) const {
+    if (object.type != JsonType::Object) {
+        return nullptr;
+    }
+    for (const JsonNode* child = firstChild(object); child; child = nextSibling(*child)) {
+        if (child->key_length == key_length) {
+            const char* data = child->key_escaped ? scratch_.data() + child->key_offset : input_ + child->key_offset;
+            if (std::memcmp(data, key, key_length) == 0) {
+                return child;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const char* JsonDocument::stringData(const JsonNode& node) const {
+    return node.escaped ? scratch_.data() + node.offset : input_ + node.offset;
+}
+
+std::string JsonDocument::key(const JsonNode& node) const {
+    const char* data = node.key_escaped ? scratch_.data() + node.key_offset : input_ + node.key_offset;
+    return std::string(data, node.key_length);
+}
+
+std::string JsonDocument::text(const JsonNode& node) const {
+    if (node.type == JsonType::String) {
+        return string(node);
+    }
+    return std::string(input_ + node.offset, node.length);
+}
+
+} // namespace rpc
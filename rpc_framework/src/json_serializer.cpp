@@ -2,6 +2,8 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 namespace rpc {
 
@@ -12,6 +14,9 @@ std::string JsonSerializer::serialize(const RpcRequest& request) {
     oss << "{";
     oss << "\"id\":\"" << escapeString(request.id) << "\",";
     oss << "\"method\":\"" << escapeString(request.method) << "\",";
+    if (request.method_id != 0) {
+        oss << "\"method_id\":" << request.method_id << ",";
+    }
     oss << "\"params\":[";
     
     for (size_t i = 0; i < request.params.size(); ++i) {
@@ -38,27 +43,31 @@ std::string JsonSerializer::serialize(const RpcRequest& request) {
 }
 
 bool JsonSerializer::deserialize(const std::string& data, RpcRequest& request) {
+    // 每个线程复用一个文档，节点数组和字符串缓冲区的内存跨调用保留
+    thread_local JsonDocument document;
+    if (!document.parse(data) || document.root().type != JsonType::Object) {
+        return false;
+    }
+    
     try {
-        auto json = parseJson(data);
-        
-        request.id = getString(json, "id");
-        request.method = getString(json, "method");
-        request.call_type = static_cast<CallType>(getInt(json, "call_type"));
-        request.timeout = std::chrono::milliseconds(getInt(json, "timeout"));
+        request.id = getString(document, "id");
+        request.method = getString(document, "method");
+        request.method_id = static_cast<uint32_t>(getInt(document, "method_id"));
+        request.call_type = static_cast<CallType>(getInt(document, "call_type"));
+        request.timeout = std::chrono::milliseconds(getInt(document, "timeout"));
         
         // 解析参数数组
-        auto params_array = getArray(json, "params");
         request.params.clear();
-        for (const auto& param : params_array) {
-            request.params.push_back(jsonStringToAnyValue(param));
+        const JsonNode* params = document.find(document.root(), "params", 6);
+        if (params && params->type == JsonType::Array) {
+            request.params.reserve(params->child_count);
+            for (const JsonNode* param = document.firstChild(*params); param; param = document.nextSibling(*param)) {
+                request.params.push_back(toAnyValue(document, *param));
+            }
         }
         
         // 解析头部
-        auto headers_obj = getObject(json, "headers");
-        request.headers.clear();
-        for (const auto& header : headers_obj) {
-            request.headers[header.first] = header.second;
-        }
+        getHeaders(document, request.headers);
         
         return true;
     } catch (const std::exception&) {
@@ -95,24 +104,22 @@ std::string JsonSerializer::serialize(const RpcResponse& response) {
 }
 
 bool JsonSerializer::deserialize(const std::string& data, RpcResponse& response) {
+    thread_local JsonDocument document;
+    if (!document.parse(data) || document.root().type != JsonType::Object) {
+        return false;
+    }
+    
     try {
-        auto json = parseJson(data);
-        
-        response.id = getString(json, "id");
-        response.error_code = static_cast<ErrorCode>(getInt(json, "error_code"));
-        response.error_message = getString(json, "error_message");
+        response.id = getString(document, "id");
+        response.error_code = static_cast<ErrorCode>(getInt(document, "error_code"));
+        response.error_message = getString(document, "error_message");
         
         // 解析结果
-        if (hasKey(json, "result") && json.at("result") != "null") {
-            response.result = jsonStringToAnyValue(json.at("result"));
-        }
+        const JsonNode* result = document.find(document.root(), "result", 6);
+        response.result = result ? toAnyValue(document, *result) : AnyValue();
         
         // 解析头部
-        auto headers_obj = getObject(json, "headers");
-        response.headers.clear();
-        for (const auto& header : headers_obj) {
-            response.headers[header.first] = header.second;
-        }
+        getHeaders(document, response.headers);
         
         return true;
     } catch (const std::exception&) {
@@ -175,41 +182,31 @@ std::string JsonSerializer::anyValueToJsonString(const AnyValue& value) {
     return "null";
 }
 
-AnyValue JsonSerializer::jsonStringToAnyValue(const std::string& json_str) {
-    std::string trimmed = trim(json_str);
-    
-    if (trimmed == "null") {
-        return AnyValue();
-    }
-    
-    if (trimmed == "true") {
-        return AnyValue(true);
-    }
-    
-    if (trimmed == "false") {
-        return AnyValue(false);
-    }
-    
-    // 字符串类型
-    if (trimmed.front() == '"' && trimmed.back() == '"') {
-        return AnyValue(unescapeString(trimmed.substr(1, trimmed.length() - 2)));
-    }
-    
-    // 数字类型
-    if (trimmed.find('.') != std::string::npos) {
-        try {
-            double val = std::stod(trimmed);
-            return AnyValue(static_cast<double>(val));
-        } catch (...) {}
-    } else {
-        try {
-            int val = std::stoi(trimmed);
-            return AnyValue(static_cast<int>(val));
-        } catch (...) {}
+AnyValue JsonSerializer::toAnyValue(const JsonDocument& document, const JsonNode& node) {
+    switch (node.type) {
+        case JsonType::Null:
+            return AnyValue();
+        case JsonType::True:
+            return AnyValue(true);
+        case JsonType::False:
+            return AnyValue(false);
+        case JsonType::String:
+            return AnyValue(document.string(node));
+        case JsonType::Number:
+            if (node.is_integer && node.integer >= std::numeric_limits<int>::min() &&
+                node.integer <= std::numeric_limits<int>::max()) {
+                return AnyValue(static_cast<int>(node.integer));
+            }
+            #if HAS_STD_ANY
+            if (node.is_integer) {
+                return AnyValue(static_cast<long>(node.integer));
+            }
+            #endif
+            return AnyValue(node.number);
+        default:
+            // AnyValue放不下数组和对象，按原文返回
+            return AnyValue(document.text(node));
     }
-    
-    // 默认返回字符串
-    return AnyValue(std::string(trimmed));
 }
 
 // 辅助函数实现
@@ -228,164 +225,31 @@ std::string JsonSerializer::escapeString(const std::string& str) {
     return result;
 }
 
-std::string JsonSerializer::unescapeString(const std::string& str) {
-    std::string result;
-    for (size_t i = 0; i < str.length(); ++i) {
-        if (str[i] == '\\' && i + 1 < str.length()) {
-            switch (str[i + 1]) {
-                case '"': result += '"'; i++; break;
-                case '\\': result += '\\'; i++; break;
-                case 'n': result += '\n'; i++; break;
-                case 'r': result += '\r'; i++; break;
-                case 't': result += '\t'; i++; break;
-                default: result += str[i]; break;
-            }
-        } else {
-            result += str[i];
-        }
-    }
-    return result;
-}
-
-std::string JsonSerializer::trim(const std::string& str) {
-    size_t start = str.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) return "";
-    size_t end = str.find_last_not_of(" \t\n\r");
-    return str.substr(start, end - start + 1);
-}
-
-// 简化的JSON解析器
-std::map<std::string, std::string> JsonSerializer::parseJson(const std::string& json) {
-    std::map<std::string, std::string> result;
-    
-    // 移除外层大括号
-    std::string content = trim(json);
-    if (content.front() == '{' && content.back() == '}') {
-        content = content.substr(1, content.length() - 2);
-    }
-    
-    // 简单的键值对解析
-    size_t pos = 0;
-    while (pos < content.length()) {
-        // 跳过空白字符
-        while (pos < content.length() && std::isspace(content[pos])) pos++;
-        if (pos >= content.length()) break;
-        
-        // 查找键
-        if (content[pos] != '"') break;
-        size_t key_start = pos + 1;
-        size_t key_end = content.find('"', key_start);
-        if (key_end == std::string::npos) break;
-        
-        std::string key = content.substr(key_start, key_end - key_start);
-        pos = key_end + 1;
-        
-        // 跳过冒号
-        while (pos < content.length() && (std::isspace(content[pos]) || content[pos] == ':')) pos++;
-        if (pos >= content.length()) break;
-        
-        // 查找值
-        size_t value_start = pos;
-        size_t value_end = findValueEnd(content, pos);
-        
-        std::string value = trim(content.substr(value_start, value_end - value_start));
-        result[key] = value;
-        
-        pos = value_end;
-        // 跳过逗号
-        while (pos < content.length() && (std::isspace(content[pos]) || content[pos] == ',')) pos++;
+std::string JsonSerializer::getString(const JsonDocument& document, const char* key) {
+    const JsonNode* node = document.find(document.root(), key, std::strlen(key));
+    if (!node || node->type == JsonType::Null) {
+        return "";
     }
-    
-    return result;
+    return document.text(*node);
 }
 
-size_t JsonSerializer::findValueEnd(const std::string& content, size_t start) {
-    size_t pos = start;
-    int brace_count = 0;
-    int bracket_count = 0;
-    bool in_string = false;
-    
-    while (pos < content.length()) {
-        char c = content[pos];
-        
-        if (!in_string) {
-            if (c == '"') {
-                in_string = true;
-            } else if (c == '{') {
-                brace_count++;
-            } else if (c == '}') {
-                brace_count--;
-            } else if (c == '[') {
-                bracket_count++;
-            } else if (c == ']') {
-                bracket_count--;
-            } else if (c == ',' && brace_count == 0 && bracket_count == 0) {
-                break;
-            }
-        } else {
-            if (c == '"' && (pos == 0 || content[pos - 1] != '\\')) {
-                in_string = false;
-            }
-        }
-        
-        pos++;
+int64_t JsonSerializer::getInt(const JsonDocument& document, const char* key) {
+    const JsonNode* node = document.find(document.root(), key, std::strlen(key));
+    if (!node || node->type != JsonType::Number) {
+        return 0;
     }
-    
-    return pos;
+    return node->is_integer ? node->integer : static_cast<int64_t>(node->number);
 }
 
-std::string JsonSerializer::getString(const std::map<std::string, std::string>& json, const std::string& key) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        std::string value = trim(it->second);
-        if (value.front() == '"' && value.back() == '"') {
-            return unescapeString(value.substr(1, value.length() - 2));
-        }
-        return value;
+void JsonSerializer::getHeaders(const JsonDocument& document, std::map<std::string, std::string>& headers) {
+    headers.clear();
+    const JsonNode* object = document.find(document.root(), "headers", 7);
+    if (!object || object->type != JsonType::Object) {
+        return;
     }
-    return "";
-}
-
-int JsonSerializer::getInt(const std::map<std::string, std::string>& json, const std::string& key) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            return std::stoi(trim(it->second));
-        } catch (...) {}
+    for (const JsonNode* header = document.firstChild(*object); header; header = document.nextSibling(*header)) {
+        headers[document.key(*header)] = document.text(*header);
     }
-    return 0;
-}
-
-std::vector<std::string> JsonSerializer::getArray(const std::map<std::string, std::string>& json, const std::string& key) {
-    std::vector<std::string> result;
-    auto it = json.find(key);
-    if (it != json.end()) {
-        std::string array_str = trim(it->second);
-        if (array_str.front() == '[' && array_str.back() == ']') {
-            std::string content = array_str.substr(1, array_str.length() - 2);
-            // 简单的数组解析
-            size_t pos = 0;
-            while (pos < content.length()) {
-                size_t end = findValueEnd(content, pos);
-                result.push_back(trim(content.substr(pos, end - pos)));
-                pos = end;
-                while (pos < content.length() && (std::isspace(content[pos]) || content[pos] == ',')) pos++;
-            }
-        }
-    }
-    return result;
-}
-
-std::map<std::string, std::string> JsonSerializer::getObject(const std::map<std::string, std::string>& json, const std::string& key) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        return parseJson(it->second);
-    }
-    return {};
-}
-
-bool JsonSerializer::hasKey(const std::map<std::string, std::string>& json, const std::string& key) {
-    return json.find(key) != json.end();
 }
 
 } // namespace rpc 
\ No newline at end of file
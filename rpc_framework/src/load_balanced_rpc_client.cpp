@@ -0,0 +1,414 @@
+#include "../include/rpc_client.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace rpc {
+
+namespace {
+
+// 延迟EWMA中新样本的权重
+const double kLatencyAlpha = 0.3;
+
+// 长时间没有新样本的端点，延迟估计按该时间常数向0衰减，使变慢后又恢复的端点重新得到流量
+const double kLatencyDecayNs = 10e9;
+
+// 恢复期开始时接受流量的比例
+const double kMinTrafficShare = 0.1;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::mt19937& randomEngine() {
+    thread_local std::mt19937 engine(std::random_device{}());
+    return engine;
+}
+
+double uniform() {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine());
+}
+
+bool isTransportFailure(const RpcResponse& response) {
+    return response.error_code == ErrorCode::NETWORK_ERROR || response.error_code == ErrorCode::TIMEOUT;
+}
+
+} // namespace
+
+LoadBalancedRpcClient::LoadBalancedRpcClient(LoadBalanceStrategy strategy)
+    : strategy_(strategy), timeout_(std::chrono::milliseconds(5000)), failure_threshold_(5),
+      ejection_time_(std::chrono::milliseconds(10000)), ramp_up_time_(std::chrono::milliseconds(10000)) {
+}
+
+LoadBalancedRpcClient::~LoadBalancedRpcClient() {
+    std::vector<std::shared_ptr<EndpointInfo>> endpoints;
+    {
+        std::lock_guard<std::mutex> lock(endpoints_mutex_);
+        endpoints.swap(endpoints_);
+    }
+    // 关闭连接时未完成的异步调用以NETWORK_ERROR结束，其回调在这里执行完
+    for (auto& info : endpoints) {
+        info->client_pool->shutdown();
+    }
+}
+
+void LoadBalancedRpcClient::addEndpoint(const ServiceEndpoint& endpoint, int weight) {
+    auto info = std::make_shared<EndpointInfo>();
+    info->endpoint = endpoint;
+    info->weight = std::max(weight, 1);
+    info->client_pool = std::make_shared<RpcClientPool>(endpoint, 10, endpoint.protocol, endpoint.serialization);
+
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    info->client_pool->setClientTimeout(timeout_);
+    endpoints_.push_back(info);
+}
+
+void LoadBalancedRpcClient::removeEndpoint(const ServiceEndpoint& endpoint) {
+    std::shared_ptr<EndpointInfo> removed;
+    {
+        std::lock_guard<std::mutex> lock(endpoints_mutex_);
+        auto it = std::find_if(endpoints_.begin(), endpoints_.end(),
+                               [&endpoint](const std::shared_ptr<EndpointInfo>& info) {
+                                   return info->endpoint.host == endpoint.host && info->endpoint.port == endpoint.port;
+                               });
+        if (it == endpoints_.end()) {
+            return;
+        }
+        removed = *it;
+        endpoints_.erase(it);
+    }
+    removed->client_pool->shutdown();
+}
+
+void LoadBalancedRpcClient::setLoadBalanceStrategy(LoadBalanceStrategy strategy) {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    strategy_ = strategy;
+}
+
+RpcResponse LoadBalancedRpcClient::call(const std::string& method, const std::vector<AnyValue>& params) {
+    auto info = selectEndpoint();
+    if (!info) {
+        RpcResponse error_response;
+        error_response.error_code = ErrorCode::NETWORK_ERROR;
+        error_response.error_message = "No endpoint available";
+        return error_response;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    info->active_connections++;
+    RpcResponse response;
+    {
+        auto lease = info->client_pool->acquire();
+        if (lease) {
+            response = lease->call(method, params);
+        } else {
+            response.error_code = ErrorCode::NETWORK_ERROR;
+            response.error_message = "No connection to " + info->endpoint.toString();
+        }
+    }
+    finishCall(*info, response, start);
+    return response;
+}
+
+std::future<RpcResponse> LoadBalancedRpcClient::callAsync(const std::string& method,
+                                                          const std::vector<AnyValue>& params) {
+    auto promise = std::make_shared<std::promise<RpcResponse>>();
+    auto future = promise->get_future();
+
+    auto info = selectEndpoint();
+    if (!info) {
+        RpcResponse error_response;
+        error_response.error_code = ErrorCode::NETWORK_ERROR;
+        error_response.error_message = "No endpoint available";
+        promise->set_value(error_response);
+        return future;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    info->active_connections++;
+    auto lease = info->client_pool->acquire();
+    if (!lease) {
+        RpcResponse error_response;
+        error_response.error_code = ErrorCode::NETWORK_ERROR;
+        error_response.error_message = "No connection to " + info->endpoint.toString();
+        finishCall(*info, error_response, start);
+        promise->set_value(error_response);
+        return future;
+    }
+
+    // 客户端支持多路复用，请求发出后立即归还，其他调用可以共用这个连接
+    lease->callAsync(method, params, [this, info, start, promise](const RpcResponse& response) {
+        finishCall(*info, response, start);
+        promise->set_value(response);
+    });
+    return future;
+}
+
+void LoadBalancedRpcClient::setTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    timeout_ = timeout;
+    for (auto& info : endpoints_) {
+        info->client_pool->setClientTimeout(timeout);
+    }
+}
+
+void LoadBalancedRpcClient::setFailureThreshold(int failures) {
+    failure_threshold_ = std::max(failures, 1);
+}
+
+void LoadBalancedRpcClient::setEjectionTime(std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    ejection_time_ = duration;
+}
+
+void LoadBalancedRpcClient::setRampUpTime(std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    ramp_up_time_ = duration;
+}
+
+std::vector<LoadBalancedRpcClient::EndpointStatus> LoadBalancedRpcClient::getEndpointStatus() const {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    int64_t now = nowNs();
+    std::vector<EndpointStatus> result;
+    for (const auto& info : endpoints_) {
+        EndpointStatus status;
+        status.endpoint = info->endpoint;
+        status.weight = info->weight;
+        status.active_requests = info->active_connections;
+        status.latency_ms = info->latency_ewma_us / 1000.0;
+        status.total_requests = info->total_requests;
+        status.failed_requests = info->failed_requests;
+        status.ejections = info->ejections;
+        status.ejected = now < info->ejected_until_ns;
+        status.traffic_share = trafficShare(*info, now);
+        result.push_back(status);
+    }
+    return result;
+}
+
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectEndpoint() {
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    if (endpoints_.empty()) {
+        return nullptr;
+    }
+
+    int64_t now = nowNs();
+    traffic_shares_.resize(endpoints_.size());
+    bool any_available = false;
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+        traffic_shares_[i] = trafficShare(*endpoints_[i], now);
+        any_available = any_available || traffic_shares_[i] > 0.0;
+    }
+    if (!any_available) {
+        std::fill(traffic_shares_.begin(), traffic_shares_.end(), 1.0);
+    }
+
+    switch (strategy_) {
+        case LoadBalanceStrategy::RANDOM:
+            return selectRandom();
+        case LoadBalanceStrategy::LEAST_CONNECTIONS:
+            return selectLeastConnections();
+        case LoadBalanceStrategy::WEIGHTED_ROUND_ROBIN:
+            return selectWeightedRoundRobin();
+        case LoadBalanceStrategy::POWER_OF_TWO_CHOICES:
+            return selectPowerOfTwoChoices();
+        case LoadBalanceStrategy::ROUND_ROBIN:
+        default:
+            return selectRoundRobin();
+    }
+}
+
+// 以下选择方法在持有endpoints_mutex_时调用，traffic_shares_已计算好且至少一个大于0
+
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectRoundRobin() {
+    size_t count = endpoints_.size();
+    size_t best = 0;
+    for (size_t attempt = 0; attempt < count; ++attempt) {
+        size_t index = round_robin_index_++ % count;
+        double share = traffic_shares_[index];
+        // 恢复期内的端点按比例接纳，未接纳时轮到下一个
+        if (share >= 1.0 || (share > 0.0 && uniform() < share)) {
+            return endpoints_[index];
+        }
+        if (share > traffic_shares_[best]) {
+            best = index;
+        }
+    }
+    return endpoints_[best];
+}
+
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectRandom() {
+    double total = 0.0;
+    for (double share : traffic_shares_) {
+        total += share;
+    }
+    double target = uniform() * total;
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+        if (traffic_shares_[i] <= 0.0) {
+            continue;
+        }
+        target -= traffic_shares_[i];
+        if (target < 0.0) {
+            return endpoints_[i];
+        }
+    }
+    // 浮点误差时取最后一个可用端点
+    for (size_t i = endpoints_.size(); i-- > 0;) {
+        if (traffic_shares_[i] > 0.0) {
+            return endpoints_[i];
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectLeastConnections() {
+    // 从轮询位置开始比较，连接数相同时不总是落到第一个端点
+    size_t count = endpoints_.size();
+    size_t start = round_robin_index_++ % count;
+    std::shared_ptr<EndpointInfo> best;
+    double best_load = 0.0;
+    for (size_t offset = 0; offset < count; ++offset) {
+        size_t index = (start + offset) % count;
+        if (traffic_shares_[index] <= 0.0) {
+            continue;
+        }
+        double load = (endpoints_[index]->active_connections + 1) / traffic_shares_[index];
+        if (!best || load < best_load) {
+            best = endpoints_[index];
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// 平滑加权轮询：每次各端点的当前权重加上有效权重，选当前权重最大的，再减去有效权重之和。
+// 权重为3:1时选择顺序为A A B A，不会连续集中到同一个端点
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectWeightedRoundRobin() {
+    double total = 0.0;
+    EndpointInfo* best = nullptr;
+    size_t best_index = 0;
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+        EndpointInfo& info = *endpoints_[i];
+        if (traffic_shares_[i] <= 0.0) {
+            continue;
+        }
+        double effective = info.weight * traffic_shares_[i];
+        info.current_weight += effective;
+        total += effective;
+        if (!best || info.current_weight > best->current_weight) {
+            best = &info;
+            best_index = i;
+        }
+    }
+    best->current_weight -= total;
+    return endpoints_[best_index];
+}
+
+// 随机取两个不同的可用端点，选延迟EWMA × (在途请求数+1)较小的。
+// 只比较两个端点避免所有调用同时涌向同一个"最快"端点，在途请求数让已经排队的端点让出流量
+std::shared_ptr<LoadBalancedRpcClient::EndpointInfo> LoadBalancedRpcClient::selectPowerOfTwoChoices() {
+    size_t available = 0;
+    for (double share : traffic_shares_) {
+        if (share > 0.0) {
+            ++available;
+        }
+    }
+
+    size_t first = 0;
+    size_t second = 0;
+    if (available > 1) {
+        first = std::uniform_int_distribution<size_t>(0, available - 1)(randomEngine());
+        second = std::uniform_int_distribution<size_t>(0, available - 2)(randomEngine());
+        if (second >= first) {
+            ++second;
+        }
+    }
+
+    // 把可用端点中的序号换算成下标
+    int64_t now = nowNs();
+    std::shared_ptr<EndpointInfo> best;
+    double best_score = 0.0;
+    size_t rank = 0;
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+        if (traffic_shares_[i] <= 0.0) {
+            continue;
+        }
+        if (rank == first || rank == second) {
+            double score = latencyScore(*endpoints_[i], now) *
+                           (endpoints_[i]->active_connections + 1) / traffic_shares_[i];
+            if (!best || score < best_score) {
+                best = endpoints_[i];
+                best_score = score;
+            }
+        }
+        ++rank;
+    }
+    return best;
+}
+
+double LoadBalancedRpcClient::trafficShare(const EndpointInfo& info, int64_t now_ns) const {
+    int64_t ejected_until = info.ejected_until_ns;
+    if (ejected_until == 0) {
+        return 1.0;
+    }
+    if (now_ns < ejected_until) {
+        return 0.0;
+    }
+
+    int64_t ramp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ramp_up_time_).count();
+    if (ramp_ns <= 0 || now_ns - ejected_until >= ramp_ns) {
+        return 1.0;
+    }
+    double progress = static_cast<double>(now_ns - ejected_until) / ramp_ns;
+    return kMinTrafficShare + (1.0 - kMinTrafficShare) * progress;
+}
+
+// 没有样本的端点为0，会被优先尝试；至少按1微秒计算，使在途请求数始终起作用
+double LoadBalancedRpcClient::latencyScore(const EndpointInfo& info, int64_t now_ns) const {
+    double latency = info.latency_ewma_us;
+    int64_t idle_ns = now_ns - info.last_sample_ns;
+    if (idle_ns > 0) {
+        latency *= std::exp(-idle_ns / kLatencyDecayNs);
+    }
+    return std::max(latency, 1.0);
+}
+
+void LoadBalancedRpcClient::finishCall(EndpointInfo& info, const RpcResponse& response,
+                                       std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    double latency_us = std::chrono::duration<double, std::micro>(end - start).count();
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+    bool failed = isTransportFailure(response);
+
+    info.total_requests++;
+    if (failed) {
+        info.failed_requests++;
+    }
+
+    std::unique_lock<std::mutex> lock(info.health_mutex);
+    // 连接失败通常很快返回，不计入延迟，否则故障端点看起来最快
+    if (response.error_code != ErrorCode::NETWORK_ERROR) {
+        double ewma = info.latency_ewma_us;
+        info.latency_ewma_us = info.last_sample_ns == 0 ? latency_us
+                                                        : ewma + kLatencyAlpha * (latency_us - ewma);
+        info.last_sample_ns = now;
+    }
+
+    if (!failed) {
+        info.consecutive_failures = 0;
+    } else if (++info.consecutive_failures >= failure_threshold_) {
+        info.consecutive_failures = 0;
+        lock.unlock();
+        std::chrono::milliseconds ejection_time;
+        {
+            std::lock_guard<std::mutex> endpoints_lock(endpoints_mutex_);
+            ejection_time = ejection_time_;
+        }
+        info.ejected_until_ns = now + std::chrono::duration_cast<std::chrono::nanoseconds>(ejection_time).count();
+        info.ejections++;
+    }
+    info.active_connections--;
+}
+
+} // namespace rpc
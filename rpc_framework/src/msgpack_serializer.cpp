@@ -0,0 +1,544 @@
+#include "../include/serializer.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace rpc {
+
+// MessagePack格式规范：https://github.com/msgpack/msgpack/blob/master/spec.md
+
+// ==================== MsgPackWriter ====================
+
+void MsgPackWriter::putBigEndian(uint64_t value, int bytes) {
+    char out[8];
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<char>(value >> ((bytes - 1 - i) * 8));
+    }
+    buffer_.append(out, bytes);
+}
+
+void MsgPackWriter::packNil() {
+    put(0xc0);
+}
+
+void MsgPackWriter::packBool(bool value) {
+    put(value ? 0xc3 : 0xc2);
+}
+
+void MsgPackWriter::packInt(int64_t value) {
+    if (value >= 0) {
+        packUint(static_cast<uint64_t>(value));
+    } else if (value >= -32) {
+        put(static_cast<uint8_t>(value));                   // negative fixint 111xxxxx
+    } else if (value >= std::numeric_limits<int8_t>::min()) {
+        put(0xd0);
+        putBigEndian(static_cast<uint8_t>(value), 1);
+    } else if (value >= std::numeric_limits<int16_t>::min()) {
+        put(0xd1);
+        putBigEndian(static_cast<uint16_t>(value), 2);
+    } else if (value >= std::numeric_limits<int32_t>::min()) {
+        put(0xd2);
+        putBigEndian(static_cast<uint32_t>(value), 4);
+    } else {
+        put(0xd3);
+        putBigEndian(static_cast<uint64_t>(value), 8);
+    }
+}
+
+void MsgPackWriter::packUint(uint64_t value) {
+    if (value < 0x80) {
+        put(static_cast<uint8_t>(value));                   // positive fixint 0xxxxxxx
+    } else if (value <= 0xff) {
+        put(0xcc);
+        putBigEndian(value, 1);
+    } else if (value <= 0xffff) {
+        put(0xcd);
+        putBigEndian(value, 2);
+    } else if (value <= 0xffffffffULL) {
+        put(0xce);
+        putBigEndian(value, 4);
+    } else {
+        put(0xcf);
+        putBigEndian(value, 8);
+    }
+}
+
+void MsgPackWriter::packFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(0xca);
+    putBigEndian(bits, 4);
+}
+
+void MsgPackWriter::packDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(0xcb);
+    putBigEndian(bits, 8);
+}
+
+void MsgPackWriter::packString(const char* data, size_t length) {
+    if (length < 32) {
+        put(static_cast<uint8_t>(0xa0 | length));           // fixstr 101xxxxx
+    } else if (length <= 0xff) {
+        put(0xd9);
+        putBigEndian(length, 1);
+    } else if (length <= 0xffff) {
+        put(0xda);
+        putBigEndian(length, 2);
+    } else {
+        put(0xdb);
+        putBigEndian(length, 4);
+    }
+    buffer_.append(data, length);
+}
+
+void MsgPackWriter::packBinary(const char* data, size_t length) {
+    if (length <= 0xff) {
+        put(0xc4);
+        putBigEndian(length, 1);
+    } else if (length <= 0xffff) {
+        put(0xc5);
+        putBigEndian(length, 2);
+    } else {
+        put(0xc6);
+        putBigEndian(length, 4);
+    }
+    buffer_.append(data, length);
+}
+
+void MsgPackWriter::packArray(size_t size) {
+    if (size < 16) {
+        put(static_cast<uint8_t>(0x90 | size));             // fixarray 1001xxxx
+    } else if (size <= 0xffff) {
+        put(0xdc);
+        putBigEndian(size, 2);
+    } else {
+        put(0xdd);
+        putBigEndian(size, 4);
+    }
+}
+
+void MsgPackWriter::packMap(size_t size) {
+    if (size < 16) {
+        put(static_cast<uint8_t>(0x80 | size));             // fixmap 1000xxxx
+    } else if (size <= 0xffff) {
+        put(0xde);
+        putBigEndian(size, 2);
+    } else {
+        put(0xdf);
+        putBigEndian(size, 4);
+    }
+}
+
+// ==================== MsgPackReader ====================
+
+const uint8_t* MsgPackReader::take(size_t length) {
+    if (length > remaining_) {
+        throw std::runtime_error("Truncated msgpack data");
+    }
+    const uint8_t* start = data_;
+    data_ += length;
+    remaining_ -= length;
+    return start;
+}
+
+uint64_t MsgPackReader::readBigEndian(int bytes) {
+    const uint8_t* p = take(bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+uint8_t MsgPackReader::peek() const {
+    if (remaining_ == 0) {
+        throw std::runtime_error("Truncated msgpack data");
+    }
+    return *data_;
+}
+
+void MsgPackReader::readNil() {
+    if (*take(1) != 0xc0) {
+        throw std::runtime_error("Expected msgpack nil");
+    }
+}
+
+bool MsgPackReader::readBool() {
+    uint8_t byte = *take(1);
+    if (byte == 0xc2 || byte == 0xc3) {
+        return byte == 0xc3;
+    }
+    throw std::runtime_error("Expected msgpack bool");
+}
+
+int64_t MsgPackReader::readInt() {
+    uint8_t byte = *take(1);
+    if (byte < 0x80) {
+        return byte;
+    }
+    if (byte >= 0xe0) {
+        return static_cast<int8_t>(byte);
+    }
+    switch (byte) {
+        case 0xcc: return static_cast<int64_t>(readBigEndian(1));
+        case 0xcd: return static_cast<int64_t>(readBigEndian(2));
+        case 0xce: return static_cast<int64_t>(readBigEndian(4));
+        case 0xcf: {
+            uint64_t value = readBigEndian(8);
+            if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                throw std::runtime_error("msgpack integer out of range");
+            }
+            return static_cast<int64_t>(value);
+        }
+        case 0xd0: return static_cast<int8_t>(readBigEndian(1));
+        case 0xd1: return static_cast<int16_t>(readBigEndian(2));
+        case 0xd2: return static_cast<int32_t>(readBigEndian(4));
+        case 0xd3: return static_cast<int64_t>(readBigEndian(8));
+        default: throw std::runtime_error("Expected msgpack integer");
+    }
+}
+
+double MsgPackReader::readDouble() {
+    uint8_t byte = peek();
+    if (byte == 0xca) {
+        take(1);
+        uint32_t bits = static_cast<uint32_t>(readBigEndian(4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if (byte == 0xcb) {
+        take(1);
+        uint64_t bits = readBigEndian(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if (byte == 0xcf) {
+        take(1);
+        return static_cast<double>(readBigEndian(8));
+    }
+    return static_cast<double>(readInt());
+}
+
+void MsgPackReader::readString(std::string& str) {
+    uint8_t byte = *take(1);
+    size_t length;
+    if ((byte & 0xe0) == 0xa0) {
+        length = byte & 0x1f;
+    } else {
+        switch (byte) {
+            case 0xd9: case 0xc4: length = readBigEndian(1); break;
+            case 0xda: case 0xc5: length = readBigEndian(2); break;
+            case 0xdb: case 0xc6: length = readBigEndian(4); break;
+            default: throw std::runtime_error("Expected msgpack string");
+        }
+    }
+    const uint8_t* p = take(length);
+    str.assign(reinterpret_cast<const char*>(p), length);
+}
+
+size_t MsgPackReader::readArray() {
+    uint8_t byte = *take(1);
+    if ((byte & 0xf0) == 0x90) {
+        return byte & 0x0f;
+    }
+    switch (byte) {
+        case 0xdc: return readBigEndian(2);
+        case 0xdd: return readBigEndian(4);
+        default: throw std::runtime_error("Expected msgpack array");
+    }
+}
+
+size_t MsgPackReader::readMap() {
+    uint8_t byte = *take(1);
+    if ((byte & 0xf0) == 0x80) {
+        return byte & 0x0f;
+    }
+    switch (byte) {
+        case 0xde: return readBigEndian(2);
+        case 0xdf: return readBigEndian(4);
+        default: throw std::runtime_error("Expected msgpack map");
+    }
+}
+
+void MsgPackReader::skip() {
+    // 待跳过的值的个数；用计数代替递归，恶意的深层嵌套不会耗尽栈
+    uint64_t pending = 1;
+    while (pending > 0) {
+        --pending;
+        uint8_t byte = *take(1);
+        if (byte < 0x80 || byte >= 0xe0 || byte == 0xc0 || byte == 0xc2 || byte == 0xc3) {
+            continue;                                       // fixint、nil、bool
+        }
+        if ((byte & 0xe0) == 0xa0) {
+            take(byte & 0x1f);
+            continue;
+        }
+        if ((byte & 0xf0) == 0x90) {
+            pending += byte & 0x0f;
+            continue;
+        }
+        if ((byte & 0xf0) == 0x80) {
+            pending += 2 * (byte & 0x0f);
+            continue;
+        }
+        switch (byte) {
+            case 0xcc: case 0xd0: take(1); break;
+            case 0xcd: case 0xd1: take(2); break;
+            case 0xce: case 0xd2: case 0xca: take(4); break;
+            case 0xcf: case 0xd3: case 0xcb: take(8); break;
+            case 0xc4: case 0xd9: take(readBigEndian(1)); break;
+            case 0xc5: case 0xda: take(readBigEndian(2)); break;
+            case 0xc6: case 0xdb: take(readBigEndian(4)); break;
+            case 0xdc: pending += readBigEndian(2); break;
+            case 0xdd: pending += readBigEndian(4); break;
+            case 0xde: pending += 2 * readBigEndian(2); break;
+            case 0xdf: pending += 2 * readBigEndian(4); break;
+            // ext：1字节类型 + 数据
+            case 0xd4: take(2); break;
+            case 0xd5: take(3); break;
+            case 0xd6: take(5); break;
+            case 0xd7: take(9); break;
+            case 0xd8: take(17); break;
+            case 0xc7: take(readBigEndian(1) + 1); break;
+            case 0xc8: take(readBigEndian(2) + 1); break;
+            case 0xc9: take(readBigEndian(4) + 1); break;
+            default: throw std::runtime_error("Invalid msgpack type byte");  // 0xc1
+        }
+        // 每个元素至少1字节，声明的个数超过剩余数据时不可能完整
+        if (pending > remaining_) {
+            throw std::runtime_error("Truncated msgpack data");
+        }
+    }
+}
+
+// ==================== MessagePackSerializer ====================
+
+MessagePackSerializer::MessagePackSerializer() {}
+
+std::string MessagePackSerializer::serialize(const RpcRequest& request) {
+    std::string buffer;
+    buffer.reserve(96 + request.method.size() + request.params.size() * 8);
+    serializeTo(request, buffer);
+    return buffer;
+}
+
+std::string MessagePackSerializer::serialize(const RpcResponse& response) {
+    std::string buffer;
+    buffer.reserve(80 + response.error_message.size());
+    serializeTo(response, buffer);
+    return buffer;
+}
+
+void MessagePackSerializer::serializeTo(const RpcRequest& request, std::string& buffer) {
+    MsgPackWriter writer(buffer);
+    writer.packMap(request.method_id != 0 ? 7 : 6);
+    writer.packString("id", 2);
+    writer.packString(request.id);
+    writer.packString("method", 6);
+    writer.packString(request.method);
+    if (request.method_id != 0) {
+        writer.packString("method_id", 9);
+        writer.packUint(request.method_id);
+    }
+    writer.packString("params", 6);
+    writer.packArray(request.params.size());
+    for (const auto& param : request.params) {
+        packValue(writer, param);
+    }
+    writer.packString("headers", 7);
+    packHeaders(writer, request.headers);
+    writer.packString("call_type", 9);
+    writer.packInt(static_cast<int>(request.call_type));
+    writer.packString("timeout", 7);
+    writer.packInt(request.timeout.count());
+}
+
+void MessagePackSerializer::serializeTo(const RpcResponse& response, std::string& buffer) {
+    MsgPackWriter writer(buffer);
+    writer.packMap(5);
+    writer.packString("id", 2);
+    writer.packString(response.id);
+    writer.packString("result", 6);
+    packValue(writer, response.result);
+    writer.packString("error_code", 10);
+    writer.packInt(static_cast<int>(response.error_code));
+    writer.packString("error_message", 13);
+    writer.packString(response.error_message);
+    writer.packString("headers", 7);
+    packHeaders(writer, response.headers);
+}
+
+bool MessagePackSerializer::deserialize(const std::string& data, RpcRequest& request) {
+    try {
+        MsgPackReader reader(data.data(), data.size());
+        request.method_id = 0;
+        request.params.clear();
+        request.headers.clear();
+
+        std::string key;
+        size_t fields = reader.readMap();
+        for (size_t i = 0; i < fields; ++i) {
+            reader.readString(key);
+            if (key == "id") {
+                reader.readString(request.id);
+            } else if (key == "method") {
+                reader.readString(request.method);
+            } else if (key == "method_id") {
+                int64_t method_id = reader.readInt();
+                if (method_id < 0 || method_id > std::numeric_limits<uint32_t>::max()) {
+                    return false;
+                }
+                request.method_id = static_cast<uint32_t>(method_id);
+            } else if (key == "params") {
+                size_t count = reader.readArray();
+                for (size_t j = 0; j < count; ++j) {
+                    request.params.push_back(unpackValue(reader));
+                }
+            } else if (key == "headers") {
+                unpackHeaders(reader, request.headers);
+            } else if (key == "call_type") {
+                request.call_type = static_cast<CallType>(reader.readInt());
+            } else if (key == "timeout") {
+                request.timeout = std::chrono::milliseconds(reader.readInt());
+            } else {
+                reader.skip();
+            }
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool MessagePackSerializer::deserialize(const std::string& data, RpcResponse& response) {
+    try {
+        MsgPackReader reader(data.data(), data.size());
+        response.result = AnyValue();
+        response.error_code = ErrorCode::SUCCESS;
+        response.headers.clear();
+
+        std::string key;
+        size_t fields = reader.readMap();
+        for (size_t i = 0; i < fields; ++i) {
+            reader.readString(key);
+            if (key == "id") {
+                reader.readString(response.id);
+            } else if (key == "result") {
+                response.result = unpackValue(reader);
+            } else if (key == "error_code") {
+                response.error_code = static_cast<ErrorCode>(reader.readInt());
+            } else if (key == "error_message") {
+                reader.readString(response.error_message);
+            } else if (key == "headers") {
+                unpackHeaders(reader, response.headers);
+            } else {
+                reader.skip();
+            }
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void MessagePackSerializer::packValue(MsgPackWriter& writer, const AnyValue& value) {
+    if (!value.has_value()) {
+        writer.packNil();
+        return;
+    }
+
+    #if HAS_STD_ANY
+    if (auto int_val = std::any_cast<int>(&value)) {
+        writer.packInt(*int_val);
+    } else if (auto long_val = std::any_cast<long>(&value)) {
+        writer.packInt(*long_val);
+    } else if (auto double_val = std::any_cast<double>(&value)) {
+        writer.packDouble(*double_val);
+    } else if (auto bool_val = std::any_cast<bool>(&value)) {
+        writer.packBool(*bool_val);
+    } else if (auto str_val = std::any_cast<std::string>(&value)) {
+        writer.packString(*str_val);
+    } else {
+        writer.packNil();
+    }
+    #else
+    if (value.is<int>()) {
+        writer.packInt(value.cast<int>());
+    } else if (value.is<double>()) {
+        writer.packDouble(value.cast<double>());
+    } else if (value.is<bool>()) {
+        writer.packBool(value.cast<bool>());
+    } else {
+        writer.packString(value.cast<const std::string&>());
+    }
+    #endif
+}
+
+AnyValue MessagePackSerializer::unpackValue(MsgPackReader& reader) {
+    uint8_t byte = reader.peek();
+
+    if (byte == 0xc0) {
+        reader.readNil();
+        return AnyValue();
+    }
+    if (byte == 0xc2 || byte == 0xc3) {
+        return AnyValue(reader.readBool());
+    }
+    if (byte == 0xca || byte == 0xcb) {
+        return AnyValue(reader.readDouble());
+    }
+    if ((byte & 0xe0) == 0xa0 || (byte >= 0xc4 && byte <= 0xc6) || (byte >= 0xd9 && byte <= 0xdb)) {
+        std::string str;
+        reader.readString(str);                             // bin也按字节串返回
+        return AnyValue(std::move(str));
+    }
+    if (byte < 0x80 || byte >= 0xe0 || (byte >= 0xcc && byte <= 0xd3)) {
+        int64_t value;
+        if (byte == 0xcf) {
+            // 超出int64范围的uint64只能按double返回
+            MsgPackReader probe = reader;
+            try {
+                value = probe.readInt();
+                reader = probe;
+            } catch (const std::exception&) {
+                return AnyValue(reader.readDouble());
+            }
+        } else {
+            value = reader.readInt();
+        }
+        if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+            return AnyValue(static_cast<int>(value));
+        }
+        #if HAS_STD_ANY
+        return AnyValue(static_cast<long>(value));
+        #else
+        return AnyValue(static_cast<double>(value));        // AnyValue没有64位整数
+        #endif
+    }
+    // 数组、映射和ext无法放进AnyValue
+    throw std::runtime_error("Unsupported msgpack value type");
+}
+
+void MessagePackSerializer::packHeaders(MsgPackWriter& writer, const std::map<std::string, std::string>& headers) {
+    writer.packMap(headers.size());
+    for (const auto& header : headers) {
+        writer.packString(header.first);
+        writer.packString(header.second);
+    }
+}
+
+void MessagePackSerializer::unpackHeaders(MsgPackReader& reader, std::map<std::string, std::string>& headers) {
+    std::string key;
+    size_t count = reader.readMap();
+    for (size_t i = 0; i < count; ++i) {
+        reader.readString(key);
+        reader.readString(headers[key]);
+    }
+}
+
+} // namespace rpc
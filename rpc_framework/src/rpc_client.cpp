@@ -5,12 +5,14 @@
 #include <sstream>
 #include <random>
 #include <future>
+#include <algorithm>
+#include <cstdlib>
 
 namespace rpc {
 
 RpcClient::RpcClient(ProtocolType protocol, SerializationType serialization)
     : current_endpoint_("", 0), timeout_(std::chrono::milliseconds(5000)), 
-      next_request_id_(0), running_(false) {
+      next_request_id_(0), method_ids_generation_(0), running_(false) {
     
     // 创建传输层
     switch (protocol) {
@@ -22,12 +24,9 @@ RpcClient::RpcClient(ProtocolType protocol, SerializationType serialization)
     }
     
     // 创建序列化器
-    switch (serialization) {
-        case SerializationType::JSON:
-            serializer_ = std::make_unique<JsonSerializer>();
-            break;
-        default:
-            throw std::runtime_error("Unsupported serialization type");
+    serializer_ = SerializerFactory::create(serialization);
+    if (!serializer_) {
+        throw std::runtime_error("Unsupported serialization type");
     }
 }
 
@@ -36,16 +35,41 @@ RpcClient::~RpcClient() {
 }
 
 bool RpcClient::connect(const ServiceEndpoint& endpoint) {
+    disconnect();
+    
     current_endpoint_ = endpoint;
+    clearMethodIds();
     bool success = transport_->connect(endpoint);
+    if (success) {
+        // 上一个连接断开后才入队的请求已经以失败结束，不能在新连接上发出
+        {
+            std::lock_guard<std::mutex> lock(outgoing_mutex_);
+            outgoing_.clear();
+        }
+        running_ = true;
+        response_thread_ = std::thread(&RpcClient::responseHandler, this);
+    }
     
     return success;
 }
 
 void RpcClient::disconnect() {
+    running_ = false;
     if (transport_) {
+        transport_->wakeup();
         transport_->disconnect();
     }
+    if (response_thread_.joinable() && response_thread_.get_id() != std::this_thread::get_id()) {
+        response_thread_.join();
+    }
+    failPendingRequests(ErrorCode::NETWORK_ERROR, "Connection closed");
+    clearMethodIds();
+}
+
+void RpcClient::clearMethodIds() {
+    std::lock_guard<std::mutex> lock(method_ids_mutex_);
+    method_ids_.clear();
+    ++method_ids_generation_;
 }
 
 bool RpcClient::isConnected() const {
@@ -53,106 +77,343 @@ bool RpcClient::isConnected() const {
 }
 
 RpcResponse RpcClient::call(const std::string& method, const std::vector<AnyValue>& params) {
+    RpcRequest request(method);
+    request.params = params;
+    return invoke(request);
+}
+
+RpcResponse RpcClient::call(uint32_t method_id, const std::vector<AnyValue>& params) {
+    RpcRequest request;
+    request.method_id = method_id;
+    request.params = params;
+    return invoke(request);
+}
+
+uint32_t RpcClient::resolveMethod(const std::string& method) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(method_ids_mutex_);
+        auto it = method_ids_.find(method);
+        if (it != method_ids_.end()) {
+            return it->second;
+        }
+        generation = method_ids_generation_;
+    }
+    
+    RpcResponse response = call("rpc.resolve", {AnyValue(method)});
+    if (!response.isSuccess()) {
+        return 0;
+    }
+    #if HAS_STD_ANY
+    uint32_t method_id = static_cast<uint32_t>(std::any_cast<int>(response.result));
+    #else
+    uint32_t method_id = static_cast<uint32_t>(response.result.cast<int>());
+    #endif
+    
+    std::lock_guard<std::mutex> lock(method_ids_mutex_);
+    if (generation == method_ids_generation_) {
+        method_ids_[method] = method_id;
+    }
+    return method_id;
+}
+
+RpcResponse RpcClient::invoke(RpcRequest& request) {
+    // I/O线程要等回调返回才能读下一个响应，在I/O线程上同步等待只会超时
+    if (std::this_thread::get_id() == response_thread_.get_id()) {
+        RpcResponse error_response;
+        error_response.error_code = ErrorCode::INTERNAL_ERROR;
+        error_response.error_message = "Synchronous call from response callback is not allowed";
+        stats_.failed_requests++;
+        return error_response;
+    }
+    
+    // 同步调用由调用线程直接发送，省去一次线程切换
+    request.call_type = CallType::SYNC;
+    auto promise = std::make_shared<std::promise<RpcResponse>>();
+    auto future = promise->get_future();
+    startCall(request, [promise](const RpcResponse& response) {
+        promise->set_value(response);
+    }, false, false);
+    return future.get();
+}
+
+void RpcClient::startCall(RpcRequest& request, AsyncCallback callback, bool queued, bool use_executor) {
+    PendingCall call{std::move(callback), TimerQueue::iterator(), use_executor};
+    
     if (!isConnected()) {
         RpcResponse error_response;
         error_response.error_code = ErrorCode::NETWORK_ERROR;
         error_response.error_message = "Not connected to server";
-        stats_.failed_requests++;
-        return error_response;
+        complete(call, error_response);
+        return;
     }
     
-    // 记录请求开始时间
     stats_.total_requests++;
     
+    std::string request_data;
     try {
-        // 创建请求
-        RpcRequest request;
         request.id = generateRequestId();
-        request.method = method;
-        request.params = params;
-        request.call_type = CallType::SYNC;
         request.timeout = timeout_;
+        request_data = serializer_->serialize(request);
+    } catch (const std::exception& e) {
+        RpcResponse error_response;
+        error_response.id = request.id;
+        error_response.error_code = ErrorCode::SERIALIZATION_ERROR;
+        error_response.error_message = e.what();
+        complete(call, error_response);
+        return;
+    }
+    
+    // 先登记再发送，响应可能在send返回之前就到达
+    uint64_t id = std::strtoull(request.id.c_str(), nullptr, 10);
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        call.timer = request_timers_.emplace(std::chrono::steady_clock::now() + timeout_, id);
+        pending_requests_[id] = std::move(call);
+    }
+    
+    bool sent = true;
+    if (queued) {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(outgoing_mutex_);
+            was_empty = outgoing_.empty();
+            outgoing_.emplace_back(id, std::move(request_data));
+        }
+        // 队列原本非空时I/O线程已被唤醒，会把这个请求一起发出
+        if (was_empty) {
+            transport_->wakeup();
+        }
+        // I/O线程已经退出时不会再发送或检查超时，由这里结束请求，并撤回入队的数据
+        sent = running_;
+        if (!sent) {
+            std::lock_guard<std::mutex> lock(outgoing_mutex_);
+            auto it = std::find_if(outgoing_.begin(), outgoing_.end(),
+                                   [id](const std::pair<uint64_t, std::string>& frame) { return frame.first == id; });
+            if (it != outgoing_.end()) {
+                outgoing_.erase(it);
+            }
+        }
+    } else if (transport_->send(request_data)) {
+        stats_.bytes_sent += request_data.size();
+    } else {
+        sent = false;
+    }
+    
+    // 发送失败；如果请求已被超时或断开处理，这里不再重复完成
+    PendingCall failed;
+    if (!sent && takePending(id, failed)) {
+        RpcResponse error_response;
+        error_response.id = request.id;
+        error_response.error_code = ErrorCode::NETWORK_ERROR;
+        error_response.error_message = "Failed to send request";
+        complete(failed, error_response);
+    }
+}
+
+bool RpcClient::takePending(uint64_t id, PendingCall& call) {
+    std::lock_guard<std::mutex> lock(requests_mutex_);
+    auto it = pending_requests_.find(id);
+    if (it == pending_requests_.end()) {
+        return false;
+    }
+    call = std::move(it->second);
+    request_timers_.erase(call.timer);
+    pending_requests_.erase(it);
+    return true;
+}
+
+void RpcClient::responseHandler() {
+    const auto max_wait = std::chrono::milliseconds(100);
+    
+    while (running_) {
+        flushOutgoing();
         
-        // 序列化请求
-        std::string request_data = serializer_->serialize(request);
+        // 最多等到最近的请求超时时间点，到点后检查超时；有新请求入队时被提前唤醒
+        auto wait = max_wait;
+        {
+            std::lock_guard<std::mutex> lock(requests_mutex_);
+            if (!request_timers_.empty()) {
+                auto until = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    request_timers_.begin()->first - std::chrono::steady_clock::now());
+                wait = std::max(std::chrono::milliseconds(0), std::min(wait, until + std::chrono::milliseconds(1)));
+            }
+        }
         
-        // 发送请求
-        if (!transport_->send(request_data)) {
-            stats_.failed_requests++;
+        if (transport_->waitReadable(wait)) {
+            std::string response_data = transport_->receive();
+            if (!response_data.empty()) {
+                handleResponse(response_data);
+            } else if (!transport_->isConnected()) {
+                break;
+            }
+        }
+        expireRequests();
+    }
+    
+    // 连接断开：所有未完成的请求都不会再有响应
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(outgoing_mutex_);
+        outgoing_.clear();
+    }
+    failPendingRequests(ErrorCode::NETWORK_ERROR, "Connection closed");
+}
+
+void RpcClient::flushOutgoing() {
+    std::vector<std::pair<uint64_t, std::string>> batch;
+    {
+        std::lock_guard<std::mutex> lock(outgoing_mutex_);
+        if (outgoing_.empty()) {
+            return;
+        }
+        batch.swap(outgoing_);
+    }
+    
+    std::vector<std::string> frames;
+    frames.reserve(batch.size());
+    size_t bytes = 0;
+    for (auto& item : batch) {
+        bytes += item.second.size();
+        frames.push_back(std::move(item.second));
+    }
+    
+    if (transport_->sendFrames(frames)) {
+        stats_.bytes_sent += bytes;
+        return;
+    }
+    
+    for (const auto& item : batch) {
+        PendingCall failed;
+        if (takePending(item.first, failed)) {
             RpcResponse error_response;
+            error_response.id = std::to_string(item.first);
             error_response.error_code = ErrorCode::NETWORK_ERROR;
             error_response.error_message = "Failed to send request";
-            return error_response;
+            complete(failed, error_response);
         }
-        
-        // 接收响应
-        std::string response_data = transport_->receive();
-        if (response_data.empty()) {
-            stats_.timeout_requests++;
-            RpcResponse error_response;
-            error_response.error_code = ErrorCode::TIMEOUT;
-            error_response.error_message = "Request timeout";
-            return error_response;
+    }
+}
+
+void RpcClient::handleResponse(const std::string& response_data) {
+    stats_.bytes_received += response_data.size();
+    
+    RpcResponse response;
+    if (!serializer_->deserialize(response_data, response)) {
+        stats_.failed_requests++;
+        return;
+    }
+    
+    // 不认识的ID是已经超时的请求的迟到响应，直接丢弃
+    PendingCall call;
+    if (takePending(std::strtoull(response.id.c_str(), nullptr, 10), call)) {
+        complete(call, response);
+    }
+}
+
+void RpcClient::expireRequests() {
+    std::vector<std::pair<uint64_t, PendingCall>> expired;
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        while (!request_timers_.empty() && request_timers_.begin()->first <= now) {
+            uint64_t id = request_timers_.begin()->second;
+            request_timers_.erase(request_timers_.begin());
+            auto it = pending_requests_.find(id);
+            if (it != pending_requests_.end()) {
+                expired.emplace_back(id, std::move(it->second));
+                pending_requests_.erase(it);
+            }
         }
-        
-        // 反序列化响应
-        RpcResponse response;
-        if (!serializer_->deserialize(response_data, response)) {
-            stats_.failed_requests++;
-            RpcResponse error_response;
-            error_response.error_code = ErrorCode::SERIALIZATION_ERROR;
-            error_response.error_message = "Failed to deserialize response";
-            return error_response;
+    }
+    
+    for (auto& item : expired) {
+        RpcResponse error_response;
+        error_response.id = std::to_string(item.first);
+        error_response.error_code = ErrorCode::TIMEOUT;
+        error_response.error_message = "Request timeout";
+        complete(item.second, error_response);
+    }
+}
+
+void RpcClient::failPendingRequests(ErrorCode code, const std::string& message) {
+    std::unordered_map<uint64_t, PendingCall> pending;
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        pending.swap(pending_requests_);
+        request_timers_.clear();
+    }
+    
+    for (auto& item : pending) {
+        RpcResponse error_response;
+        error_response.id = std::to_string(item.first);
+        error_response.error_code = code;
+        error_response.error_message = message;
+        complete(item.second, error_response);
+    }
+}
+
+void RpcClient::complete(PendingCall& call, const RpcResponse& response) {
+    if (response.isSuccess()) {
+        stats_.successful_requests++;
+    } else if (response.error_code == ErrorCode::TIMEOUT) {
+        stats_.timeout_requests++;
+    } else {
+        stats_.failed_requests++;
+    }
+    
+    if (!call.callback) {
+        return;
+    }
+    
+    auto run = [](const AsyncCallback& callback, const RpcResponse& result) {
+        try {
+            callback(result);
+        } catch (const std::exception& e) {
+            std::cerr << "异步回调异常: " << e.what() << std::endl;
         }
-        
-        if (response.isSuccess()) {
-            stats_.successful_requests++;
-        } else {
-            stats_.failed_requests++;
+    };
+    
+    // 执行器拒绝任务（例如线程池队列已满）时在当前线程执行，保证回调一定被调用
+    if (call.use_executor && callback_executor_) {
+        try {
+            if (callback_executor_([run, callback = call.callback, response]() {
+                    run(callback, response);
+                })) {
+                return;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "回调执行器异常: " << e.what() << std::endl;
         }
-        
-        return response;
-        
-    } catch (const std::exception& e) {
-        stats_.failed_requests++;
-        RpcResponse error_response;
-        error_response.error_code = ErrorCode::INTERNAL_ERROR;
-        error_response.error_message = e.what();
-        return error_response;
     }
+    run(call.callback, response);
 }
 
 void RpcClient::callAsync(const std::string& method, const std::vector<AnyValue>& params, AsyncCallback callback) {
-    // 在新线程中执行异步调用
-    std::thread([this, method, params, callback]() {
-        RpcResponse response = call(method, params);
-        if (callback) {
-            callback(response);
-        }
-    }).detach();
+    RpcRequest request(method);
+    request.params = params;
+    request.call_type = CallType::ASYNC;
+    startCall(request, std::move(callback), true, true);
 }
 
 std::future<RpcResponse> RpcClient::callAsync(const std::string& method, const std::vector<AnyValue>& params) {
-    // 创建promise/future对
     auto promise = std::make_shared<std::promise<RpcResponse>>();
     auto future = promise->get_future();
     
-    // 在新线程中执行异步调用
-    std::thread([this, method, params, promise]() {
-        try {
-            RpcResponse response = call(method, params);
-            promise->set_value(response);
-        } catch (const std::exception& e) {
-            RpcResponse error_response;
-            error_response.error_code = ErrorCode::INTERNAL_ERROR;
-            error_response.error_message = e.what();
-            promise->set_value(error_response);
-        }
-    }).detach();
+    RpcRequest request(method);
+    request.params = params;
+    request.call_type = CallType::ASYNC;
+    startCall(request, [promise](const RpcResponse& response) {
+        promise->set_value(response);
+    }, true, false);
     
     return future;
 }
 
+void RpcClient::setCallbackExecutor(CallbackExecutor executor) {
+    callback_executor_ = std::move(executor);
+}
+
 bool RpcClient::callOneWay(const std::string& method, const std::vector<AnyValue>& params) {
     if (!isConnected()) {
         stats_.failed_requests++;
@@ -208,9 +469,8 @@ void RpcClient::resetStatistics() {
 }
 
 std::string RpcClient::generateRequestId() {
-    std::ostringstream oss;
-    oss << "req_" << ++next_request_id_ << "_" << std::chrono::steady_clock::now().time_since_epoch().count();
-    return oss.str();
+    // 纯数字ID，响应线程按数值查找未完成的请求
+    return std::to_string(++next_request_id_);
 }
 
 } // namespace rpc
\ No newline at end of file
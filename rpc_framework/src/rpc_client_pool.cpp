@@ -0,0 +1,373 @@
+#include "../include/rpc_client.h"
+#include <iostream>
+#include <algorithm>
+
+namespace rpc {
+
+RpcClientPool::RpcClientPool(const ServiceEndpoint& endpoint, size_t pool_size,
+                             ProtocolType protocol, SerializationType serialization)
+    : endpoint_(endpoint), protocol_(protocol), serialization_(serialization),
+      max_pool_size_(std::max<size_t>(pool_size, 1)), min_pool_size_(0),
+      acquire_timeout_(std::chrono::milliseconds(1000)),
+      idle_timeout_(std::chrono::milliseconds(60000)),
+      health_check_interval_(std::chrono::milliseconds(5000)),
+      client_timeout_(std::chrono::milliseconds(5000)),
+      pending_clients_(0), waiting_callers_(0),
+      created_clients_(0), closed_clients_(0), acquire_timeouts_(0),
+      stopped_(false), health_running_(false) {
+}
+
+RpcClientPool::~RpcClientPool() {
+    shutdown();
+}
+
+bool RpcClientPool::start() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (health_running_) {
+            return true;
+        }
+        stopped_ = false;
+        health_running_ = true;
+    }
+
+    bool filled = fillToMinimum();
+    health_thread_ = std::thread(&RpcClientPool::healthCheckLoop, this);
+    return filled;
+}
+
+void RpcClientPool::shutdown() {
+    std::vector<IdleClient> closed;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        stopped_ = true;
+        health_running_ = false;
+        closed_clients_ += available_clients_.size();
+        closed.swap(available_clients_);
+    }
+    pool_condition_.notify_all();
+    health_condition_.notify_all();
+    if (health_thread_.joinable()) {
+        health_thread_.join();
+    }
+
+    // 借出中的客户端在归还时关闭
+    for (auto& idle : closed) {
+        idle.client->disconnect();
+    }
+}
+
+RpcClientPool::Lease RpcClientPool::acquire() {
+    std::chrono::milliseconds wait;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        wait = acquire_timeout_;
+    }
+    return acquire(wait);
+}
+
+RpcClientPool::Lease RpcClientPool::acquire(std::chrono::milliseconds wait) {
+    auto client = acquireClient(wait);
+    return client ? Lease(this, std::move(client)) : Lease();
+}
+
+std::shared_ptr<RpcClient> RpcClientPool::getClient() {
+    std::chrono::milliseconds wait;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        wait = acquire_timeout_;
+    }
+    return acquireClient(wait);
+}
+
+std::shared_ptr<RpcClient> RpcClientPool::acquireClient(std::chrono::milliseconds wait) {
+    auto deadline = std::chrono::steady_clock::now() + wait;
+    // 已断开的客户端在释放锁之后才析构（析构时要等待其I/O线程退出）
+    std::vector<std::shared_ptr<RpcClient>> closed;
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+
+    while (true) {
+        if (stopped_) {
+            return nullptr;
+        }
+
+        // 优先复用最近归还的客户端
+        while (!available_clients_.empty()) {
+            std::shared_ptr<RpcClient> client = std::move(available_clients_.back().client);
+            available_clients_.pop_back();
+            if (client->isConnected()) {
+                busy_clients_.push_back(client);
+                return client;
+            }
+            closed_clients_++;
+            closed.push_back(std::move(client));
+        }
+
+        // 未达上限时新建连接，连接期间占用一个名额，不持有锁
+        if (totalClients() < max_pool_size_) {
+            pending_clients_++;
+            lock.unlock();
+            std::shared_ptr<RpcClient> client = createClient();
+            lock.lock();
+            pending_clients_--;
+
+            if (client && !stopped_) {
+                created_clients_++;
+                busy_clients_.push_back(client);
+                return client;
+            }
+            // 名额空出来了，让其他等待者重试
+            pool_condition_.notify_one();
+            if (client) {
+                created_clients_++;
+                closed_clients_++;
+                closed.push_back(std::move(client));
+            }
+            return nullptr;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            acquire_timeouts_++;
+            return nullptr;
+        }
+        waiting_callers_++;
+        pool_condition_.wait_until(lock, deadline);
+        waiting_callers_--;
+    }
+}
+
+void RpcClientPool::releaseClient(std::shared_ptr<RpcClient> client) {
+    if (!client) {
+        return;
+    }
+
+    bool keep = false;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        auto it = std::find(busy_clients_.begin(), busy_clients_.end(), client);
+        if (it == busy_clients_.end()) {
+            return;
+        }
+        busy_clients_.erase(it);
+
+        // 池已关闭、连接已断开或池已缩小时不再放回
+        keep = !stopped_ && client->isConnected() && totalClients() < max_pool_size_;
+        if (keep) {
+            available_clients_.push_back(IdleClient{client, std::chrono::steady_clock::now()});
+        } else {
+            closed_clients_++;
+        }
+    }
+    // 归还或关闭都会空出一个名额
+    pool_condition_.notify_one();
+
+    if (!keep) {
+        client->disconnect();
+    }
+}
+
+void RpcClientPool::setPoolSize(size_t size) {
+    std::vector<IdleClient> closed;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        max_pool_size_ = std::max<size_t>(size, 1);
+
+        // 先关闭最久未用的空闲连接，借出中的连接归还时再关闭
+        size_t total = totalClients();
+        size_t excess = total > max_pool_size_ ? total - max_pool_size_ : 0;
+        excess = std::min(excess, available_clients_.size());
+        closed.assign(std::make_move_iterator(available_clients_.begin()),
+                      std::make_move_iterator(available_clients_.begin() + excess));
+        available_clients_.erase(available_clients_.begin(), available_clients_.begin() + excess);
+        closed_clients_ += excess;
+    }
+    // 池扩大后等待者可以新建连接
+    pool_condition_.notify_all();
+
+    for (auto& idle : closed) {
+        idle.client->disconnect();
+    }
+}
+
+void RpcClientPool::setMinPoolSize(size_t size) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    min_pool_size_ = size;
+}
+
+void RpcClientPool::setAcquireTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    acquire_timeout_ = timeout;
+}
+
+void RpcClientPool::setIdleTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    idle_timeout_ = timeout;
+}
+
+void RpcClientPool::setHealthCheckInterval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    health_check_interval_ = interval;
+}
+
+void RpcClientPool::setHealthCheckMethod(const std::string& method) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    health_check_method_ = method;
+}
+
+void RpcClientPool::setClientTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    client_timeout_ = timeout;
+}
+
+RpcClientPool::PoolStatus RpcClientPool::getStatus() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    PoolStatus status;
+    status.total_clients = totalClients();
+    status.available_clients = available_clients_.size();
+    status.busy_clients = busy_clients_.size();
+    status.waiting_callers = waiting_callers_;
+    status.created_clients = created_clients_;
+    status.closed_clients = closed_clients_;
+    status.acquire_timeouts = acquire_timeouts_;
+    return status;
+}
+
+std::shared_ptr<RpcClient> RpcClientPool::createClient() {
+    std::chrono::milliseconds timeout;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        timeout = client_timeout_;
+    }
+
+    auto client = std::make_shared<RpcClient>(protocol_, serialization_);
+    client->setTimeout(timeout);
+    if (!client->connect(endpoint_)) {
+        std::cerr << "连接池无法连接到 " << endpoint_.toString() << std::endl;
+        return nullptr;
+    }
+    return client;
+}
+
+size_t RpcClientPool::totalClients() const {
+    return available_clients_.size() + busy_clients_.size() + pending_clients_;
+}
+
+bool RpcClientPool::probe(RpcClient& client) {
+    if (!client.isConnected()) {
+        return false;
+    }
+
+    std::string method;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        method = health_check_method_;
+    }
+    if (method.empty()) {
+        return true;
+    }
+
+    // 方法不存在或执行出错也说明连接和服务器正常
+    RpcResponse response = client.call(method);
+    return response.error_code != ErrorCode::NETWORK_ERROR && response.error_code != ErrorCode::TIMEOUT;
+}
+
+void RpcClientPool::healthCheckLoop() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    while (health_running_) {
+        health_condition_.wait_for(lock, health_check_interval_, [this]() { return !health_running_; });
+        if (!health_running_) {
+            break;
+        }
+
+        lock.unlock();
+        checkIdleClients();
+        fillToMinimum();
+        lock.lock();
+    }
+}
+
+void RpcClientPool::checkIdleClients() {
+    std::vector<std::shared_ptr<RpcClient>> closed;
+    std::vector<std::shared_ptr<RpcClient>> idle;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        auto now = std::chrono::steady_clock::now();
+
+        // 空闲最久的在前面，多于最小数量时关闭其中空闲超时的
+        size_t total = totalClients();
+        size_t expired = 0;
+        while (expired < available_clients_.size() && total > min_pool_size_ &&
+               now - available_clients_[expired].idle_since >= idle_timeout_) {
+            closed.push_back(std::move(available_clients_[expired].client));
+            ++expired;
+            --total;
+        }
+        available_clients_.erase(available_clients_.begin(), available_clients_.begin() + expired);
+        closed_clients_ += expired;
+
+        for (const auto& entry : available_clients_) {
+            idle.push_back(entry.client);
+        }
+    }
+
+    for (auto& client : closed) {
+        client->disconnect();
+    }
+
+    // 检查时不从池中取出，客户端可以同时被借出（一个连接上可以有多个并发调用）；
+    // 检查失败的客户端如果已被借出，断开后由归还时丢弃
+    for (auto& client : idle) {
+        if (probe(*client)) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            auto it = std::find_if(available_clients_.begin(), available_clients_.end(),
+                                   [&client](const IdleClient& entry) { return entry.client == client; });
+            if (it != available_clients_.end()) {
+                available_clients_.erase(it);
+                closed_clients_++;
+            }
+        }
+        pool_condition_.notify_one();
+        client->disconnect();
+    }
+}
+
+bool RpcClientPool::fillToMinimum() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            if (stopped_ || totalClients() >= std::min(min_pool_size_, max_pool_size_)) {
+                return true;
+            }
+            pending_clients_++;
+        }
+
+        std::shared_ptr<RpcClient> client = createClient();
+        bool keep = false;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            pending_clients_--;
+            if (client) {
+                created_clients_++;
+                keep = !stopped_;
+                if (keep) {
+                    available_clients_.push_back(IdleClient{client, std::chrono::steady_clock::now()});
+                } else {
+                    closed_clients_++;
+                }
+            }
+        }
+        pool_condition_.notify_one();
+
+        if (!client) {
+            return false;
+        }
+        if (!keep) {
+            client->disconnect();
+        }
+    }
+}
+
+} // namespace rpc
@@ -2,28 +2,46 @@
 #include "../include/transport.h"
 #include "../include/serializer.h"
 #include <iostream>
+#include <algorithm>
 
 namespace rpc {
 
+namespace {
+
+// 方法表版本号在所有RpcServer之间全局递增，线程缓存的快照不会被误认为另一个服务器的
+std::atomic<uint64_t> g_dispatch_version{0};
+
+// 内置方法：按方法名查询方法ID
+const char* const kResolveMethod = "rpc.resolve";
+
+} // namespace
+
 RpcServer::RpcServer(ProtocolType protocol, SerializationType serialization)
-    : current_endpoint_("", 0), running_(false), thread_pool_size_(4), max_queue_size_(1000) {
+    : current_endpoint_("", 0), dispatch_version_(0), running_(false),
+      thread_pool_size_(4), max_queue_size_(1000) {
+    
+    // 空方法表，ID 0保留
+    auto table = std::make_shared<DispatchTable>();
+    table->by_id.push_back(nullptr);
+    publishDispatchTable(table);
     
     // 创建传输层
     switch (protocol) {
         case ProtocolType::TCP:
+#ifdef __linux__
+            transport_ = std::make_unique<EpollServerTransport>();
+#else
             transport_ = std::make_unique<TcpServerTransport>();
+#endif
             break;
         default:
             throw std::runtime_error("Unsupported protocol type");
     }
     
     // 创建序列化器
-    switch (serialization) {
-        case SerializationType::JSON:
-            serializer_ = std::make_unique<JsonSerializer>();
-            break;
-        default:
-            throw std::runtime_error("Unsupported serialization type");
+    serializer_ = SerializerFactory::create(serialization);
+    if (!serializer_) {
+        throw std::runtime_error("Unsupported serialization type");
     }
 }
 
@@ -38,15 +56,14 @@ bool RpcServer::start(const ServiceEndpoint& endpoint) {
     
     current_endpoint_ = endpoint;
     
-    // 启动传输层
-    if (!transport_->start(endpoint)) {
-        return false;
-    }
-    
-    // 设置消息处理器
+    // 设置消息处理器：支持异步处理的传输层把完整请求投递到工作线程池，
+    // 否则在传输层的线程上同步处理
     transport_->setMessageHandler([this](const std::string& request) {
         return handleRequest(request);
     });
+    transport_->setAsyncMessageHandler([this](std::string request, MessageReply reply) {
+        enqueueRequest(std::move(request), std::move(reply));
+    });
     
     running_ = true;
     
@@ -55,6 +72,12 @@ bool RpcServer::start(const ServiceEndpoint& endpoint) {
         worker_threads_.emplace_back(&RpcServer::workerThread, this);
     }
     
+    // 启动传输层
+    if (!transport_->start(endpoint)) {
+        stopWorkers();
+        return false;
+    }
+    
     std::cout << "RPC服务器启动在 " << endpoint.toString() << std::endl;
     return true;
 }
@@ -64,20 +87,8 @@ void RpcServer::stop() {
         return;
     }
     
-    running_ = false;
-    
-    // 通知所有工作线程退出
-    queue_condition_.notify_all();
-    
-    // 等待工作线程结束
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
-    }
-    worker_threads_.clear();
-    
-    // 停止传输层
+    // 先停工作线程（正在执行的请求仍能发出响应），再停传输层
+    stopWorkers();
     transport_->stop();
     
     std::cout << "RPC服务器已停止" << std::endl;
@@ -87,20 +98,78 @@ bool RpcServer::isRunning() const {
     return running_;
 }
 
-void RpcServer::registerMethod(const std::string& method_name, MethodHandler handler) {
-    std::lock_guard<std::mutex> lock(methods_mutex_);
-    methods_[method_name] = handler;
+uint32_t RpcServer::registerMethod(const std::string& method_name, MethodHandler handler) {
+    return updateMethod(method_name, std::move(handler), nullptr);
 }
 
-void RpcServer::registerMethod(const std::string& method_name, AdvancedMethodHandler handler) {
-    std::lock_guard<std::mutex> lock(methods_mutex_);
-    advanced_methods_[method_name] = handler;
+uint32_t RpcServer::registerMethod(const std::string& method_name, AdvancedMethodHandler handler) {
+    return updateMethod(method_name, nullptr, std::move(handler));
 }
 
 void RpcServer::unregisterMethod(const std::string& method_name) {
     std::lock_guard<std::mutex> lock(methods_mutex_);
-    methods_.erase(method_name);
-    advanced_methods_.erase(method_name);
+    auto current = std::atomic_load(&dispatch_table_);
+    auto it = current->by_name.find(method_name);
+    if (it == current->by_name.end()) {
+        return;
+    }
+    
+    auto table = std::make_shared<DispatchTable>(*current);
+    table->by_id[it->second->id].reset();
+    table->by_name.erase(method_name);
+    publishDispatchTable(table);
+}
+
+uint32_t RpcServer::getMethodId(const std::string& method_name) const {
+    auto table = loadDispatchTable();
+    auto it = table->by_name.find(method_name);
+    return it != table->by_name.end() ? it->second->id : 0;
+}
+
+uint32_t RpcServer::updateMethod(const std::string& method_name, MethodHandler handler,
+                                 AdvancedMethodHandler advanced_handler) {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto table = std::make_shared<DispatchTable>(*std::atomic_load(&dispatch_table_));
+    
+    auto entry = std::make_shared<MethodEntry>();
+    auto it = table->by_name.find(method_name);
+    if (it != table->by_name.end()) {
+        *entry = *it->second;
+    } else {
+        entry->id = static_cast<uint32_t>(table->by_id.size());
+        entry->name = method_name;
+        table->by_id.push_back(nullptr);
+    }
+    if (handler) {
+        entry->handler = std::move(handler);
+    }
+    if (advanced_handler) {
+        entry->advanced_handler = std::move(advanced_handler);
+    }
+    
+    table->by_name[method_name] = entry;
+    table->by_id[entry->id] = entry;
+    publishDispatchTable(table);
+    return entry->id;
+}
+
+void RpcServer::publishDispatchTable(std::shared_ptr<DispatchTable> table) {
+    table->version = ++g_dispatch_version;
+    uint64_t version = table->version;
+    std::atomic_store(&dispatch_table_, std::shared_ptr<const DispatchTable>(std::move(table)));
+    // 先发布快照再发布版本号，看到新版本号的线程一定能读到新快照
+    dispatch_version_.store(version, std::memory_order_release);
+}
+
+std::shared_ptr<const RpcServer::DispatchTable> RpcServer::loadDispatchTable() const {
+    // std::atomic_load(shared_ptr)在libstdc++中要经过一个全局锁池，
+    // 因此每个线程缓存最近一次的快照，版本号没变时直接使用
+    thread_local std::shared_ptr<const DispatchTable> cached;
+    uint64_t version = dispatch_version_.load(std::memory_order_acquire);
+    if (!cached || cached->version != version) {
+        cached = std::atomic_load(&dispatch_table_);
+    }
+    return cached;
 }
 
 void RpcServer::addMiddleware(Middleware middleware) {
@@ -116,6 +185,16 @@ void RpcServer::setRequestQueueSize(size_t size) {
     max_queue_size_ = size;
 }
 
+void RpcServer::setIoThreadCount(size_t count) {
+#ifdef __linux__
+    if (auto epoll_transport = dynamic_cast<EpollServerTransport*>(transport_.get())) {
+        epoll_transport->setIoThreadCount(count);
+    }
+#else
+    (void)count;
+#endif
+}
+
 void RpcServer::setErrorHandler(std::function<void(const std::string&, ErrorCode)> handler) {
     error_handler_ = handler;
 }
@@ -130,11 +209,64 @@ void RpcServer::resetStatistics() {
     stats_.avg_response_time_ms = 0;
 }
 
+void RpcServer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_condition_.notify_all();
+    
+    for (auto& thread : worker_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    worker_threads_.clear();
+    
+    // 停止时丢弃还在排队的请求
+    std::queue<std::function<void()>> empty;
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    task_queue_.swap(empty);
+}
+
+void RpcServer::enqueueRequest(std::string request_data, MessageReply reply) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (running_ && task_queue_.size() < max_queue_size_) {
+            task_queue_.push([this, request_data = std::move(request_data), reply = std::move(reply)]() {
+                reply(handleRequest(request_data));
+            });
+            queue_condition_.notify_one();
+            return;
+        }
+    }
+    
+    // 队列已满：直接返回错误，响应中带上请求ID以便客户端匹配
+    stats_.total_requests++;
+    stats_.failed_requests++;
+    RpcRequest request;
+    RpcResponse error_response;
+    if (serializer_->deserialize(request_data, request)) {
+        error_response.id = request.id;
+    }
+    error_response.error_code = ErrorCode::INTERNAL_ERROR;
+    error_response.error_message = "Server busy: request queue full";
+    reply(serializer_->serialize(error_response));
+}
+
 void RpcServer::workerThread() {
-    while (running_) {
-        // 简化的工作线程实现
-        // 实际实现中需要从传输层接收请求并处理
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_condition_.wait(lock, [this] { return !running_ || !task_queue_.empty(); });
+            if (!running_) {
+                return;
+            }
+            task = std::move(task_queue_.front());
+            task_queue_.pop();
+        }
+        task();
     }
 }
 
@@ -177,38 +309,41 @@ std::string RpcServer::handleRequest(const std::string& request_data) {
     }
 }
 
-RpcResponse RpcServer::processRequest(const RpcRequest& request, const CallContext& /* context */) {
+RpcResponse RpcServer::processRequest(const RpcRequest& request, const CallContext& context) {
     RpcResponse response;
     response.id = request.id;
     
-    std::lock_guard<std::mutex> lock(methods_mutex_);
+    // 持有快照直到处理器返回，期间取消注册不会销毁正在执行的处理器
+    std::shared_ptr<const DispatchTable> table = loadDispatchTable();
     
-    // 首先检查高级方法处理器
-    auto advanced_it = advanced_methods_.find(request.method);
-    if (advanced_it != advanced_methods_.end()) {
-        try {
-            CallContext ctx;
-            ctx.request_id = request.id;
-            ctx.start_time = std::chrono::steady_clock::now();
-            response.result = advanced_it->second(request.params, ctx);
-            response.error_code = ErrorCode::SUCCESS;
-        } catch (const std::exception& e) {
-            response.error_code = ErrorCode::INTERNAL_ERROR;
-            response.error_message = e.what();
+    const MethodEntry* entry = nullptr;
+    if (request.method_id != 0) {
+        if (request.method_id < table->by_id.size()) {
+            entry = table->by_id[request.method_id].get();
+        }
+    } else {
+        auto it = table->by_name.find(request.method);
+        if (it != table->by_name.end()) {
+            entry = it->second.get();
+        } else if (request.method == kResolveMethod) {
+            return resolveMethod(request, *table);
         }
-        return response;
     }
     
-    // 检查普通方法处理器
-    auto it = methods_.find(request.method);
-    if (it == methods_.end()) {
+    if (!entry) {
         response.error_code = ErrorCode::METHOD_NOT_FOUND;
-        response.error_message = "Method not found: " + request.method;
+        response.error_message = request.method_id != 0
+            ? "Method not found: #" + std::to_string(request.method_id)
+            : "Method not found: " + request.method;
         return response;
     }
     
     try {
-        response.result = it->second(request.params);
+        if (entry->advanced_handler) {
+            response.result = entry->advanced_handler(request.params, context);
+        } else {
+            response.result = entry->handler(request.params);
+        }
         response.error_code = ErrorCode::SUCCESS;
     } catch (const std::exception& e) {
         response.error_code = ErrorCode::INTERNAL_ERROR;
@@ -218,6 +353,37 @@ RpcResponse RpcServer::processRequest(const RpcRequest& request, const CallConte
     return response;
 }
 
+RpcResponse RpcServer::resolveMethod(const RpcRequest& request, const DispatchTable& table) {
+    RpcResponse response;
+    response.id = request.id;
+    
+    if (request.params.size() != 1) {
+        response.error_code = ErrorCode::INVALID_PARAMS;
+        response.error_message = "rpc.resolve expects 1 parameter";
+        return response;
+    }
+    
+    try {
+        #if HAS_STD_ANY
+        std::string name = std::any_cast<std::string>(request.params[0]);
+        #else
+        std::string name = request.params[0].cast<std::string>();
+        #endif
+        auto it = table.by_name.find(name);
+        if (it == table.by_name.end()) {
+            response.error_code = ErrorCode::METHOD_NOT_FOUND;
+            response.error_message = "Method not found: " + name;
+            return response;
+        }
+        response.result = AnyValue(static_cast<int>(it->second->id));
+        response.error_code = ErrorCode::SUCCESS;
+    } catch (const std::exception& e) {
+        response.error_code = ErrorCode::INVALID_PARAMS;
+        response.error_message = e.what();
+    }
+    return response;
+}
+
 bool RpcServer::runMiddlewares(const RpcRequest& request, RpcResponse& response, const CallContext& context) {
     std::lock_guard<std::mutex> lock(middlewares_mutex_);
     for (auto& middleware : middlewares_) {
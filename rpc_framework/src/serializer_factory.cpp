@@ -0,0 +1,46 @@
+#include "../include/serializer.h"
+
+namespace rpc {
+
+std::unique_ptr<Serializer> SerializerFactory::create(SerializationType type) {
+    switch (type) {
+        case SerializationType::JSON:
+            return std::make_unique<JsonSerializer>();
+        case SerializationType::BINARY:
+            return std::make_unique<BinarySerializer>();
+        case SerializationType::MESSAGEPACK:
+            return std::make_unique<MessagePackSerializer>();
+        default:
+            return nullptr;
+    }
+}
+
+std::vector<SerializationType> SerializerFactory::getSupportedTypes() {
+    return {SerializationType::JSON, SerializationType::BINARY, SerializationType::MESSAGEPACK};
+}
+
+bool SerializerFactory::isSupported(SerializationType type) {
+    for (SerializationType supported : getSupportedTypes()) {
+        if (supported == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SerializationType SerializerFactory::fromContentType(const std::string& content_type) {
+    // 忽略"; charset=..."之类的参数
+    std::string mime = content_type.substr(0, content_type.find(';'));
+    if (mime == "application/octet-stream") {
+        return SerializationType::BINARY;
+    }
+    if (mime == "application/msgpack" || mime == "application/x-msgpack") {
+        return SerializationType::MESSAGEPACK;
+    }
+    if (mime == "application/x-protobuf" || mime == "application/protobuf") {
+        return SerializationType::PROTOBUF;
+    }
+    return SerializationType::JSON;
+}
+
+} // namespace rpc
@@ -1,6 +1,7 @@
 #include "../include/transport.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -13,10 +14,21 @@ namespace rpc {
 
 // TCP客户端传输实现
 TcpTransport::TcpTransport() 
-    : socket_fd_(-1), connected_(false), timeout_(5000) {}
+    : socket_fd_(-1), connected_(false), timeout_(5000) {
+    wakeup_fds_[0] = wakeup_fds_[1] = -1;
+    if (pipe(wakeup_fds_) == 0) {
+        setSocketNonBlocking(wakeup_fds_[0]);
+        setSocketNonBlocking(wakeup_fds_[1]);
+    }
+}
 
 TcpTransport::~TcpTransport() {
     disconnect();
+    for (int fd : wakeup_fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
 }
 
 bool TcpTransport::connect(const ServiceEndpoint& endpoint) {
@@ -60,6 +72,10 @@ bool TcpTransport::connect(const ServiceEndpoint& endpoint) {
         return false;
     }
     
+    // 请求-响应都是小帧，关闭Nagle算法
+    int nodelay = 1;
+    setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    
     // 连接到服务器
     int result = ::connect(socket_fd_, (struct sockaddr*)&server_addr, sizeof(server_addr));
     if (result == 0) {
@@ -98,6 +114,10 @@ void TcpTransport::disconnect() {
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (socket_fd_ >= 0) {
+        // 先shutdown唤醒阻塞在poll上的收发线程，等它们退出后再关闭fd
+        shutdown(socket_fd_, SHUT_RDWR);
+        std::lock_guard<std::mutex> send_lock(send_mutex_);
+        std::lock_guard<std::mutex> receive_lock(receive_mutex_);
         close(socket_fd_);
         socket_fd_ = -1;
     }
@@ -110,37 +130,70 @@ void TcpTransport::disconnect() {
 }
 
 bool TcpTransport::isConnected() const {
-    std::lock_guard<std::mutex> lock(mutex_);
     return connected_;
 }
 
 bool TcpTransport::send(const std::string& data) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(send_mutex_);
     
     if (!connected_ || socket_fd_ < 0) {
         return false;
     }
     
-    // 发送数据长度（4字节网络字节序）
+    // 长度（4字节网络字节序）和内容拼成一帧一次发送，
+    // 分两次发送时小帧会被Nagle算法和对端的延迟确认卡住几十毫秒
     uint32_t length = htonl(static_cast<uint32_t>(data.length()));
-    if (!sendAll(reinterpret_cast<const char*>(&length), sizeof(length))) {
+    std::string frame(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame += data;
+    if (!sendAll(frame.data(), frame.size())) {
+        connected_ = false;  // 可能只写出了半帧，连接不能再用
+        return false;
+    }
+    return true;
+}
+
+bool TcpTransport::sendFrames(const std::vector<std::string>& frames) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    
+    if (!connected_ || socket_fd_ < 0) {
         return false;
     }
     
-    // 发送数据内容
-    return sendAll(data.c_str(), data.length());
+    // 所有帧拼进一个缓冲区，一次系统调用写出
+    size_t total = 0;
+    for (const auto& data : frames) {
+        total += sizeof(uint32_t) + data.size();
+    }
+    std::string buffer;
+    buffer.reserve(total);
+    for (const auto& data : frames) {
+        uint32_t length = htonl(static_cast<uint32_t>(data.length()));
+        buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        buffer += data;
+    }
+    if (!sendAll(buffer.data(), buffer.size())) {
+        connected_ = false;
+        return false;
+    }
+    return true;
 }
 
 std::string TcpTransport::receive() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(receive_mutex_);
     
     if (!connected_ || socket_fd_ < 0) {
         return "";
     }
     
+    // 超时时间内没有新帧：返回空字符串，连接保持
+    if (!waitForSocket(socket_fd_, true, timeout_)) {
+        return "";
+    }
+    
     // 接收数据长度
     uint32_t length;
     if (!receiveAll(reinterpret_cast<char*>(&length), sizeof(length))) {
+        connected_ = false;
         return "";
     }
     length = ntohl(length);
@@ -148,12 +201,47 @@ std::string TcpTransport::receive() {
     // 接收数据内容
     std::string data(length, '\0');
     if (!receiveAll(&data[0], length)) {
+        connected_ = false;
         return "";
     }
     
     return data;
 }
 
+bool TcpTransport::waitReadable(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    if (!connected_ || socket_fd_ < 0) {
+        return true;  // 让调用者通过receive()发现连接已断开
+    }
+    
+    struct pollfd pfds[2];
+    pfds[0].fd = socket_fd_;
+    pfds[0].events = POLLIN;
+    pfds[0].revents = 0;
+    pfds[1].fd = wakeup_fds_[0];
+    pfds[1].events = POLLIN;
+    pfds[1].revents = 0;
+    int count = wakeup_fds_[0] >= 0 ? 2 : 1;
+    
+    if (poll(pfds, count, static_cast<int>(timeout.count())) <= 0) {
+        return false;
+    }
+    if (count == 2 && (pfds[1].revents & POLLIN)) {
+        char buffer[64];
+        while (read(wakeup_fds_[0], buffer, sizeof(buffer)) > 0) {
+        }
+    }
+    return (pfds[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+}
+
+void TcpTransport::wakeup() {
+    if (wakeup_fds_[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = write(wakeup_fds_[1], &byte, 1);  // 管道已满说明已有未处理的唤醒
+        (void)ignored;
+    }
+}
+
 void TcpTransport::setTimeout(std::chrono::milliseconds timeout) {
     timeout_ = timeout;
 }
@@ -188,11 +276,11 @@ bool TcpTransport::sendAll(const char* data, size_t length) {
         }
         
         ssize_t result = ::send(socket_fd_, data + sent, length - sent, MSG_NOSIGNAL);
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            continue;
+        }
         if (result <= 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                continue;
-            }
-            return false;
+            return false;  // 0表示对端已关闭，errno可能是之前残留的值
         }
         sent += result;
     }
@@ -207,11 +295,11 @@ bool TcpTransport::receiveAll(char* buffer, size_t length) {
         }
         
         ssize_t result = recv(socket_fd_, buffer + received, length - received, 0);
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            continue;
+        }
         if (result <= 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                continue;
-            }
-            return false;
+            return false;  // 0表示对端已关闭，errno可能是之前残留的值
         }
         received += result;
     }
@@ -289,8 +377,9 @@ void TcpServerTransport::stop() {
     
     running_ = false;
     
-    // 关闭服务器socket
+    // 关闭服务器socket（先shutdown，唤醒阻塞在accept上的线程）
     if (server_fd_ >= 0) {
+        shutdown(server_fd_, SHUT_RDWR);
         close(server_fd_);
         server_fd_ = -1;
     }
@@ -333,6 +422,9 @@ void TcpServerTransport::acceptLoop() {
             break;
         }
         
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        
         // 为每个客户端创建处理线程
         {
             std::lock_guard<std::mutex> lock(workers_mutex_);
@@ -377,14 +469,23 @@ std::string TcpServerTransport::receiveMessage(int fd) {
 }
 
 bool TcpServerTransport::sendMessage(int fd, const std::string& message) {
-    // 发送消息长度
+    // 长度和内容拼成一帧一次发送
     uint32_t length = htonl(static_cast<uint32_t>(message.length()));
-    if (send(fd, &length, sizeof(length), MSG_NOSIGNAL) != sizeof(length)) {
-        return false;
-    }
+    std::string frame(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame += message;
     
-    // 发送消息内容
-    return send(fd, message.c_str(), message.length(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.length());
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t result = send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        sent += result;
+    }
+    return true;
 }
 
 } // namespace rpc 
\ No newline at end of file
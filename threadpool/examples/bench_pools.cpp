@@ -0,0 +1,51 @@
+#include "../include/thread_pool_factory.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace ThreadPool;
+
+// 线程池基准测试矩阵：所有线程池类型 x 所有场景
+// 用法: bench_pools [每个场景的任务数] [JSON输出文件]
+// 不指定输出文件时JSON打印到标准输出末尾
+
+int main(int argc, char* argv[]) {
+    size_t taskCount = 10000;
+    if (argc > 1) {
+        taskCount = static_cast<size_t>(std::strtoul(argv[1], nullptr, 10));
+        if (taskCount == 0) {
+            std::cerr << "任务数必须大于0" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<ThreadPoolFactory::PerformanceMetrics> results = ThreadPoolFactory::benchmark(
+        ThreadPoolFactory::getSupportedTypes(), ThreadPoolFactory::getAllScenarios(),
+        taskCount, std::chrono::milliseconds(30000));
+
+    std::cout << "\n线程池基准测试（每个场景 " << taskCount << " 个任务）" << std::endl;
+    std::cout << "pool                    scenario            tasks/s     p50(ms)     p99(ms)    cpu(%)   ctxsw" << std::endl;
+    for (const auto& m : results) {
+        std::cout << std::left << std::setw(24) << m.poolType << std::setw(16) << m.scenario << std::right
+                  << std::fixed << std::setprecision(0) << std::setw(12) << m.avgThroughput
+                  << std::setprecision(3) << std::setw(12) << m.p50Latency << std::setw(12) << m.p99Latency
+                  << std::setprecision(1) << std::setw(10) << m.cpuUsage
+                  << std::setw(8) << (m.voluntaryContextSwitches + m.involuntaryContextSwitches)
+                  << (m.timedOut ? "  超时" : "") << std::endl;
+    }
+
+    std::string json = ThreadPoolFactory::toJson(results);
+    if (argc > 2) {
+        std::ofstream out(argv[2]);
+        if (!out) {
+            std::cerr << "无法写入 " << argv[2] << std::endl;
+            return 1;
+        }
+        out << json << std::endl;
+        std::cout << "\nJSON结果已写入 " << argv[2] << std::endl;
+    } else {
+        std::cout << "\n" << json << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "../include/fixed_thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace ThreadPool;
+
+// 固定线程池任务队列基准：有锁队列 vs 无锁MPMC队列
+// 多个外部线程提交极短的任务，统计不同线程数下的吞吐量（任务/秒），
+// 再对比逐个submit与submitBulk批量提交
+// 用法: bench_task_queue [每轮任务数] [最大线程数]
+
+namespace {
+
+// batch为0时逐个submit，否则每batch个任务调用一次submitBulk
+double runOnce(TaskQueueType queueType, size_t threads, size_t producers, size_t taskCount,
+               size_t batch = 0) {
+    ThreadPoolConfig config(threads, taskCount);
+    config.queueType = queueType;
+    FixedThreadPool pool(config);
+    pool.setRejectionPolicy(RejectionPolicy::Block);
+    pool.start();
+
+    std::atomic<size_t> done{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> submitters;
+    for (size_t p = 0; p < producers; ++p) {
+        size_t count = taskCount / producers + (p < taskCount % producers ? 1 : 0);
+        submitters.emplace_back([&pool, &done, count, batch]() {
+            if (batch == 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    pool.submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                }
+                return;
+            }
+            std::vector<Task> tasks;
+            tasks.reserve(batch);
+            for (size_t i = 0; i < count; i += batch) {
+                size_t n = std::min(batch, count - i);
+                tasks.clear();
+                for (size_t j = 0; j < n; ++j) {
+                    tasks.emplace_back([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                }
+                pool.submitBulk(tasks.data(), n);
+            }
+        });
+    }
+    for (auto& t : submitters) {
+        t.join();
+    }
+    while (done.load() < taskCount) {
+        std::this_thread::yield();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    pool.shutdown();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return taskCount / seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t taskCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max<size_t>(4, hardware * 2);
+
+    std::vector<std::pair<size_t, std::pair<double, double>>> results;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        size_t producers = std::max<size_t>(1, threads / 2);
+        double locked = runOnce(TaskQueueType::Locked, threads, producers, taskCount);
+        double lockFree = runOnce(TaskQueueType::LockFree, threads, producers, taskCount);
+        results.push_back(std::make_pair(threads, std::make_pair(locked, lockFree)));
+    }
+
+    std::cout << "\n=== 任务队列吞吐量（硬件并发数: " << hardware
+              << "，每轮任务数: " << taskCount << "）===" << std::endl;
+    std::cout << "线程数    有锁(任务/秒)     无锁(任务/秒)     加速比" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(10) << r.first
+                  << std::setw(18) << r.second.first
+                  << std::setw(18) << r.second.second
+                  << std::setprecision(2) << r.second.second / r.second.first
+                  << std::setprecision(0) << std::endl;
+    }
+
+    // 单个生产者，逐个提交 vs 每批256个批量提交
+    const size_t kBatch = 256;
+    size_t threads = std::max<size_t>(2, hardware);
+    std::cout << "\n=== 批量提交（" << threads << " 个工作线程，1 个生产者，每批 " << kBatch << " 个）===" << std::endl;
+    std::cout << "队列      逐个(任务/秒)     批量(任务/秒)     加速比" << std::endl;
+    const TaskQueueType queueTypes[] = {TaskQueueType::Locked, TaskQueueType::LockFree};
+    for (TaskQueueType type : queueTypes) {
+        double single = runOnce(type, threads, 1, taskCount);
+        double bulk = runOnce(type, threads, 1, taskCount, kBatch);
+        std::cout << std::left << std::setw(10) << (type == TaskQueueType::Locked ? "Locked" : "LockFree")
+                  << std::setw(18) << single
+                  << std::setw(18) << bulk
+                  << std::setprecision(2) << bulk / single
+                  << std::setprecision(0) << std::endl;
+    }
+    return 0;
+}
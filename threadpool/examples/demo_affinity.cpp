@@ -0,0 +1,189 @@
+#include "../include/thread_pool_factory.h"
+#include "../include/thread_affinity.h"
+#include "test_util.h"
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace ThreadPool;
+using namespace test_util;
+
+// CPU亲和性演示：CPU拓扑、绑定计划、工作线程名与绑定结果、NUMA优先窃取
+
+namespace {
+
+std::string planToString(const std::vector<int>& plan) {
+    std::string text;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        text += (i == 0 ? "" : " ") + std::to_string(plan[i]);
+    }
+    return text;
+}
+
+// 从/proc/self/task/*/comm读取本进程所有线程的名字
+std::set<std::string> threadNames() {
+    std::set<std::string> names;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        return names;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::ifstream comm(std::string("/proc/self/task/") + entry->d_name + "/comm");
+        std::string name;
+        if (std::getline(comm, name)) {
+            names.insert(name);
+        }
+    }
+    closedir(dir);
+    return names;
+}
+
+// 当前线程只允许在一个CPU上运行时返回该CPU，否则返回-1
+int pinnedCpu() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0 || CPU_COUNT(&set) != 1) {
+        return -1;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+void testPlan() {
+    const CpuTopology& topology = CpuTopology::instance();
+    std::cout << "可用CPU: " << topology.cpus.size() << " 个，NUMA节点: " << topology.nodeCount << " 个" << std::endl;
+    for (size_t i = 0; i < topology.cpus.size() && i < 16; ++i) {
+        std::cout << "  CPU " << topology.cpus[i] << " -> 节点 " << topology.cpuNodes[i] << std::endl;
+    }
+
+    const size_t count = topology.cpus.size() * 2;
+    ThreadPoolConfig config(count);
+    std::vector<int> none = planWorkerCpus(config, count);
+
+    config.affinityPolicy = AffinityPolicy::Compact;
+    std::vector<int> compact = planWorkerCpus(config, count);
+    config.affinityPolicy = AffinityPolicy::Scatter;
+    std::vector<int> scatter = planWorkerCpus(config, count);
+    std::cout << "Compact: " << planToString(compact) << std::endl;
+    std::cout << "Scatter: " << planToString(scatter) << std::endl;
+
+    bool noneOk = true;
+    for (int cpu : none) {
+        noneOk = noneOk && cpu == -1;
+    }
+    check(noneOk, "默认不绑定CPU");
+
+    // Compact先用完一个节点；线程数超过CPU数时循环
+    bool compactOk = true;
+    for (size_t i = 1; i < topology.cpus.size(); ++i) {
+        compactOk = compactOk && topology.nodeOf(compact[i]) >= topology.nodeOf(compact[i - 1]);
+    }
+    for (size_t i = topology.cpus.size(); i < count; ++i) {
+        compactOk = compactOk && compact[i] == compact[i - topology.cpus.size()];
+    }
+    check(compactOk, "Compact按节点顺序分配，线程多于CPU时循环使用");
+
+    // Scatter前（有CPU的节点数）个线程分别落在不同节点上
+    std::set<int> nodes(topology.cpuNodes.begin(), topology.cpuNodes.end());
+    std::set<int> firstNodes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        firstNodes.insert(topology.nodeOf(scatter[i]));
+    }
+    check(firstNodes == nodes, "Scatter把相邻线程分布到不同节点");
+
+    config.affinityPolicy = AffinityPolicy::None;
+    config.cpuList = {topology.cpus.back(), 1 << 20};
+    std::vector<int> listed = planWorkerCpus(config, 3);
+    check(listed[0] == topology.cpus.back() && listed[1] == listed[0] && listed[2] == listed[0],
+          "显式CPU列表忽略不可用的CPU");
+}
+
+void testWorkerPlacement() {
+    const CpuTopology& topology = CpuTopology::instance();
+    ThreadPoolConfig config(2, 100);
+    config.threadNamePrefix = "affinity-";
+    config.cpuList = {topology.cpus.back()};
+    FixedThreadPool pool(config);
+    pool.start();
+
+    std::mutex mutex;
+    std::set<int> seenCpus;
+    std::atomic<int> done{0};
+    for (int i = 0; i < 20; ++i) {
+        pool.submit([&]() {
+            int cpu = pinnedCpu();
+            std::lock_guard<std::mutex> lock(mutex);
+            seenCpus.insert(cpu);
+            ++done;
+        });
+    }
+    while (done.load() < 20) {
+        std::this_thread::yield();
+    }
+
+    std::set<std::string> names = threadNames();
+    check(names.count("affinity-0") == 1 && names.count("affinity-1") == 1,
+          "工作线程名为 前缀+编号，可在/proc、top、perf中看到");
+    check(seenCpus.size() == 1 && *seenCpus.begin() == topology.cpus.back(),
+          "工作线程绑定到cpuList指定的CPU");
+    pool.shutdown();
+}
+
+void testNumaStealing() {
+    ThreadPoolConfig config(4, 1000);
+    config.affinityPolicy = AffinityPolicy::Scatter;
+    config.numaAware = true;
+    config.threadNamePrefix = "ws-numa-";
+    WorkStealingThreadPool pool(config);
+    pool.start();
+
+    // 每个外部任务在工作线程内再派生子任务，子任务进入本地队列供其他线程窃取
+    const int kParents = 200;
+    const int kChildren = 50;
+    std::atomic<int> done{0};
+    for (int i = 0; i < kParents; ++i) {
+        pool.submit([&pool, &done]() {
+            for (int j = 0; j < kChildren; ++j) {
+                pool.submit([&done]() { ++done; });
+            }
+        });
+    }
+    while (done.load() < kParents * kChildren) {
+        std::this_thread::yield();
+    }
+    WorkStealingStats stats = pool.getStealStats();
+    pool.shutdown();
+
+    std::cout << stats.toString() << std::endl;
+    check(CpuTopology::instance().nodeCount > 1 || stats.remoteSteals == 0,
+          "单节点机器上没有跨节点窃取");
+    check(done.load() == kParents * kChildren, "numaAware工作窃取线程池完成全部任务");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "CPU亲和性演示" << std::endl;
+
+    testPlan();
+    testWorkerPlacement();
+    testNumaStealing();
+
+    return finish();
+}
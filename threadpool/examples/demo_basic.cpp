@@ -4,6 +4,7 @@
 #include <chrono>
 #include <random>
 #include <atomic>
+#include <algorithm>
 
 using namespace ThreadPool;
 
@@ -209,13 +210,120 @@ void demonstrateRejectionPolicy() {
     std::cout << "拒绝策略演示完成\n" << std::endl;
 }
 
+// 扇出负载：每个房间任务在任务内部派生若干个细粒度子任务，返回耗时（毫秒）
+double runFanOut(IThreadPool& pool, int rooms, int subtasksPerRoom) {
+    std::atomic<long> done{0};
+    const long expected = static_cast<long>(rooms) * subtasksPerRoom;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int room = 0; room < rooms; ++room) {
+        pool.submit([&pool, &done, subtasksPerRoom]() {
+            for (int i = 0; i < subtasksPerRoom; ++i) {
+                pool.submit([&done]() {
+                    volatile int x = 0;
+                    for (int k = 0; k < 200; ++k) {
+                        x += k;
+                    }
+                    done.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+    
+    while (done.load() < expected) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// 演示工作窃取线程池
+void demonstrateWorkStealingThreadPool() {
+    std::cout << "\n=== 工作窃取线程池演示 ===" << std::endl;
+    
+    const int rooms = 200;
+    const int subtasksPerRoom = 500;
+    size_t threads = std::max(2u, std::thread::hardware_concurrency());
+    ThreadPoolConfig config(threads, 1000000);
+    
+    auto fixedPool = ThreadPoolFactory::create(ThreadPoolType::Fixed, config);
+    fixedPool->start();
+    double fixedMs = runFanOut(*fixedPool, rooms, subtasksPerRoom);
+    fixedPool->shutdown();
+    
+    auto stealingPool = ThreadPoolFactory::create(ThreadPoolType::WorkStealing, config);
+    stealingPool->start();
+    std::cout << "线程池类型: " << stealingPool->getTypeName() << std::endl;
+    double stealingMs = runFanOut(*stealingPool, rooms, subtasksPerRoom);
+    
+    std::cout << "扇出负载: " << rooms << " 个房间 x " << subtasksPerRoom << " 个子任务" << std::endl;
+    std::cout << "  固定线程池: " << fixedMs << " ms" << std::endl;
+    std::cout << "  工作窃取线程池: " << stealingMs << " ms" << std::endl;
+    
+    auto stealing = dynamic_cast<WorkStealingThreadPool*>(stealingPool.get());
+    if (stealing) {
+        std::cout << stealing->getStealStats().toString() << std::endl;
+    }
+    std::cout << stealingPool->getStats().toString() << std::endl;
+    
+    stealingPool->shutdown();
+    std::cout << "工作窃取线程池演示完成\n" << std::endl;
+}
+
+// 演示定时任务线程池
+void demonstrateScheduledThreadPool() {
+    std::cout << "\n=== 定时任务线程池演示 ===" << std::endl;
+    
+    ScheduledThreadPool pool(2);
+    pool.start();
+    
+    // 固定频率：每50ms一次，执行耗时在0~30ms之间波动，计划时间不随之漂移
+    auto base = std::chrono::steady_clock::now();
+    std::atomic<int> tick{0};
+    auto rate = pool.scheduleAtFixedRate(std::chrono::milliseconds(50), std::chrono::milliseconds(50),
+        [&tick, base]() {
+            int n = ++tick;
+            double offset = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - base).count() - 50.0 * n;
+            std::cout << "固定频率第 " << n << " 次，相对网格偏移: " << offset << " ms" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds((n * 7) % 30));
+        });
+    
+    // 固定延迟：每次结束后再等待30ms
+    auto delay = pool.scheduleWithFixedDelay(std::chrono::milliseconds(0), std::chrono::milliseconds(30),
+        []() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); });
+    
+    // 一次性延迟任务，以及一个在到期前被取消的任务
+    pool.schedule(std::chrono::milliseconds(120), []() {
+        std::cout << "延迟120ms的一次性任务执行" << std::endl;
+    });
+    auto cancelled = pool.schedule(std::chrono::milliseconds(200), []() {
+        std::cout << "这条不应该出现" << std::endl;
+    });
+    cancelled.cancel();
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(520));
+    rate.cancel();
+    delay.cancel();
+    
+    std::cout << "固定频率执行 " << rate.getRunCount() << " 次，跳过 " << rate.getMissedRuns() << " 个周期" << std::endl;
+    std::cout << "固定延迟执行 " << delay.getRunCount() << " 次" << std::endl;
+    std::cout << "被取消的任务执行 " << cancelled.getRunCount() << " 次" << std::endl;
+    std::cout << "清理已取消任务: " << pool.purge() << " 个" << std::endl;
+    std::cout << pool.getStats().toString() << std::endl;
+    
+    pool.shutdown();
+    std::cout << "定时任务线程池演示完成\n" << std::endl;
+}
+
 // 性能基准测试
 void performanceBenchmark() {
     std::cout << "\n=== 性能基准测试 ===" << std::endl;
     
     std::vector<ThreadPoolType> types = {
         ThreadPoolType::Fixed,
-        ThreadPoolType::Priority
+        ThreadPoolType::Priority,
+        ThreadPoolType::WorkStealing
     };
     
     auto results = ThreadPoolFactory::benchmark(types, 1000, std::chrono::milliseconds(3000));
@@ -248,6 +356,8 @@ int main() {
         demonstratePriorityThreadPool();
         demonstrateTaskWithResult();
         demonstrateRejectionPolicy();
+        demonstrateWorkStealingThreadPool();
+        demonstrateScheduledThreadPool();
         performanceBenchmark();
         
         std::cout << "\n所有演示完成！" << std::endl;
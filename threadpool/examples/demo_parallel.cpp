@@ -0,0 +1,104 @@
+#include "../include/thread_pool_factory.h"
+#include "../include/parallel.h"
+#include "test_util.h"
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <chrono>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+using namespace ThreadPool;
+using namespace test_util;
+
+// 并行算法演示：parallel_for / parallel_reduce / parallel_transform / parallel_invoke
+
+namespace {
+
+void runOn(IThreadPool& pool) {
+    std::cout << "\n--- " << pool.getTypeName() << " ---" << std::endl;
+    const size_t n = 1000000;
+
+    // parallel_for：逐元素写入
+    std::vector<double> values(n);
+    auto start = std::chrono::steady_clock::now();
+    parallel::parallel_for(pool, size_t(0), n, [&values](size_t i) {
+        values[i] = std::sqrt(static_cast<double>(i));
+    });
+    std::cout << "parallel_for " << n << " 个元素: " << elapsedMs(start) << " ms" << std::endl;
+    check(values[n - 1] == std::sqrt(static_cast<double>(n - 1)), "parallel_for 结果正确");
+
+    // parallel_reduce：求和
+    start = std::chrono::steady_clock::now();
+    long long sum = parallel::parallel_reduce(pool, 0LL, static_cast<long long>(n), 0LL,
+        [](long long i) { return i; },
+        [](long long a, long long b) { return a + b; });
+    std::cout << "parallel_reduce 求和: " << sum << "，耗时 " << elapsedMs(start) << " ms" << std::endl;
+    check(sum == static_cast<long long>(n) * (n - 1) / 2, "parallel_reduce 结果正确");
+
+    // parallel_transform：映射到另一个数组
+    std::vector<int> input(n);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> output(n);
+    parallel::parallel_transform(pool, input.begin(), input.end(), output.begin(),
+        [](int x) { return x * 2; }, 4096);
+    check(output[12345] == 24690 && output[n - 1] == static_cast<int>(2 * (n - 1)), "parallel_transform 结果正确");
+
+    // parallel_invoke：几个互相独立的阶段
+    std::atomic<int> stages{0};
+    parallel::parallel_invoke(pool,
+        [&stages]() { ++stages; },
+        [&stages]() { ++stages; },
+        [&stages]() { ++stages; });
+    check(stages.load() == 3, "parallel_invoke 执行全部函数");
+
+    // 嵌套：在线程池任务内部再次调用并行算法（模拟每个房间内的并行模拟）
+    const int rooms = 64;
+    const int entities = 2000;
+    std::atomic<long long> updated{0};
+    start = std::chrono::steady_clock::now();
+    parallel::parallel_for(pool, 0, rooms, [&](int room) {
+        (void)room;
+        long long local = parallel::parallel_reduce(pool, 0, entities, 0LL,
+            [](int) { return 1LL; },
+            [](long long a, long long b) { return a + b; });
+        updated += local;
+    }, 1);
+    std::cout << "嵌套并行: " << rooms << " 个房间 x " << entities << " 个实体，耗时 "
+              << elapsedMs(start) << " ms" << std::endl;
+    check(updated.load() == static_cast<long long>(rooms) * entities, "嵌套调用不死锁且结果正确");
+
+    // 异常传播
+    bool caught = false;
+    try {
+        parallel::parallel_for(pool, 0, 1000, [](int i) {
+            if (i == 500) {
+                throw std::runtime_error("第500个元素出错");
+            }
+        }, 10);
+    } catch (const std::runtime_error& e) {
+        caught = true;
+        std::cout << "捕获异常: " << e.what() << std::endl;
+    }
+    check(caught, "异常在调用线程重新抛出");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "并行算法演示" << std::endl;
+
+    // 线程数刻意少于嵌套层数所需，验证调用线程参与计算不会死锁
+    auto fixed = createFixedThreadPool(2);
+    fixed->start();
+    runOn(*fixed);
+    fixed->shutdown();
+
+    auto stealing = createWorkStealingThreadPool(4);
+    stealing->start();
+    runOn(*stealing);
+    stealing->shutdown();
+
+    return finish();
+}
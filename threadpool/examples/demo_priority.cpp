@@ -0,0 +1,148 @@
+#include "../include/thread_pool_factory.h"
+#include "test_util.h"
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ThreadPool;
+using namespace test_util;
+
+// 优先级线程池演示：分级调度顺序、老化防饥饿、各级别统计
+
+namespace {
+
+// 单线程池先被一个任务占住，再提交不同优先级的任务，检查执行顺序
+void testOrdering() {
+    PriorityThreadPool pool(1);
+    pool.start();
+
+    std::atomic<bool> release{false};
+    pool.submitWithPriority([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    }, PriorityThreadPool::kMaxPriority);
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    const int priorities[] = {3, 10, 3, 0, 31, 10, 50, -5};
+    for (int i = 0; i < 8; ++i) {
+        int priority = priorities[i];
+        pool.submitWithPriority([&orderMutex, &order, i]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(i);
+        }, priority);
+    }
+    release = true;
+    pool.shutdown();
+
+    // 50截断为31、-5截断为0；同一级别按提交顺序
+    const int expected[] = {4, 6, 1, 5, 0, 2, 3, 7};
+    bool ok = order.size() == 8;
+    for (size_t i = 0; ok && i < order.size(); ++i) {
+        ok = order[i] == expected[i];
+    }
+    check(ok, "按优先级从高到低执行，同级按提交顺序，超出范围的优先级被截断");
+}
+
+// 持续提交高优先级任务时，低优先级任务能否执行
+// 返回低优先级任务的等待时间（毫秒），洪流结束前没有执行则返回负数
+double runFlood(std::chrono::milliseconds agingInterval, PriorityLevelStats& lowStats) {
+    ThreadPoolConfig config(1, 100000);
+    config.priorityAgingInterval = agingInterval;
+    PriorityThreadPool pool(config);
+    pool.start();
+
+    std::atomic<bool> flooding{true};
+    std::atomic<bool> lowDuringFlood{false};
+    std::atomic<double> lowWaitMs{0.0};
+    auto start = std::chrono::steady_clock::now();
+
+    // 洪流：每个高优先级任务执行时再提交一个，队列里始终有一批高优先级任务
+    std::function<void()> flood;
+    flood = [&pool, &flooding, &flood]() {
+        if (flooding.load()) {
+            pool.submitWithPriority(flood, 20);
+        }
+        busyWork(100);
+    };
+    for (int i = 0; i < 8; ++i) {
+        pool.submitWithPriority(flood, 20);
+    }
+
+    // 再提交一个低优先级维护任务
+    pool.submitWithPriority([&]() {
+        lowWaitMs = elapsedMs(start);
+        lowDuringFlood = flooding.load();
+    }, 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    flooding = false;
+    pool.shutdown();
+
+    lowStats = pool.getLevelStats(1);
+    return lowDuringFlood.load() ? lowWaitMs.load() : -1.0;
+}
+
+void testAging() {
+    PriorityLevelStats withoutAging;
+    double starved = runFlood(std::chrono::milliseconds(0), withoutAging);
+    std::cout << "不老化：低优先级任务" << (starved < 0 ? "在洪流结束前没有执行" : "执行了") << std::endl;
+    check(starved < 0, "不老化时高优先级洪流使低优先级任务饥饿");
+
+    PriorityLevelStats withAging;
+    double waited = runFlood(std::chrono::milliseconds(2), withAging);
+    std::cout << "老化间隔2ms：低优先级任务等待 " << std::fixed << std::setprecision(2) << waited
+              << " ms（每2ms提升一级，需提升19级才与洪流任务同级）" << std::endl;
+    check(waited >= 0, "开启老化后低优先级任务在洪流期间得到执行");
+    check(withAging.completed == 1 && withAging.promoted == 1 && withAging.maxWaitTime > 0.0, "各级别统计记录完成数和等待时间");
+}
+
+void benchScheduling() {
+    const int kTasks = 200000;
+    PriorityThreadPool pool(ThreadPoolConfig(2, kTasks));
+    pool.start();
+
+    std::atomic<int> done{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTasks; ++i) {
+        pool.submitWithPriority([&done]() { ++done; }, i % PriorityThreadPool::kPriorityLevels);
+    }
+    while (done.load() < kTasks) {
+        std::this_thread::yield();
+    }
+    double ms = elapsedMs(start);
+    pool.shutdown();
+
+    std::cout << kTasks << " 个空任务（" << PriorityThreadPool::kPriorityLevels << " 个级别）: "
+              << std::fixed << std::setprecision(1) << ms << " ms，"
+              << kTasks / ms * 1000.0 << " 任务/秒" << std::endl;
+
+    std::cout << "  优先级  提交  完成  平均等待(ms)  最大等待(ms)" << std::endl;
+    std::vector<PriorityLevelStats> levels = pool.getAllLevelStats();
+    for (size_t i = 0; i < levels.size() && i < 3; ++i) {
+        std::cout << std::setw(8) << levels[i].priority << std::setw(8) << levels[i].submitted
+                  << std::setw(6) << levels[i].completed << std::setprecision(3)
+                  << std::setw(14) << levels[i].avgWaitTime << std::setw(14) << levels[i].maxWaitTime
+                  << std::endl;
+    }
+    check(levels.size() == static_cast<size_t>(PriorityThreadPool::kPriorityLevels),
+          "所有级别都有统计");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "优先级线程池演示" << std::endl;
+
+    testOrdering();
+    testAging();
+    benchScheduling();
+
+    return finish();
+}
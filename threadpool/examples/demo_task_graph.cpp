@@ -0,0 +1,148 @@
+#include "../include/thread_pool_factory.h"
+#include "../include/task_graph.h"
+#include "test_util.h"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+using namespace ThreadPool;
+using namespace test_util;
+
+// 任务图演示：每帧 输入 → (物理, AI) → 排行榜 → 广播，另有一个独立的统计节点
+
+namespace {
+
+} // namespace
+
+int main() {
+    std::cout << "任务图演示" << std::endl;
+
+    ThreadPoolConfig config(4, 1024);
+    config.queueType = TaskQueueType::LockFree;
+    FixedThreadPool pool(config);
+    pool.start();
+
+    // 每个阶段记录自己看到的帧号，后继检查前驱已经处理过当前帧
+    int frame = 0;
+    int inputFrame = -1, physicsFrame = -1, aiFrame = -1, leaderboardFrame = -1, broadcastFrame = -1;
+    std::atomic<int> orderErrors{0};
+
+    TaskGraph graph;
+    TaskGraph::NodeId input = graph.addNode("输入", [&]() {
+        busyWork(50);
+        inputFrame = frame;
+    });
+    TaskGraph::NodeId physics = graph.addNode("物理", [&]() {
+        if (inputFrame != frame) ++orderErrors;
+        busyWork(200);
+        physicsFrame = frame;
+    });
+    TaskGraph::NodeId ai = graph.addNode("AI", [&]() {
+        if (inputFrame != frame) ++orderErrors;
+        busyWork(200);
+        aiFrame = frame;
+    });
+    TaskGraph::NodeId leaderboard = graph.addNode("排行榜", [&]() {
+        if (physicsFrame != frame || aiFrame != frame) ++orderErrors;
+        busyWork(80);
+        leaderboardFrame = frame;
+    });
+    TaskGraph::NodeId broadcast = graph.addNode("广播", [&]() {
+        if (leaderboardFrame != frame) ++orderErrors;
+        busyWork(50);
+        broadcastFrame = frame;
+    });
+    graph.addNode("统计", []() { busyWork(30); });
+
+    graph.addEdge(input, physics);
+    graph.addEdge(input, ai);
+    graph.addEdge(physics, leaderboard);
+    graph.addEdge(ai, leaderboard);
+    graph.addEdge(leaderboard, broadcast);
+
+    const int frames = 200;
+    double totalMs = 0.0;
+    for (frame = 0; frame < frames; ++frame) {
+        graph.run(pool);
+        totalMs += graph.getLastRunTime();
+    }
+    check(orderErrors.load() == 0, "每帧都按依赖顺序执行");
+    check(broadcastFrame == frames - 1 && graph.getRunCount() == static_cast<size_t>(frames),
+          "所有帧都执行完毕");
+
+    std::cout << "\n" << frames << " 帧，平均每帧 " << std::fixed << std::setprecision(3)
+              << totalMs / frames << " ms" << std::endl;
+    std::cout << "  次数  最近开始(ms)  最近(ms)  平均(ms)  最大(ms)  节点" << std::endl;
+    for (const auto& stats : graph.getAllNodeStats()) {
+        std::cout << std::setw(6) << stats.runCount
+                  << std::setw(14) << stats.lastStartMs
+                  << std::setw(10) << stats.lastMs
+                  << std::setw(10) << stats.avgMs
+                  << std::setw(10) << stats.maxMs
+                  << "  " << stats.name << std::endl;
+    }
+    std::cout << std::endl;
+
+    // 节点异常：后续节点被跳过，run()重新抛出
+    {
+        TaskGraph failing;
+        std::atomic<int> executed{0};
+        TaskGraph::NodeId a = failing.addNode("a", [&]() { ++executed; throw std::runtime_error("物理步进失败"); });
+        TaskGraph::NodeId b = failing.addNode("b", [&]() { ++executed; });
+        failing.addEdge(a, b);
+        bool caught = false;
+        try {
+            failing.run(pool);
+        } catch (const std::runtime_error& e) {
+            caught = true;
+            std::cout << "捕获异常: " << e.what() << std::endl;
+        }
+        check(caught && executed.load() == 1, "节点异常在run()中重新抛出，后继被跳过");
+
+        // 异常不影响下一次运行
+        caught = false;
+        try {
+            failing.run(pool);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        check(caught && executed.load() == 2, "出错后图仍可再次运行");
+    }
+
+    // 环检测
+    {
+        TaskGraph cyclic;
+        TaskGraph::NodeId a = cyclic.addNode("a", []() {});
+        TaskGraph::NodeId b = cyclic.addNode("b", []() {});
+        cyclic.addEdge(a, b);
+        cyclic.addEdge(b, a);
+        bool caught = false;
+        try {
+            cyclic.run(pool);
+        } catch (const std::logic_error& e) {
+            caught = true;
+            std::cout << "捕获异常: " << e.what() << std::endl;
+        }
+        check(caught, "有环的图被拒绝");
+    }
+
+    // 线程池未运行时由调用线程完成
+    {
+        FixedThreadPool stopped(2);
+        int count = 0;
+        TaskGraph local;
+        TaskGraph::NodeId a = local.addNode("a", [&]() { ++count; });
+        TaskGraph::NodeId b = local.addNode("b", [&]() { ++count; });
+        TaskGraph::NodeId c = local.addNode("c", [&]() { ++count; });
+        local.addEdge(a, b);
+        local.addEdge(a, c);
+        local.run(stopped);
+        check(count == 3, "线程池未运行时在调用线程完成整个图");
+    }
+
+    pool.shutdown();
+
+    return finish();
+}
@@ -0,0 +1,183 @@
+#include "../include/thread_pool_factory.h"
+#include "../include/task_graph.h"
+#include "test_util.h"
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+
+using namespace ThreadPool;
+using namespace test_util;
+
+// 统计当前线程的堆分配次数，验证小任务提交不分配内存；
+// 工作线程上发生的分配计入全进程计数
+namespace {
+thread_local size_t tlsAllocations = 0;
+std::atomic<size_t> totalAllocations{0};
+}
+
+// 替换全局operator new/delete后，GCC会把内联进来的free误报为与new不匹配
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    ++tlsAllocations;
+    ++totalAllocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+template<typename F>
+size_t countAllocations(F&& f) {
+    size_t before = tlsAllocations;
+    f();
+    return tlsAllocations - before;
+}
+
+void waitFor(const std::atomic<int>& counter, int expected) {
+    while (counter.load() < expected) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+int main() {
+    std::atomic<int> counter{0};
+    int a = 1, b = 2, c = 3;
+    double d = 4.0;
+
+    // 典型的小闭包：几个指针和整数
+    size_t allocs = countAllocations([&]() {
+        Task task([&counter, a, b, c, d]() { counter += a + b + c + static_cast<int>(d); });
+        Task moved(std::move(task));
+        check(moved.isInline(), "小闭包存放在内部缓冲区");
+        moved();
+    });
+    check(allocs == 0, "构造、移动、执行小闭包不分配内存");
+
+    // 超过内部缓冲区的闭包退化为堆分配
+    struct Big { char payload[Task::kInlineSize + 8]; };
+    allocs = countAllocations([&]() {
+        Big big = Big();
+        Task task([big, &counter]() { counter += big.payload[0] + 1; });
+        check(!task.isInline(), "大闭包存放在堆上");
+        Task moved(std::move(task));
+        moved();
+    });
+    check(allocs == 1, "大闭包只分配一次（移动时转移指针）");
+
+    // 只能移动的可调用对象
+    std::unique_ptr<int> owned(new int(7));
+    Task moveOnly([](){});
+    {
+        struct Holder {
+            std::unique_ptr<int> value;
+            std::atomic<int>* counter;
+            void operator()() { *counter += *value; }
+        };
+        Holder holder{std::move(owned), &counter};
+        moveOnly = Task(std::move(holder));
+    }
+    int beforeMoveOnly = counter.load();
+    moveOnly();
+    check(counter.load() == beforeMoveOnly + 7, "只能移动的可调用对象可以作为任务");
+
+    // 无锁队列的固定线程池：队列预先分配，提交小闭包不分配内存
+    {
+        ThreadPoolConfig config(2, 4096);
+        config.queueType = TaskQueueType::LockFree;
+        FixedThreadPool pool(config);
+        pool.start();
+
+        std::atomic<int> done{0};
+        pool.submit([&done]() { ++done; });  // 预热
+        waitFor(done, 1);
+
+        const int kTasks = 1000;
+        allocs = countAllocations([&]() {
+            for (int i = 0; i < kTasks; ++i) {
+                pool.submit([&done, i, a, b]() { done += (i + a + b) >= 0 ? 1 : 0; });
+            }
+        });
+        waitFor(done, kTasks + 1);
+        check(allocs == 0, "无锁固定线程池提交1000个小闭包不分配内存");
+
+        // submitWithResult不再有shared_ptr和std::function的分配，
+        // 只剩packaged_task自身的共享状态和结果存储（libstdc++中各一次）
+        allocs = countAllocations([&]() {
+            auto future = pool.submitWithResult([](int x, int y) { return x * y; }, 6, 7);
+            check(future.get() == 42, "submitWithResult返回正确结果");
+        });
+        std::cout << "submitWithResult分配次数: " << allocs << std::endl;
+        check(allocs <= 2, "submitWithResult只有packaged_task自身的分配");
+
+        // 已构建的任务图重复运行：调用线程和工作线程都不分配内存
+        TaskGraph graph;
+        std::atomic<int> nodeRuns{0};
+        TaskGraph::NodeId root = graph.addNode("root", [&nodeRuns]() { ++nodeRuns; });
+        TaskGraph::NodeId sink = graph.addNode("sink", [&nodeRuns]() { ++nodeRuns; });
+        for (int i = 0; i < 8; ++i) {
+            TaskGraph::NodeId middle = graph.addNode("middle", [&nodeRuns]() { ++nodeRuns; });
+            graph.addEdge(root, middle);
+            graph.addEdge(middle, sink);
+        }
+        graph.run(pool);  // 第一次运行完成拓扑检查
+        size_t before = totalAllocations.load();
+        for (int frame = 0; frame < 100; ++frame) {
+            graph.run(pool);
+        }
+        size_t graphAllocs = totalAllocations.load() - before;
+        std::cout << "任务图运行100次分配次数: " << graphAllocs << std::endl;
+        check(nodeRuns.load() == 101 * 10 && graphAllocs == 0, "已构建的任务图重复运行不分配内存");
+
+        pool.shutdown();
+    }
+
+    // 工作窃取线程池：任务内派生的子任务使用池化节点，节点池预热后不再分配内存
+    {
+        WorkStealingThreadPool pool(2);
+        pool.start();
+
+        const int kChildren = 100;
+        std::atomic<int> done{0};
+        std::atomic<size_t> spawnAllocs{0};
+        auto spawnRound = [&]() {
+            int target = done.load() + kChildren + 1;
+            pool.submit([&]() {
+                spawnAllocs = countAllocations([&]() {
+                    for (int i = 0; i < kChildren; ++i) {
+                        pool.submit([&done, i, a]() { done += (i + a) >= 0 ? 1 : 0; });
+                    }
+                });
+                ++done;
+            });
+            waitFor(done, target);
+        };
+        for (int round = 0; round < 50; ++round) {
+            spawnRound();  // 预热：节点在各工作线程的缓存和共享池之间达到稳定
+        }
+        spawnRound();
+        std::cout << "工作窃取线程池派生100个子任务分配次数: " << spawnAllocs.load() << std::endl;
+        check(spawnAllocs.load() == 0, "工作窃取线程池任务内提交小闭包不分配内存");
+
+        pool.shutdown();
+    }
+
+    return finish();
+}
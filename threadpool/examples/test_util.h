@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// threadpool与rpc_framework的测试程序共用的检查与计时工具：每项检查输出一行"✅/❌ 描述"，
+// main()结尾用finish()输出汇总并返回退出码
+
+namespace test_util {
+
+inline int& failureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+// const char*版本不分配内存，可以在统计分配次数的测试中使用
+inline void check(bool ok, const char* what) {
+    std::cout << (ok ? "✅ " : "❌ ") << what << std::endl;
+    if (!ok) {
+        ++failureCount();
+    }
+}
+
+inline void check(bool ok, const std::string& what) {
+    check(ok, what.c_str());
+}
+
+// 输出汇总，返回main()的退出码
+inline int finish() {
+    std::cout << "\n" << (failureCount() == 0 ? "✅ 全部通过" : "❌ 存在失败") << std::endl;
+    return failureCount() == 0 ? 0 : 1;
+}
+
+inline double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 忙等指定微秒，模拟CPU密集的任务
+inline void busyWork(int microseconds) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+} // namespace test_util
@@ -21,7 +21,6 @@ public:
 
     // IThreadPool接口实现
     bool submit(Task task) override;
-    size_t submitBatch(const std::vector<Task>& tasks) override;
     bool start() override;
     void stop() override;
     void shutdown() override;
@@ -75,7 +74,7 @@ private:
     void joinAllWorkers();
     
     // 拒绝策略处理
-    bool handleRejection(const Task& task);
+    bool handleRejection(Task& task);
     
     // 统计相关
     mutable std::mutex statsMutex_;
@@ -87,6 +86,8 @@ private:
     // 清理线程
     std::thread cleanupThread_;
     std::atomic<bool> cleanupRunning_{false};
+    std::mutex cleanupMutex_;
+    std::condition_variable cleanupCondition_;  // 关闭时立即唤醒清理线程
     void cleanupWorker();
 };
 
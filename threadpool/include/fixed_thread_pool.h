@@ -1,16 +1,24 @@
 #pragma once
 
 #include "thread_pool.h"
+#include "mpmc_queue.h"
+#include "latency_histogram.h"
 #include <thread>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 #include <vector>
+#include <memory>
 
 namespace ThreadPool {
 
 // 固定大小线程池实现
+// config.queueType选择任务队列：
+//   - Locked：std::queue + 互斥量，提交和取任务都经过同一把锁
+//   - LockFree：有界MPMC无锁队列（容量向上取整为2的幂），空闲线程先自旋再休眠，
+//     只有确实有线程休眠时，提交才会触碰休眠用的互斥量和条件变量
+// 每个工作线程把执行时间和排队等待时间记录到自己的延迟直方图（无锁），getStats()时合并。
 class FixedThreadPool : public IThreadPool {
 public:
     explicit FixedThreadPool(const ThreadPoolConfig& config);
@@ -19,7 +27,7 @@ public:
 
     // IThreadPool接口实现
     bool submit(Task task) override;
-    size_t submitBatch(const std::vector<Task>& tasks) override;
+    size_t submitBulk(Task* tasks, size_t count) override;
     bool start() override;
     void stop() override;
     void shutdown() override;
@@ -41,11 +49,27 @@ private:
     ThreadPoolConfig config_;
     RejectionPolicy rejectionPolicy_;
     
+    // 队列中的任务带上提交时间，用于统计排队等待
+    struct QueuedTask {
+        Task task;
+        std::chrono::steady_clock::time_point enqueueTime;
+    };
+    
+    // 每个工作线程的延迟统计，只由所属线程写入
+    struct WorkerStats {
+        LatencyHistogram executionTime;
+        LatencyHistogram queueWait;
+    };
+    
     std::vector<std::thread> workers_;
-    std::queue<Task> taskQueue_;
+    std::vector<std::unique_ptr<WorkerStats>> workerStats_;
+    std::queue<QueuedTask> taskQueue_;
     
     mutable std::mutex queueMutex_;
     std::condition_variable condition_;
+    std::condition_variable notFullCondition_;  // Block拒绝策略等待队列空位
+    size_t idleWorkers_ = 0;        // 在condition_上等待的工作线程数，受queueMutex_保护
+    size_t blockedSubmitters_ = 0;  // 在notFullCondition_上等待的提交者数，受queueMutex_保护
     std::condition_variable terminationCondition_;
     
     std::atomic<bool> running_{false};
@@ -55,20 +79,39 @@ private:
     std::atomic<size_t> completedTasks_{0};
     std::atomic<size_t> rejectedTasks_{0};
     
+    // 无锁队列模式
+    std::unique_ptr<BoundedMPMCQueue<QueuedTask>> lockFreeQueue_;
+    std::mutex parkMutex_;
+    std::condition_variable parkCondition_;
+    std::atomic<size_t> sleepers_{0};
+    // Block策略下等待队列空位的提交者数，提交者在queueMutex_/notFullCondition_上等待
+    std::atomic<size_t> blockedProducers_{0};
+    
     // 工作线程函数
     void workerThread(size_t threadId);
+    void lockFreeWorkerLoop(size_t threadId);
+    bool waitForLockFreeTask(QueuedTask& item);
+    void park();
+    void runTask(size_t threadId, QueuedTask& item);
     
-    // 拒绝策略处理
-    bool handleRejection(const Task& task);
+    // 唤醒一个休眠的工作线程（没有休眠线程时不触碰锁）
+    void wakeOne();
+    // 唤醒min(count, 休眠线程数)个工作线程
+    void wakeMany(size_t count);
+    void wakeAll();
+    
+    // 无锁队列模式：等待队列腾出count个空位，关闭时返回false
+    bool waitForLockFreeSpace(size_t count);
+    // 取出任务后唤醒等待空位的提交者（没有等待者时不触碰锁）
+    void wakeBlockedProducers();
     
-    // 统计相关
-    mutable std::mutex statsMutex_;
-    std::vector<std::chrono::high_resolution_clock::time_point> taskStartTimes_;
-    std::vector<double> executionTimes_;
+    // 拒绝策略处理
+    bool handleRejection(Task& task);
+    size_t handleBulkRejection(Task* tasks, size_t count);
+    bool enqueueBulk(Task* tasks, size_t count, std::chrono::steady_clock::time_point now);
     
-    void recordTaskStart();
-    void recordTaskEnd();
-    double calculateAvgExecutionTime() const;
+    // 合并各工作线程的直方图，填充统计中的延迟字段
+    void fillLatencyStats(ThreadPoolStats& stats) const;
 };
 
 } // namespace ThreadPool 
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ThreadPool {
+
+// 延迟直方图快照，由多个LatencyHistogram合并而来，只在统计时使用
+struct LatencySnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+
+    // q取值0~1，返回对应分位的延迟（毫秒），没有样本时返回0
+    double percentileMs(double q) const;
+    double meanMs() const;
+};
+
+// 对数分桶的延迟直方图（HDR风格）
+// 每个2的幂区间再均分为16个子桶，相对误差不超过1/16；记录范围0~2^42纳秒（约73分钟），超出的计入最后一个桶。
+// record()只允许一个线程调用（每个工作线程各自一份），不加锁也不使用原子读改写；
+// addTo()可以在任意线程调用，读到的是近似一致的快照。
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 4;
+    static const int kMaxValueBits = 42;
+    static const size_t kSubBucketCount = size_t(1) << kSubBucketBits;
+    static const size_t kBucketCount = size_t(kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // 仅所属线程调用
+    void record(uint64_t valueNs) {
+        bump(counts_[bucketIndex(valueNs)], 1);
+        bump(total_, 1);
+        bump(sumNs_, valueNs);
+        if (valueNs > maxNs_.load(std::memory_order_relaxed)) {
+            maxNs_.store(valueNs, std::memory_order_relaxed);
+        }
+    }
+
+    // 把当前计数累加到快照
+    void addTo(LatencySnapshot& snapshot) const;
+
+    static size_t bucketIndex(uint64_t valueNs);
+    // 桶内最大值，分位数按桶上界报告（不会低估）
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    // 单写者计数：普通的读-加-写即可，避免lock前缀
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> sumNs_;
+    std::atomic<uint64_t> maxNs_;
+};
+
+} // namespace ThreadPool
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace ThreadPool {
+
+// 有界多生产者多消费者无锁队列（Dmitry Vyukov的环形数组算法）
+// 每个槽位带一个序号：序号 == 位置 表示可写入，序号 == 位置 + 1 表示可读取。
+// 生产者/消费者各自只CAS一个位置计数器，抢到位置后独占该槽位，不需要锁。
+// 容量向上取整为2的幂；队列满时tryPush返回false，由调用者决定拒绝策略。
+template<typename T>
+class BoundedMPMCQueue {
+public:
+    explicit BoundedMPMCQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        capacity_ = cap;
+        mask_ = cap - 1;
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_.store(0, std::memory_order_relaxed);
+    }
+
+    BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+    BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+
+    // 队列满返回false，此时item保持不变
+    bool tryPush(T& item) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 槽位还没被消费者取走：队列满
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 一次CAS占用连续count个位置，make(i)生成第i个元素；空间不足返回false，此时不会调用make。
+    // 占位前按消费位置估算空间，占位后如果某个槽位的消费者还没读完，短暂等待它完成。
+    template<typename Make>
+    bool tryPushBulk(size_t count, Make&& make) {
+        if (count == 0) {
+            return true;
+        }
+        if (count > capacity_) {
+            return false;
+        }
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            size_t deq = dequeuePos_.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(pos - deq) < 0) {
+                pos = enqueuePos_.load(std::memory_order_relaxed);  // pos已过期
+                continue;
+            }
+            if (pos - deq + count > capacity_) {
+                size_t fresh = enqueuePos_.load(std::memory_order_relaxed);
+                if (fresh == pos) {
+                    return false;
+                }
+                pos = fresh;
+                continue;
+            }
+            if (enqueuePos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Cell* cell = &cells_[(pos + i) & mask_];
+            while (cell->sequence.load(std::memory_order_acquire) != pos + i) {
+                std::this_thread::yield();
+            }
+            cell->data = make(i);
+            cell->sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // 队列空返回false
+    bool tryPop(T& item) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 槽位还没被生产者写入：队列空
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        item = std::move(cell->data);
+        cell->data = T();  // 尽早释放任务持有的资源
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似大小，仅用于统计和判断是否有任务
+    size_t size() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // 生产者和消费者的位置计数器分开到不同缓存行
+    char padding0_[64];
+    std::atomic<size_t> enqueuePos_;
+    char padding1_[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeuePos_;
+    char padding2_[64 - sizeof(std::atomic<size_t>)];
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_;
+    size_t mask_;
+};
+
+} // namespace ThreadPool
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ThreadPool {
+
+// 数据并行算法，适用于任意IThreadPool
+//   - 区间按"引导式自调度"动态分块：每次领取 max(粒度, 剩余量 / (2 * 参与者数)) 个元素，
+//     开始时块大、负载均衡时块小；grainSize为0时自动选择最小粒度
+//   - 调用线程自己也参与计算，只等待已被其他线程领走、正在执行的块，不等待排队中的任务，
+//     因此在线程池任务内部嵌套调用也不会死锁（极端情况下退化为调用线程独自完成）
+//   - 任一块抛出异常后，尚未开始的块被跳过，第一个异常在调用线程重新抛出
+//   - 线程池未运行或拒绝提交时由调用线程独自完成
+namespace parallel {
+
+namespace detail {
+
+// 一次并行调用的共享状态，由调用线程和辅助任务共同持有
+class ParallelState {
+public:
+    ParallelState(size_t total, size_t grain, size_t participants)
+        : total_(total), grain_(grain), participants_(participants), next_(0), remaining_(total),
+          failed_(false) {}
+
+    // 领取下一块 [begin, end)，没有剩余时返回false
+    bool claim(size_t& begin, size_t& end) {
+        size_t current = next_.load(std::memory_order_relaxed);
+        while (current < total_) {
+            size_t rest = total_ - current;
+            size_t chunk = std::min(rest, std::max(grain_, rest / (2 * participants_)));
+            if (next_.compare_exchange_weak(current, current + chunk, std::memory_order_relaxed)) {
+                begin = current;
+                end = current + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 一块处理完毕（包括因异常被跳过）
+    void finish(size_t count) {
+        if (remaining_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.notify_all();
+        }
+    }
+
+    void fail(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = error;
+        }
+        failed_.store(true, std::memory_order_relaxed);
+    }
+
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+    // 等待所有块完成，并重新抛出第一个异常
+    void wait() {
+        for (int spin = 0; spin < 128; ++spin) {
+            if (remaining_.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+        if (error_) {
+            // 异常对象的所有权转给调用线程，辅助任务稍后释放状态时不再触碰它
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            lock.unlock();
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const size_t total_;
+    const size_t grain_;
+    const size_t participants_;
+    std::atomic<size_t> next_;
+    std::atomic<size_t> remaining_;
+    std::atomic<bool> failed_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+// 线程池可用的工作线程数，线程池未运行时为0
+inline size_t workerCount(const IThreadPool& pool) {
+    return pool.isRunning() ? pool.getConfig().coreThreads : 0;
+}
+
+inline size_t autoGrain(size_t total, size_t participants) {
+    return std::max<size_t>(1, total / (participants * 16));
+}
+
+// 并行执行 chunk(begin, end)，覆盖 [0, total)
+template<typename Chunk>
+void run(IThreadPool& pool, size_t total, size_t grainSize, Chunk& chunk) {
+    if (total == 0) {
+        return;
+    }
+
+    size_t workers = workerCount(pool);
+    size_t grain = grainSize > 0 ? grainSize : autoGrain(total, workers + 1);
+    size_t chunks = (total + grain - 1) / grain;
+    size_t helpers = std::min(workers, chunks - 1);
+
+    if (helpers == 0) {
+        chunk(size_t(0), total);
+        return;
+    }
+
+    std::shared_ptr<ParallelState> state = std::make_shared<ParallelState>(total, grain, helpers + 1);
+
+    // 参与者：处理领到的块后继续领取，直到没有剩余
+    auto participate = [&chunk](ParallelState& st, size_t begin, size_t end) {
+        do {
+            if (!st.failed()) {
+                try {
+                    chunk(begin, end);
+                } catch (...) {
+                    st.fail(std::current_exception());
+                }
+            }
+            st.finish(end - begin);
+        } while (st.claim(begin, end));
+    };
+    typedef decltype(participate) Participate;
+    Participate* participant = &participate;
+
+    // 辅助任务先领块再访问participant：调用线程返回后才开始执行的辅助任务领不到块，直接退出
+    std::vector<Task> tasks;
+    tasks.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i) {
+        tasks.emplace_back([state, participant]() {
+            size_t begin = 0;
+            size_t end = 0;
+            if (state->claim(begin, end)) {
+                (*participant)(*state, begin, end);
+            }
+        });
+    }
+    try {
+        pool.submitBulk(tasks.data(), tasks.size());
+    } catch (...) {
+        // 被拒绝时由调用线程完成全部工作
+    }
+
+    size_t begin = 0;
+    size_t end = 0;
+    if (state->claim(begin, end)) {
+        participate(*state, begin, end);
+    }
+    state->wait();
+}
+
+// 把任意可调用对象的引用擦除为函数指针，供parallel_invoke使用
+struct Invocable {
+    void* object;
+    void (*call)(void*);
+
+    template<typename F>
+    static void invoke(void* object) { (*static_cast<F*>(object))(); }
+
+    template<typename F>
+    explicit Invocable(F& f)
+        : object(const_cast<void*>(static_cast<const void*>(&f))), call(&invoke<F>) {}
+};
+
+} // namespace detail
+
+// 对 [first, last) 中的每个下标调用 body(i)
+template<typename Index, typename Body>
+void parallel_for(IThreadPool& pool, Index first, Index last, Body&& body, size_t grainSize = 0) {
+    static_assert(std::is_integral<Index>::value, "parallel_for: 下标必须是整数类型");
+    if (!(first < last)) {
+        return;
+    }
+    size_t total = static_cast<size_t>(last - first);
+    auto chunk = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            body(static_cast<Index>(first + static_cast<Index>(i)));
+        }
+    };
+    detail::run(pool, total, grainSize, chunk);
+}
+
+// 对 [first, last) 中的每个下标计算 map(i)，再用 reduce 合并，返回合并结果。
+// reduce 需要满足结合律和交换律，identity 是它的单位元；各块的部分结果按完成顺序合并。
+template<typename Index, typename T, typename Map, typename Reduce>
+T parallel_reduce(IThreadPool& pool, Index first, Index last, T identity, Map&& map, Reduce&& reduce,
+                  size_t grainSize = 0) {
+    static_assert(std::is_integral<Index>::value, "parallel_reduce: 下标必须是整数类型");
+    T result = identity;
+    if (!(first < last)) {
+        return result;
+    }
+    size_t total = static_cast<size_t>(last - first);
+    std::mutex resultMutex;
+    auto chunk = [&](size_t begin, size_t end) {
+        T partial = identity;
+        for (size_t i = begin; i < end; ++i) {
+            partial = reduce(partial, map(static_cast<Index>(first + static_cast<Index>(i))));
+        }
+        std::lock_guard<std::mutex> lock(resultMutex);
+        result = reduce(result, partial);
+    };
+    detail::run(pool, total, grainSize, chunk);
+    return result;
+}
+
+// out[i] = op(first[i])，要求随机访问迭代器，返回输出区间的末尾
+template<typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(IThreadPool& pool, InputIt first, InputIt last, OutputIt out, UnaryOp&& op,
+                            size_t grainSize = 0) {
+    static_assert(std::is_base_of<std::random_access_iterator_tag,
+                      typename std::iterator_traits<InputIt>::iterator_category>::value &&
+                  std::is_base_of<std::random_access_iterator_tag,
+                      typename std::iterator_traits<OutputIt>::iterator_category>::value,
+                  "parallel_transform: 需要随机访问迭代器");
+    size_t total = static_cast<size_t>(std::distance(first, last));
+    auto chunk = [&](size_t begin, size_t end) {
+        InputIt in = first + begin;
+        OutputIt dst = out + begin;
+        for (size_t i = begin; i < end; ++i, ++in, ++dst) {
+            *dst = op(*in);
+        }
+    };
+    detail::run(pool, total, grainSize, chunk);
+    return out + total;
+}
+
+// 并行执行若干个互相独立的函数，全部完成后返回
+template<typename... Fs>
+void parallel_invoke(IThreadPool& pool, Fs&&... fs) {
+    detail::Invocable calls[] = { detail::Invocable(fs)... };
+    auto chunk = [&calls](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            calls[i].call(calls[i].object);
+        }
+    };
+    detail::run(pool, sizeof...(Fs), 1, chunk);
+}
+
+} // namespace parallel
+
+} // namespace ThreadPool
@@ -2,42 +2,59 @@
 
 #include "thread_pool.h"
 #include <thread>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 #include <vector>
+#include <cstdint>
 
 namespace ThreadPool {
 
 // 优先级任务结构
 struct PriorityTask {
     Task task;
-    int priority;
+    int priority;                                     // 提交时的优先级（已限制在有效范围内）
     std::chrono::steady_clock::time_point submitTime;
-    
-    PriorityTask(Task t, int p) 
-        : task(std::move(t)), priority(p), submitTime(std::chrono::steady_clock::now()) {}
-    
-    // 优先级比较（高优先级优先，相同优先级按提交时间）
-    bool operator<(const PriorityTask& other) const {
-        if (priority != other.priority) {
-            return priority < other.priority; // 数字越大优先级越高
-        }
-        return submitTime > other.submitTime; // 提交时间越早优先级越高
-    }
+    std::chrono::steady_clock::time_point levelTime;  // 进入当前级别的时间，用于老化
+
+    PriorityTask(Task t, int p, std::chrono::steady_clock::time_point now)
+        : task(std::move(t)), priority(p), submitTime(now), levelTime(now) {}
+};
+
+// 单个优先级级别的统计信息
+struct PriorityLevelStats {
+    int priority = 0;
+    size_t submitted = 0;     // 以该优先级提交的任务数
+    size_t completed = 0;     // 以该优先级提交、已执行完的任务数
+    size_t promoted = 0;      // 因老化从该级别提升出去的次数
+    size_t queued = 0;        // 当前在该级别排队的任务数（包括从更低级别提升上来的）
+    double avgWaitTime = 0.0; // 平均排队等待时间（毫秒）
+    double maxWaitTime = 0.0; // 最大排队等待时间（毫秒）
 };
 
 // 优先级线程池实现
+// 固定kPriorityLevels个优先级级别（数字越大优先级越高，超出范围的优先级被截断），
+// 每个级别一个FIFO队列，用位图记录非空级别，入队、出队都是O(1)，同一级别内按提交顺序执行。
+// 设置老化间隔（ThreadPoolConfig::priorityAgingInterval或setAgingInterval）后，
+// 在某一级别等待超过间隔的任务被提升一级，因此低优先级任务最多等待约
+// (kMaxPriority - 优先级) 个老化间隔就会到达最高级别，不会无限饥饿。
+// 各级别统计使用原子计数，不加锁。
 class PriorityThreadPool : public IThreadPool {
 public:
+    static const int kPriorityLevels = 32;
+    static const int kMinPriority = 0;
+    static const int kMaxPriority = kPriorityLevels - 1;
+
     explicit PriorityThreadPool(const ThreadPoolConfig& config);
     explicit PriorityThreadPool(size_t threadCount);
     ~PriorityThreadPool() override;
 
     // IThreadPool接口实现
     bool submit(Task task) override;
-    size_t submitBatch(const std::vector<Task>& tasks) override;
+    // 以默认优先级一次加锁入队，放不下的部分按拒绝策略逐个处理。
+    // Abort策略下中途抛出异常时，之前的任务已经入队，不会回滚
+    size_t submitBulk(Task* tasks, size_t count) override;
     bool start() override;
     void stop() override;
     void shutdown() override;
@@ -54,47 +71,83 @@ public:
 
     // 优先级相关接口
     bool submitWithPriority(Task task, int priority);
-    bool submitBatchWithPriority(const std::vector<std::pair<Task, int>>& tasks);
-    
+    // 整批一次加锁入队，放不下的部分按拒绝策略逐个处理（异常语义同submitBulk）
+    bool submitBatchWithPriority(std::vector<std::pair<Task, int>> tasks);
+
     // 设置默认优先级
     void setDefaultPriority(int priority);
     int getDefaultPriority() const;
-    
+
+    // 设置老化间隔，0表示不老化
+    void setAgingInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds getAgingInterval() const;
+
+    // 各优先级统计
+    PriorityLevelStats getLevelStats(int priority) const;
+    std::vector<PriorityLevelStats> getAllLevelStats() const;  // 只包含有过任务的级别
+
     // 设置拒绝策略
     void setRejectionPolicy(RejectionPolicy policy);
 
 private:
+    // 每个级别的原子计数，工作线程执行完任务后直接更新
+    struct LevelCounters {
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> promoted{0};
+        std::atomic<uint64_t> queued{0};
+        std::atomic<uint64_t> totalWaitNs{0};
+        std::atomic<uint64_t> maxWaitNs{0};
+    };
+
     ThreadPoolConfig config_;
     RejectionPolicy rejectionPolicy_;
-    int defaultPriority_;
-    
+    std::atomic<int> defaultPriority_;
+    std::atomic<int64_t> agingIntervalNs_;
+
     std::vector<std::thread> workers_;
-    std::priority_queue<PriorityTask> taskQueue_;
-    
+
+    // 以下由queueMutex_保护
+    std::deque<PriorityTask> levels_[kPriorityLevels];
+    uint32_t nonEmptyLevels_ = 0;  // 第i位表示级别i非空
+    size_t queueSize_ = 0;
+    size_t blockedSubmitters_ = 0;
+    std::chrono::steady_clock::time_point nextAgingScan_;
+
     mutable std::mutex queueMutex_;
     std::condition_variable condition_;
+    std::condition_variable notFullCondition_;
     std::condition_variable terminationCondition_;
-    
+
     std::atomic<bool> running_{false};
     std::atomic<bool> shutdown_{false};
     std::atomic<bool> terminated_{false};
     std::atomic<size_t> activeThreads_{0};
     std::atomic<size_t> completedTasks_{0};
     std::atomic<size_t> rejectedTasks_{0};
-    
+    std::atomic<uint64_t> totalExecutionNs_{0};
+
+    LevelCounters levelCounters_[kPriorityLevels];
+
     // 工作线程函数
     void workerThread(size_t threadId);
-    
-    // 拒绝策略处理
-    bool handleRejection(const Task& task, int priority = 0);
-    
-    // 统计相关
-    mutable std::mutex statsMutex_;
-    std::vector<double> executionTimes_;
-    std::unordered_map<int, size_t> priorityStats_; // 各优先级任务统计
-    
-    void recordTaskExecution(double executionTime, int priority);
-    double calculateAvgExecutionTime() const;
+
+    // 队列操作（调用者持有queueMutex_）
+    static int clampPriority(int priority);
+    void pushLocked(Task task, int priority, std::chrono::steady_clock::time_point now);
+    void pushEntryLocked(PriorityTask entry, int level);
+    PriorityTask popHighestLocked(int& level);
+    PriorityTask popLowestLocked();
+    void ageLocked(std::chrono::steady_clock::time_point now);
+    void clearLocked();
+
+    // submitBulk和submitBatchWithPriority的公共实现：一次加锁入队[0, count)，
+    // 其余按拒绝策略处理，返回成功提交的数量
+    template<typename TaskAt, typename PriorityAt>
+    size_t submitBulkImpl(size_t count, TaskAt taskAt, PriorityAt priorityAt);
+
+    // 拒绝策略处理（不持有queueMutex_时调用）
+    bool handleRejection(Task& task, int priority = 0);
 };
 
-} // namespace ThreadPool 
\ No newline at end of file
+} // namespace ThreadPool
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <thread>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ThreadPool {
+
+// 定时任务的内部状态，由线程池和句柄共享
+struct ScheduledTaskState;
+
+// 定时任务句柄，可拷贝；默认构造或提交失败时为无效句柄
+class ScheduledTaskHandle {
+public:
+    ScheduledTaskHandle() = default;
+    explicit ScheduledTaskHandle(std::shared_ptr<ScheduledTaskState> state)
+        : state_(std::move(state)) {}
+
+    bool valid() const { return state_ != nullptr; }
+
+    // 取消后续执行（正在执行的那一次不会被打断），返回是否由本次调用取消
+    bool cancel();
+    bool isCancelled() const;
+    // 一次性任务已执行、周期任务已取消或因异常终止
+    bool isDone() const;
+    bool isPeriodic() const;
+
+    // 已执行次数
+    size_t getRunCount() const;
+    // 固定频率任务因执行超时而跳过的周期数
+    size_t getMissedRuns() const;
+    // 下一次计划执行的时间
+    std::chrono::steady_clock::time_point getNextRunTime() const;
+
+private:
+    std::shared_ptr<ScheduledTaskState> state_;
+};
+
+// 定时任务线程池实现
+//   - 一个计时线程维护按到期时间排序的最小堆，只在最早到期时间变化时被唤醒
+//   - 到期任务交给工作线程执行，每个到期任务只唤醒一个工作线程
+//   - 固定频率任务按"首次时间 + n * 周期"计算下一次时间，不会累积漂移；
+//     一次执行超过一个周期时跳过错过的周期（计入getMissedRuns），不会补跑也不会并发执行
+//   - 固定延迟任务在上一次执行结束后再等待delay
+//   - 周期任务抛出异常后不再执行
+// shutdown()不再接受新任务，取消尚未到期的定时/周期任务，等待已到期的任务执行完毕。
+class ScheduledThreadPool : public IThreadPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ScheduledThreadPool(const ThreadPoolConfig& config);
+    explicit ScheduledThreadPool(size_t threadCount);
+    ~ScheduledThreadPool() override;
+
+    // IThreadPool接口实现（submit立即执行）
+    bool submit(Task task) override;
+    bool start() override;
+    void stop() override;
+    void shutdown() override;
+    void shutdownNow() override;
+    bool awaitTermination(std::chrono::milliseconds timeout) override;
+    ThreadPoolStats getStats() const override;
+    ThreadPoolConfig getConfig() const override;
+    bool setCorePoolSize(size_t coreSize) override;
+    bool setMaximumPoolSize(size_t maxSize) override;
+    bool isRunning() const override;
+    bool isShutdown() const override;
+    bool isTerminated() const override;
+    std::string getTypeName() const override;
+
+    // 延迟delay后执行一次
+    ScheduledTaskHandle schedule(std::chrono::nanoseconds delay, Task task);
+    // 首次延迟initialDelay，之后每隔period执行一次（以计划时间为基准，不漂移）
+    ScheduledTaskHandle scheduleAtFixedRate(std::chrono::nanoseconds initialDelay,
+                                            std::chrono::nanoseconds period, Task task);
+    // 首次延迟initialDelay，之后每次执行结束后再等待delay
+    ScheduledTaskHandle scheduleWithFixedDelay(std::chrono::nanoseconds initialDelay,
+                                               std::chrono::nanoseconds delay, Task task);
+
+    // 等待执行的定时任务数（含已取消但尚未清理的）
+    size_t getScheduledCount() const;
+    // 立即从计时堆中移除已取消的任务
+    size_t purge();
+
+    // 设置拒绝策略：submit()与FixedThreadPool一致；
+    // schedule系列只区分Abort（抛异常）与其他（返回无效句柄）
+    void setRejectionPolicy(RejectionPolicy policy);
+
+private:
+    struct TimerEntry {
+        Clock::time_point when;
+        uint64_t sequence;  // 同一时间按提交顺序执行
+        std::shared_ptr<ScheduledTaskState> state;
+    };
+    struct TimerEntryLater {
+        bool operator()(const TimerEntry& a, const TimerEntry& b) const {
+            if (a.when != b.when) {
+                return a.when > b.when;
+            }
+            return a.sequence > b.sequence;
+        }
+    };
+
+    ThreadPoolConfig config_;
+    RejectionPolicy rejectionPolicy_;
+
+    std::vector<std::thread> workers_;
+    std::queue<std::shared_ptr<ScheduledTaskState>> readyQueue_;  // 已到期、等待执行
+    size_t blockedSubmitters_ = 0;  // Block策略下等待队列空位的提交者，由queueMutex_保护
+    mutable std::mutex queueMutex_;
+    std::condition_variable condition_;
+    std::condition_variable notFullCondition_;
+    std::condition_variable terminationCondition_;
+
+    // 计时堆与计时线程
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, TimerEntryLater> timerHeap_;
+    mutable std::mutex timerMutex_;
+    std::condition_variable timerCondition_;
+    std::thread timerThread_;
+    uint64_t nextSequence_ = 0;
+    bool timerStop_ = false;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> shutdown_{false};
+    std::atomic<bool> terminated_{false};
+    std::atomic<size_t> activeThreads_{0};
+    std::atomic<size_t> completedTasks_{0};
+    std::atomic<size_t> rejectedTasks_{0};
+    std::atomic<uint64_t> totalExecutionNs_{0};
+
+    // 工作线程与计时线程
+    void workerThread(size_t threadId);
+    void timerThread();
+
+    ScheduledTaskHandle scheduleState(std::shared_ptr<ScheduledTaskState> state);
+    void enqueueTimer(const std::shared_ptr<ScheduledTaskState>& state);
+    void dispatchDue(std::vector<std::shared_ptr<ScheduledTaskState>>& due);
+    void runScheduled(size_t threadId, const std::shared_ptr<ScheduledTaskState>& state);
+    bool hasCapacity() const;
+    void stopTimer(bool cancelPending);
+
+    // 拒绝策略处理
+    bool handleRejection(Task& task);
+    ScheduledTaskHandle rejectSchedule();
+};
+
+} // namespace ThreadPool
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 任务内部缓冲区大小（字节），可在编译时通过 -DTHREADPOOL_TASK_INLINE_SIZE=N 调整
+#ifndef THREADPOOL_TASK_INLINE_SIZE
+#define THREADPOOL_TASK_INLINE_SIZE 64
+#endif
+
+namespace ThreadPool {
+
+// 只能移动的任务类型（类型擦除 + 小缓冲优化）
+// 可调用对象不超过kInlineSize字节、对齐不超过max_align_t且移动构造不抛异常时，
+// 直接存放在内部缓冲区，构造和移动都不分配内存；否则退化为堆分配。
+// 与std::function相比不要求可拷贝，packaged_task、unique_ptr等只能移动的对象也可以直接作为任务。
+class Task {
+public:
+    static const size_t kInlineSize = THREADPOOL_TASK_INLINE_SIZE;
+
+    Task() noexcept : ops_(nullptr) {}
+    Task(std::nullptr_t) noexcept : ops_(nullptr) {}
+
+    template<typename F,
+             typename Functor = typename std::decay<F>::type,
+             typename = typename std::enable_if<!std::is_same<Functor, Task>::value>::type,
+             typename = decltype(std::declval<Functor&>()())>
+    Task(F&& f) : ops_(nullptr) {
+        const Functor& decayed = f;
+        if (isNull(decayed)) {
+            return;
+        }
+        emplace<Functor>(std::forward<F>(f), std::integral_constant<bool, fitsInline<Functor>()>());
+    }
+
+    Task(Task&& other) noexcept : ops_(nullptr) {
+        moveFrom(other);
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Task& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        reset();
+    }
+
+    // 空任务调用时抛出std::bad_function_call，与std::function一致
+    void operator()() {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+        ops_->invoke(&storage_);
+    }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    // 可调用对象是否存放在内部缓冲区（未发生堆分配）
+    bool isInline() const noexcept { return ops_ != nullptr && ops_->inlineStored; }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* dst, void* src);  // 移动到dst并析构src
+        void (*destroy)(void* storage);
+        bool inlineStored;
+    };
+
+    template<typename F>
+    struct InlineOps {
+        static void invoke(void* storage) { (*static_cast<F*>(storage))(); }
+        static void relocate(void* dst, void* src) {
+            F* from = static_cast<F*>(src);
+            ::new (dst) F(std::move(*from));
+            from->~F();
+        }
+        static void destroy(void* storage) { static_cast<F*>(storage)->~F(); }
+        static const Ops ops;
+    };
+
+    template<typename F>
+    struct HeapOps {
+        static F* get(void* storage) { return *static_cast<F**>(storage); }
+        static void invoke(void* storage) { (*get(storage))(); }
+        static void relocate(void* dst, void* src) { ::new (dst) F*(get(src)); }
+        static void destroy(void* storage) { delete get(storage); }
+        static const Ops ops;
+    };
+
+    template<typename F>
+    static constexpr bool fitsInline() {
+        return sizeof(F) <= kInlineSize &&
+               alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+    template<typename Functor, typename F>
+    void emplace(F&& f, std::true_type) {
+        ::new (static_cast<void*>(&storage_)) Functor(std::forward<F>(f));
+        ops_ = &InlineOps<Functor>::ops;
+    }
+
+    template<typename Functor, typename F>
+    void emplace(F&& f, std::false_type) {
+        ::new (static_cast<void*>(&storage_)) Functor*(new Functor(std::forward<F>(f)));
+        ops_ = &HeapOps<Functor>::ops;
+    }
+
+    void moveFrom(Task& other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(&storage_, &other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    // 空函数指针和空std::function构造出空任务
+    template<typename F>
+    static bool isNull(const F&) { return false; }
+    template<typename R, typename... A>
+    static bool isNull(R (*f)(A...)) { return f == nullptr; }
+    template<typename R, typename... A>
+    static bool isNull(const std::function<R(A...)>& f) { return !f; }
+
+    typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type storage_;
+    const Ops* ops_;
+};
+
+template<typename F>
+const Task::Ops Task::InlineOps<F>::ops = {
+    &Task::InlineOps<F>::invoke, &Task::InlineOps<F>::relocate, &Task::InlineOps<F>::destroy, true
+};
+
+template<typename F>
+const Task::Ops Task::HeapOps<F>::ops = {
+    &Task::HeapOps<F>::invoke, &Task::HeapOps<F>::relocate, &Task::HeapOps<F>::destroy, false
+};
+
+} // namespace ThreadPool
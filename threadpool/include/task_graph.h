@@ -0,0 +1,89 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ThreadPool {
+
+// 单个节点的耗时统计
+struct TaskGraphNodeStats {
+    std::string name;
+    size_t runCount = 0;
+    double lastStartMs = 0.0;  // 最近一次相对本轮开始的启动时间
+    double lastMs = 0.0;       // 最近一次执行耗时
+    double avgMs = 0.0;
+    double maxMs = 0.0;
+};
+
+// 任务图（DAG）执行器
+// 节点和依赖边只声明一次，之后可以在任意IThreadPool上反复运行（例如每帧一次）：
+//   - 每个节点持有未完成前驱计数，前驱完成时原子递减，减到0的后继立即就绪，
+//     执行过程中没有任何线程阻塞等待其他节点
+//   - 一个节点完成后释放的多个后继中，最后一个在当前线程上直接继续执行，其余提交给线程池
+//   - 运行前已构建好的图重复运行时不分配内存（节点任务存放在Task内部缓冲区，
+//     提交的闭包只有两个指针大小）；线程池队列本身是否分配取决于队列实现
+//   - 节点抛出异常后，尚未开始的节点被跳过，run()在所有节点结束后重新抛出第一个异常
+// 同一个图不能并发运行；提交被拒绝时节点在当前线程执行，
+// 因此不要与DiscardOldest拒绝策略一起使用（被丢弃的节点永远不会完成）。
+class TaskGraph {
+public:
+    typedef size_t NodeId;
+
+    TaskGraph();
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // 添加节点，返回节点编号
+    NodeId addNode(const std::string& name, Task work);
+    // 添加依赖边：from完成后to才能开始
+    void addEdge(NodeId from, NodeId to);
+
+    // 在线程池上运行一次整个图，所有节点完成后返回；图中有环时抛出std::logic_error
+    void run(IThreadPool& pool);
+
+    size_t size() const { return nodes_.size(); }
+    size_t getRunCount() const { return runCount_; }
+    // 最近一次run()的总耗时
+    double getLastRunTime() const { return lastRunMs_; }
+
+    TaskGraphNodeStats getNodeStats(NodeId id) const;
+    std::vector<TaskGraphNodeStats> getAllNodeStats() const;
+    void resetStats();
+
+private:
+    struct Node;
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<NodeId> roots_;
+    bool prepared_;
+
+    // 本轮运行状态
+    IThreadPool* pool_;
+    std::chrono::steady_clock::time_point runStart_;
+    std::atomic<size_t> remaining_;
+    std::atomic<bool> running_;
+    std::atomic<bool> failed_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable doneCondition_;
+    bool done_;
+
+    size_t runCount_;
+    double lastRunMs_;
+
+    void prepare();
+    void dispatch(NodeId id);
+    void execute(NodeId id);
+    void finishNode();
+    void checkNode(NodeId id) const;
+};
+
+} // namespace ThreadPool
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <string>
+#include <vector>
+
+namespace ThreadPool {
+
+// CPU拓扑：进程可用的CPU及其所在的NUMA节点
+// Linux下从sched_getaffinity和/sys/devices/system/cpu/cpuN/nodeM读取，
+// 读取失败或其他平台时所有CPU都视为节点0。
+struct CpuTopology {
+    std::vector<int> cpus;      // 进程可用的CPU编号，升序
+    std::vector<int> cpuNodes;  // 与cpus一一对应的NUMA节点编号
+    int nodeCount = 1;          // 节点编号最大值 + 1
+
+    // 进程第一次调用时读取，之后返回同一份结果
+    static const CpuTopology& instance();
+
+    // CPU所在的NUMA节点，未知CPU（包括-1）返回0
+    int nodeOf(int cpu) const;
+};
+
+// 按配置计算count个工作线程各自绑定的CPU，不绑定的线程为-1
+// cpuList中不可用的CPU被忽略；线程数多于CPU时循环使用。
+std::vector<int> planWorkerCpus(const ThreadPoolConfig& config, size_t count);
+
+// 把当前线程绑定到指定CPU，失败或不支持时返回false
+bool pinCurrentThread(int cpu);
+
+// 设置当前线程名（Linux限制15个字符，超出部分截断），perf/top/gdb中可见
+void setCurrentThreadName(const std::string& name);
+
+// 工作线程启动时调用：线程名设为"前缀+编号"，并按计划绑定CPU
+// 返回实际绑定的CPU，未绑定返回-1
+int setupWorkerThread(const ThreadPoolConfig& config, size_t index, int cpu);
+int setupWorkerThread(const ThreadPoolConfig& config, size_t index);
+
+} // namespace ThreadPool
@@ -1,16 +1,16 @@
 #pragma once
 
+#include "task.h"
 #include <functional>
 #include <future>
 #include <memory>
 #include <string>
+#include <vector>
 #include <chrono>
+#include <stdexcept>
 
 namespace ThreadPool {
 
-// 任务类型定义
-using Task = std::function<void()>;
-
 // 线程池统计信息
 struct ThreadPoolStats {
     size_t threadCount = 0;         // 线程数量
@@ -21,9 +21,31 @@ struct ThreadPoolStats {
     size_t rejectedTasks = 0;       // 被拒绝的任务数
     double avgExecutionTime = 0.0;  // 平均执行时间（毫秒）
     
+    // 延迟分位数（毫秒），目前由FixedThreadPool提供，其他线程池为0
+    double p50ExecutionTime = 0.0;
+    double p99ExecutionTime = 0.0;
+    double p999ExecutionTime = 0.0;
+    double avgQueueWaitTime = 0.0;  // 从提交到开始执行的等待时间
+    double p50QueueWaitTime = 0.0;
+    double p99QueueWaitTime = 0.0;
+    double p999QueueWaitTime = 0.0;
+    
     std::string toString() const;
 };
 
+// 任务队列实现（目前仅FixedThreadPool支持选择）
+enum class TaskQueueType {
+    Locked,         // std::queue + 互斥量 + 条件变量
+    LockFree        // 有界MPMC无锁环形队列，只在有线程休眠时才触碰条件变量
+};
+
+// 工作线程CPU绑定策略
+enum class AffinityPolicy {
+    None,           // 不绑定，由操作系统调度（指定了cpuList时按Compact处理）
+    Compact,        // 按NUMA节点、CPU编号顺序依次绑定，先填满一个节点再用下一个
+    Scatter         // 轮流分布到各个NUMA节点上
+};
+
 // 线程池配置
 struct ThreadPoolConfig {
     size_t coreThreads = 4;         // 核心线程数
@@ -32,6 +54,11 @@ struct ThreadPoolConfig {
     std::chrono::milliseconds keepAliveTime{60000}; // 空闲线程存活时间
     bool allowCoreThreadTimeout = false;  // 是否允许核心线程超时
     std::string threadNamePrefix = "ThreadPool-"; // 线程名前缀
+    TaskQueueType queueType = TaskQueueType::Locked; // 任务队列实现
+    std::chrono::milliseconds priorityAgingInterval{0}; // 优先级线程池：任务每等待这么久提升一级，0表示不老化
+    AffinityPolicy affinityPolicy = AffinityPolicy::None; // 工作线程CPU绑定策略
+    std::vector<int> cpuList;       // 允许绑定的CPU编号，为空表示进程可用的全部CPU
+    bool numaAware = false;         // 工作窃取线程池：优先窃取同一NUMA节点上的线程
     
     ThreadPoolConfig() = default;
     ThreadPoolConfig(size_t cores, size_t maxQueue = 1000) 
@@ -60,8 +87,17 @@ public:
     auto submitWithResult(F&& f, Args&&... args) 
         -> std::future<typename std::result_of<F(Args...)>::type>;
     
-    // 批量提交任务
-    virtual size_t submitBatch(const std::vector<Task>& tasks) = 0;
+    // 批量提交任务（任务只能移动，调用者需要std::move）
+    size_t submitBatch(std::vector<Task> tasks) {
+        return submitBulk(tasks.data(), tasks.size());
+    }
+    
+    // 批量提交tasks[0, count)，成功提交的任务被移走，返回成功提交（或由调用者执行）的数量。
+    // 默认逐个submit；FixedThreadPool和WorkStealingThreadPool一次加锁入队整批任务，
+    // 只唤醒min(count, 空闲线程数)个线程，队列放不下整批时按拒绝策略整体处理；
+    // PriorityThreadPool一次加锁入队放得下的部分，其余按拒绝策略逐个处理。
+    // Abort策略下中途抛出异常时，已入队的任务不会回滚，整批只部分提交。
+    virtual size_t submitBulk(Task* tasks, size_t count);
     
     // 启动线程池
     virtual bool start() = 0;
@@ -113,14 +149,14 @@ auto IThreadPool::submitWithResult(F&& f, Args&&... args)
     
     using ReturnType = typename std::result_of<F(Args...)>::type;
     
-    auto task = std::make_shared<std::packaged_task<ReturnType()>>(
+    std::packaged_task<ReturnType()> task(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
     
-    std::future<ReturnType> result = task->get_future();
+    std::future<ReturnType> result = task.get_future();
     
-    // 提交包装后的任务
-    bool submitted = submit([task]() { (*task)(); });
+    // packaged_task只能移动，直接放进Task的内部缓冲区，不需要shared_ptr
+    bool submitted = submit(Task(std::move(task)));
     
     if (!submitted) {
         // 如果提交失败，返回一个异常future
@@ -4,6 +4,8 @@
 #include "fixed_thread_pool.h"
 #include "cached_thread_pool.h"
 #include "priority_thread_pool.h"
+#include "work_stealing_thread_pool.h"
+#include "scheduled_thread_pool.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,25 +45,62 @@ public:
     static ThreadPoolType recommendType(UsageScenario scenario);
     static std::string getScenarioDescription(UsageScenario scenario);
     
+    // 基准测试场景
+    enum class BenchmarkScenario {
+        EmptyTasks,         // 空任务，衡量调度开销
+        CpuTasks,           // 每个任务约1微秒计算
+        BlockingTasks,      // 每个任务阻塞100微秒，模拟IO
+        BurstyArrivals,     // 突发提交：一批任务后空闲1毫秒
+        NestedSubmission    // 任务内部再向同一线程池提交子任务
+    };
+    
+    static std::vector<BenchmarkScenario> getAllScenarios();
+    static std::string getScenarioName(BenchmarkScenario scenario);
+    
     // 性能测试和比较
     struct PerformanceMetrics {
         std::string poolType;
-        double avgThroughput;      // 平均吞吐量（任务/秒）
-        double avgLatency;         // 平均延迟（毫秒）
-        double cpuUsage;           // CPU使用率
-        double memoryUsage;        // 内存使用量（MB）
-        size_t completedTasks;     // 完成任务数
+        std::string scenario;
+        size_t threadCount = 0;
+        double avgThroughput = 0.0;    // 平均吞吐量（任务/秒）
+        double avgLatency = 0.0;       // 提交到执行完毕的平均延迟（毫秒）
+        double p50Latency = 0.0;
+        double p99Latency = 0.0;
+        double p999Latency = 0.0;
+        double maxLatency = 0.0;
+        double wallTime = 0.0;         // 第一次提交到最后一个任务完成（毫秒）
+        double userCpuTime = 0.0;      // 期间进程用户态CPU时间（毫秒）
+        double systemCpuTime = 0.0;    // 期间进程内核态CPU时间（毫秒）
+        double cpuUsage = 0.0;         // CPU使用率（CPU时间/墙钟时间，百分比，多核时可超过100%）
+        double memoryUsage = 0.0;      // 本次运行期间的峰值RSS（MB），运行前重置VmHWM
+        long voluntaryContextSwitches = 0;    // 期间主动上下文切换次数
+        long involuntaryContextSwitches = 0;  // 期间被动上下文切换次数
+        size_t completedTasks = 0;     // 完成任务数
+        size_t rejectedTasks = 0;      // 提交失败的任务数
+        bool timedOut = false;         // 超时前没有全部完成
         
         std::string toString() const;
+        std::string toJson() const;
     };
     
-    // 性能基准测试
+    // 性能基准测试：每种线程池类型依次运行所有场景，testDuration是单次运行的超时时间
+    static std::vector<PerformanceMetrics> benchmark(
+        const std::vector<ThreadPoolType>& types,
+        size_t taskCount = 10000,
+        std::chrono::milliseconds testDuration = std::chrono::milliseconds(5000)
+    );
+    
+    // 指定场景的基准测试
     static std::vector<PerformanceMetrics> benchmark(
         const std::vector<ThreadPoolType>& types,
+        const std::vector<BenchmarkScenario>& scenarios,
         size_t taskCount = 10000,
         std::chrono::milliseconds testDuration = std::chrono::milliseconds(5000)
     );
     
+    // 把结果格式化为JSON数组
+    static std::string toJson(const std::vector<PerformanceMetrics>& results);
+    
 private:
     // 禁止实例化
     ThreadPoolFactory() = delete;
@@ -72,6 +111,8 @@ private:
     // 辅助函数
     static size_t getRecommendedThreadCount();
     static ThreadPoolConfig getDefaultConfig(ThreadPoolType type);
+    static PerformanceMetrics runBenchmark(ThreadPoolType type, BenchmarkScenario scenario,
+                                           size_t taskCount, std::chrono::milliseconds timeout);
 };
 
 // 便捷函数
@@ -91,6 +132,14 @@ inline std::unique_ptr<IThreadPool> createPriorityThreadPool(size_t threadCount)
     return ThreadPoolFactory::create(ThreadPoolType::Priority, threadCount);
 }
 
+inline std::unique_ptr<IThreadPool> createWorkStealingThreadPool(size_t threadCount) {
+    return ThreadPoolFactory::create(ThreadPoolType::WorkStealing, threadCount);
+}
+
+inline std::unique_ptr<IThreadPool> createScheduledThreadPool(size_t threadCount) {
+    return ThreadPoolFactory::create(ThreadPoolType::Scheduled, threadCount);
+}
+
 inline std::unique_ptr<IThreadPool> createRecommendedThreadPool(size_t threadCount = 0) {
     return ThreadPoolFactory::createRecommended(threadCount);
 }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ThreadPool {
+
+// Chase-Lev工作窃取双端队列
+// 所有者线程在底部push/pop（LIFO，缓存友好），其他线程从顶部steal（FIFO）。
+// 实现参照 Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)。
+// T必须是可平凡拷贝的类型（通常是指针）。
+// 扩容时旧数组不会立即释放（窃取者可能仍在读取），在队列析构时统一回收。
+template<typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 256)
+        : top_(0), bottom_(0) {
+        size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        Array* array = new Array(cap);
+        arrays_.emplace_back(array);
+        array_.store(array, std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // 仅所有者线程调用
+    void push(T item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(array->capacity) - 1) {
+            array = grow(array, b, t);
+        }
+        array->put(b, item);
+        // release：窃取者acquire读到新的bottom_后一定能看到元素（及任务对象本身）
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // 仅所有者线程调用，队列为空返回false
+    bool pop(T& item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // 队列为空
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = array->get(b);
+        if (t == b) {
+            // 最后一个元素，和窃取者竞争
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // 任意线程调用，队列为空或竞争失败返回false
+    bool steal(T& item) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        T value = array->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;
+        }
+        item = value;
+        return true;
+    }
+
+    // 近似大小，仅用于统计和判断是否有任务
+    size_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return array_.load(std::memory_order_relaxed)->capacity; }
+
+private:
+    // 环形数组，元素用relaxed原子读写避免数据竞争
+    struct Array {
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> buffer;
+
+        explicit Array(size_t cap)
+            : capacity(cap), mask(cap - 1), buffer(new std::atomic<T>[cap]) {}
+
+        T get(int64_t index) const {
+            return buffer[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item) {
+            buffer[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    Array* grow(Array* old, int64_t bottom, int64_t top) {
+        Array* array = new Array(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            array->put(i, old->get(i));
+        }
+        arrays_.emplace_back(array);
+        array_.store(array, std::memory_order_release);
+        return array;
+    }
+
+    // top_和bottom_分别由窃取者和所有者频繁修改，分开到不同缓存行
+    std::atomic<int64_t> top_;
+    char padding0_[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom_;
+    char padding1_[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> arrays_;  // 所有分配过的数组，仅所有者线程修改
+};
+
+} // namespace ThreadPool
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "thread_pool.h"
+#include "work_stealing_deque.h"
+#include <thread>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ThreadPool {
+
+// 工作窃取统计信息
+struct WorkStealingStats {
+    size_t localSubmits = 0;     // 工作线程内提交、进入本地队列的任务数
+    size_t injectorSubmits = 0;  // 外部线程提交、进入共享注入队列的任务数
+    size_t steals = 0;           // 成功窃取的任务数
+    size_t remoteSteals = 0;     // 其中从其他NUMA节点上的线程窃取的任务数
+    size_t failedSteals = 0;     // 窃取失败的轮数（遍历其他线程一轮都没有窃取到）
+    size_t parks = 0;            // 工作线程休眠次数
+
+    std::string toString() const;
+};
+
+// 工作窃取线程池实现
+//   - 每个工作线程有一个Chase-Lev双端队列，任务内提交的子任务进入本地队列（无锁）
+//   - 外部线程提交的任务进入共享注入队列，工作线程每次取走一小批
+//   - 本地队列中的任务节点来自节点池，执行完归还给执行它的线程，预热后提交不再分配内存
+//   - 空闲线程随机选择受害者窃取，多轮失败后指数退避，最后才休眠
+//   - 只有确实有线程休眠时，提交才会触碰休眠用的互斥量和条件变量
+//   - 按ThreadPoolConfig的亲和性配置绑定CPU；numaAware时先窃取同一NUMA节点上的线程，
+//     都失败后才跨节点窃取，任务和本地队列尽量留在同一节点的缓存和内存里
+// 适合任务内部大量派生细粒度子任务的分治/扇出场景。
+// maxQueueSize只限制注入队列，本地队列不设上限（在任务内阻塞等待队列空位会导致死锁）。
+class WorkStealingThreadPool : public IThreadPool {
+public:
+    explicit WorkStealingThreadPool(const ThreadPoolConfig& config);
+    explicit WorkStealingThreadPool(size_t threadCount);
+    ~WorkStealingThreadPool() override;
+
+    // IThreadPool接口实现
+    bool submit(Task task) override;
+    size_t submitBulk(Task* tasks, size_t count) override;
+    bool start() override;
+    void stop() override;
+    void shutdown() override;
+    void shutdownNow() override;
+    bool awaitTermination(std::chrono::milliseconds timeout) override;
+    ThreadPoolStats getStats() const override;
+    ThreadPoolConfig getConfig() const override;
+    bool setCorePoolSize(size_t coreSize) override;
+    bool setMaximumPoolSize(size_t maxSize) override;
+    bool isRunning() const override;
+    bool isShutdown() const override;
+    bool isTerminated() const override;
+    std::string getTypeName() const override;
+
+    // 设置拒绝策略（仅作用于注入队列）
+    void setRejectionPolicy(RejectionPolicy policy);
+
+    // 工作窃取统计
+    WorkStealingStats getStealStats() const;
+
+    // 当前线程是否是本线程池的工作线程
+    bool isWorkerThread() const;
+
+private:
+    // 每个工作线程的状态，计数器只由所属线程写入
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+        std::vector<Task*> freeNodes;  // 空闲的任务节点，只由所属线程访问
+        std::thread thread;
+        uint64_t rngState;
+        uint32_t tick = 0;  // 已取任务的次数，用于定期检查注入队列
+        int cpu = -1;       // 绑定的CPU，-1表示不绑定
+        int node = 0;       // 所在NUMA节点
+        std::atomic<size_t> localSubmits{0};
+        std::atomic<size_t> steals{0};
+        std::atomic<size_t> remoteSteals{0};
+        std::atomic<size_t> failedSteals{0};
+        std::atomic<size_t> parks{0};
+
+        explicit Worker(uint64_t seed) : rngState(seed) {}
+        uint64_t nextRandom();
+    };
+
+    ThreadPoolConfig config_;
+    RejectionPolicy rejectionPolicy_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    mutable std::mutex workersMutex_;  // 保护workers_的创建/清空与统计读取
+
+    // 任务节点池：工作线程之间按批交换空闲节点（窃取会让节点在线程之间流动）
+    std::mutex nodePoolMutex_;
+    std::vector<Task*> sharedNodes_;
+    std::vector<std::unique_ptr<Task[]>> nodeChunks_;  // 所有分配过的节点，线程池析构时释放
+
+    // 共享注入队列
+    mutable std::mutex injectorMutex_;
+    std::deque<Task> injector_;
+    std::atomic<size_t> injectorSize_{0};
+    std::condition_variable injectorNotFull_;  // Block拒绝策略使用
+    std::atomic<size_t> blockedSubmitters_{0};
+    std::atomic<size_t> injectorSubmits_{0};
+
+    // 休眠/唤醒
+    std::mutex parkMutex_;
+    std::condition_variable parkCondition_;
+    std::atomic<size_t> sleepers_{0};
+
+    std::mutex terminationMutex_;
+    std::condition_variable terminationCondition_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> shutdown_{false};
+    std::atomic<bool> stopNow_{false};
+    std::atomic<bool> terminated_{false};
+    std::atomic<size_t> activeThreads_{0};
+    std::atomic<size_t> completedTasks_{0};
+    std::atomic<size_t> rejectedTasks_{0};
+    std::atomic<uint64_t> totalExecutionNs_{0};
+
+    // 工作线程函数
+    void workerThread(size_t index);
+    bool findTask(size_t index, Task*& task);
+    bool takeFromInjector(Worker& self, Task*& task);
+    bool trySteal(size_t index, Task*& task);
+    // numaAware时只遍历同节点（sameNode）或只遍历其他节点的线程，否则遍历所有线程
+    bool stealFrom(size_t index, bool sameNode, Task*& task);
+    bool park(size_t index);
+    bool hasWork() const;
+    void runTask(size_t index, Task* task);
+
+    // 从所属线程的空闲节点中取一个节点，不够时从共享池按批补充
+    Task* acquireNode(Worker& self);
+    // 归还执行完的节点，空闲节点过多时按批交还共享池
+    void releaseNode(Worker& self, Task* node);
+
+    // 唤醒一个休眠的工作线程（没有休眠线程时不触碰锁）
+    void wakeOne();
+    // 唤醒min(count, 休眠线程数)个工作线程
+    void wakeMany(size_t count);
+    bool pushToInjector(Task& task);
+    bool pushBulkToInjector(Task* tasks, size_t count);
+
+    // 拒绝策略处理
+    bool handleRejection(Task& task);
+    size_t handleBulkRejection(Task* tasks, size_t count);
+
+    void joinAllWorkers();
+    void clearAllQueues();
+};
+
+} // namespace ThreadPool
@@ -1,4 +1,5 @@
 #include "../include/cached_thread_pool.h"
+#include "../include/thread_affinity.h"
 #include <algorithm>
 #include <chrono>
 
@@ -43,16 +44,6 @@ bool CachedThreadPool::submit(Task task) {
     return true;
 }
 
-size_t CachedThreadPool::submitBatch(const std::vector<Task>& tasks) {
-    size_t submitted = 0;
-    for (const auto& task : tasks) {
-        if (submit(task)) {
-            submitted++;
-        }
-    }
-    return submitted;
-}
-
 bool CachedThreadPool::start() {
     if (running_) {
         return false;
@@ -85,7 +76,11 @@ void CachedThreadPool::shutdown() {
 
 void CachedThreadPool::shutdownNow() {
     shutdown_ = true;
-    cleanupRunning_ = false;
+    {
+        std::lock_guard<std::mutex> lock(cleanupMutex_);
+        cleanupRunning_ = false;
+    }
+    cleanupCondition_.notify_all();
     
     // 清空任务队列
     {
@@ -169,6 +164,7 @@ void CachedThreadPool::setRejectionPolicy(RejectionPolicy policy) {
 }
 
 void CachedThreadPool::workerThread(size_t workerId) {
+    setupWorkerThread(config_, workerId);
     while (!shutdown_) {
         Task task;
         
@@ -267,17 +263,21 @@ bool CachedThreadPool::createNewWorker() {
 }
 
 void CachedThreadPool::joinAllWorkers() {
-    std::lock_guard<std::mutex> lock(workersMutex_);
+    // 工作线程执行完任务后要获取workersMutex_更新空闲状态，不能持锁join
+    std::vector<std::unique_ptr<WorkerInfo>> workers;
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        workers.swap(workers_);
+    }
     
-    for (auto& worker : workers_) {
+    for (auto& worker : workers) {
         if (worker && worker->thread.joinable()) {
             worker->thread.join();
         }
     }
-    workers_.clear();
 }
 
-bool CachedThreadPool::handleRejection(const Task& task) {
+bool CachedThreadPool::handleRejection(Task& task) {
     rejectedTasks_++;
     
     switch (rejectionPolicy_) {
@@ -299,7 +299,7 @@ bool CachedThreadPool::handleRejection(const Task& task) {
             std::lock_guard<std::mutex> lock(queueMutex_);
             if (!taskQueue_.empty()) {
                 taskQueue_.pop();
-                taskQueue_.push(task);
+                taskQueue_.push(std::move(task));
                 return true;
             }
             return false;
@@ -335,12 +335,18 @@ double CachedThreadPool::calculateAvgExecutionTime() const {
 }
 
 void CachedThreadPool::cleanupWorker() {
+    std::unique_lock<std::mutex> lock(cleanupMutex_);
     while (cleanupRunning_) {
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+        // 每5秒清理一次；关闭时被立即唤醒，shutdownNow()不必等满一个周期
+        if (cleanupCondition_.wait_for(lock, std::chrono::seconds(5), [this] { return !cleanupRunning_; })) {
+            break;
+        }
         
+        lock.unlock();
         if (!shutdown_) {
             cleanupIdleThreads();
         }
+        lock.lock();
     }
 }
 
@@ -1,10 +1,27 @@
 #include "../include/fixed_thread_pool.h"
+#include "../include/thread_affinity.h"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
 
 namespace ThreadPool {
 
+namespace {
+
+const int kSpinRounds = 64;  // 无锁模式下休眠前的自旋次数
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // namespace
+
 FixedThreadPool::FixedThreadPool(const ThreadPoolConfig& config) 
     : config_(config), rejectionPolicy_(RejectionPolicy::Abort) {
     
@@ -14,7 +31,17 @@ FixedThreadPool::FixedThreadPool(const ThreadPoolConfig& config)
     }
     config_.maxThreads = config_.coreThreads; // 固定线程池大小相等
     
-    std::cout << "创建固定线程池，线程数: " << config_.coreThreads << std::endl;
+    workerStats_.reserve(config_.coreThreads);
+    for (size_t i = 0; i < config_.coreThreads; ++i) {
+        workerStats_.emplace_back(new WorkerStats());
+    }
+    
+    if (config_.queueType == TaskQueueType::LockFree) {
+        lockFreeQueue_.reset(new BoundedMPMCQueue<QueuedTask>(config_.maxQueueSize));
+    }
+    
+    std::cout << "创建固定线程池，线程数: " << config_.coreThreads
+              << (lockFreeQueue_ ? "（无锁队列）" : "") << std::endl;
 }
 
 FixedThreadPool::FixedThreadPool(size_t threadCount) 
@@ -32,30 +59,75 @@ bool FixedThreadPool::submit(Task task) {
         return handleRejection(task);
     }
     
+    QueuedTask item{std::move(task), std::chrono::steady_clock::now()};
+    
+    if (lockFreeQueue_) {
+        if (lockFreeQueue_->tryPush(item)) {
+            wakeOne();
+            return true;
+        }
+        return handleRejection(item.task);
+    }
+    
     {
         std::unique_lock<std::mutex> lock(queueMutex_);
         
-        if (taskQueue_.size() >= config_.maxQueueSize) {
-            return handleRejection(task);
+        if (taskQueue_.size() < config_.maxQueueSize) {
+            taskQueue_.push(std::move(item));
+            lock.unlock();
+            condition_.notify_one();
+            return true;
         }
-        
-        taskQueue_.push(std::move(task));
     }
     
-    condition_.notify_one();
-    return true;
+    // 释放队列锁后再处理拒绝，DiscardOldest和Block需要重新加锁
+    return handleRejection(item.task);
+}
+
+size_t FixedThreadPool::submitBulk(Task* tasks, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    
+    if (shutdown_ || !running_) {
+        return handleBulkRejection(tasks, count);
+    }
+    
+    if (enqueueBulk(tasks, count, std::chrono::steady_clock::now())) {
+        return count;
+    }
+    
+    return handleBulkRejection(tasks, count);
 }
 
-size_t FixedThreadPool::submitBatch(const std::vector<Task>& tasks) {
-    size_t submitted = 0;
+bool FixedThreadPool::enqueueBulk(Task* tasks, size_t count, std::chrono::steady_clock::time_point now) {
+    if (lockFreeQueue_) {
+        // 一次CAS占用整批位置
+        bool pushed = lockFreeQueue_->tryPushBulk(count, [tasks, now](size_t i) {
+            return QueuedTask{std::move(tasks[i]), now};
+        });
+        if (pushed) {
+            wakeMany(count);
+        }
+        return pushed;
+    }
     
-    for (const auto& task : tasks) {
-        if (submit(task)) {
-            ++submitted;
+    size_t wakeups = 0;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        if (taskQueue_.size() + count > config_.maxQueueSize) {
+            return false;
         }
+        for (size_t i = 0; i < count; ++i) {
+            taskQueue_.push(QueuedTask{std::move(tasks[i]), now});
+        }
+        wakeups = std::min(count, idleWorkers_);
     }
     
-    return submitted;
+    for (size_t i = 0; i < wakeups; ++i) {
+        condition_.notify_one();
+    }
+    return true;
 }
 
 bool FixedThreadPool::start() {
@@ -94,6 +166,8 @@ void FixedThreadPool::shutdown() {
     }
     
     condition_.notify_all();
+    notFullCondition_.notify_all();
+    wakeAll();
     
     // 等待所有线程完成
     for (auto& worker : workers_) {
@@ -122,11 +196,19 @@ void FixedThreadPool::shutdownNow() {
         shutdown_ = true;
         
         // 清空队列中的任务
-        std::queue<Task> empty;
+        std::queue<QueuedTask> empty;
         taskQueue_.swap(empty);
     }
     
+    if (lockFreeQueue_) {
+        QueuedTask discarded;
+        while (lockFreeQueue_->tryPop(discarded)) {
+        }
+    }
+    
     condition_.notify_all();
+    notFullCondition_.notify_all();
+    wakeAll();
     
     // 等待所有线程完成
     for (auto& worker : workers_) {
@@ -149,16 +231,19 @@ bool FixedThreadPool::awaitTermination(std::chrono::milliseconds timeout) {
 }
 
 ThreadPoolStats FixedThreadPool::getStats() const {
-    std::unique_lock<std::mutex> lock(queueMutex_);
-    
     ThreadPoolStats stats;
     stats.threadCount = config_.coreThreads;
     stats.activeThreads = activeThreads_.load();
-    stats.queueSize = taskQueue_.size();
+    if (lockFreeQueue_) {
+        stats.queueSize = lockFreeQueue_->size();
+    } else {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        stats.queueSize = taskQueue_.size();
+    }
     stats.maxQueueSize = config_.maxQueueSize;
     stats.completedTasks = completedTasks_.load();
     stats.rejectedTasks = rejectedTasks_.load();
-    stats.avgExecutionTime = calculateAvgExecutionTime();
+    fillLatencyStats(stats); // 合并直方图不需要持有队列锁
     
     return stats;
 }
@@ -200,61 +285,169 @@ void FixedThreadPool::setRejectionPolicy(RejectionPolicy policy) {
 }
 
 void FixedThreadPool::workerThread(size_t threadId) {
+    setupWorkerThread(config_, threadId);
     std::cout << "工作线程 " << threadId << " 启动" << std::endl;
     
+    if (lockFreeQueue_) {
+        lockFreeWorkerLoop(threadId);
+        std::cout << "工作线程 " << threadId << " 退出" << std::endl;
+        return;
+    }
+    
     while (true) {
-        Task task;
+        QueuedTask item;
         
         {
             std::unique_lock<std::mutex> lock(queueMutex_);
-            condition_.wait(lock, [this] { return shutdown_.load() || !taskQueue_.empty(); });
+            while (!shutdown_.load() && taskQueue_.empty()) {
+                ++idleWorkers_;
+                condition_.wait(lock);
+                --idleWorkers_;
+            }
             
             if (shutdown_.load() && taskQueue_.empty()) {
                 break;
             }
             
             if (!taskQueue_.empty()) {
-                task = std::move(taskQueue_.front());
+                item = std::move(taskQueue_.front());
                 taskQueue_.pop();
+                if (blockedSubmitters_ > 0) {
+                    notFullCondition_.notify_all();
+                }
             }
         }
         
-        if (task) {
-            ++activeThreads_;
-            recordTaskStart();
-            
-            auto start = std::chrono::high_resolution_clock::now();
-            
-            try {
-                task();
-            } catch (const std::exception& e) {
-                std::cerr << "线程 " << threadId << " 任务执行异常: " << e.what() << std::endl;
-            } catch (...) {
-                std::cerr << "线程 " << threadId << " 任务执行未知异常" << std::endl;
-            }
-            
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            
-            recordTaskEnd();
-            
-            {
-                std::unique_lock<std::mutex> lock(statsMutex_);
-                executionTimes_.push_back(duration.count() / 1000.0); // 转换为毫秒
-                if (executionTimes_.size() > 1000) { // 限制统计数据大小
-                    executionTimes_.erase(executionTimes_.begin());
-                }
-            }
-            
-            ++completedTasks_;
-            --activeThreads_;
+        if (item.task) {
+            runTask(threadId, item);
         }
     }
     
     std::cout << "工作线程 " << threadId << " 退出" << std::endl;
 }
 
-bool FixedThreadPool::handleRejection(const Task& task) {
+void FixedThreadPool::lockFreeWorkerLoop(size_t threadId) {
+    QueuedTask item;
+    while (waitForLockFreeTask(item)) {
+        wakeBlockedProducers();
+        runTask(threadId, item);
+        item.task = nullptr;
+    }
+}
+
+bool FixedThreadPool::waitForLockFreeTask(QueuedTask& item) {
+    int spins = 0;
+    while (true) {
+        if (lockFreeQueue_->tryPop(item)) {
+            return true;
+        }
+        
+        // 生产者可能已占位但尚未写入，队列非空时继续等待
+        if (shutdown_.load() && lockFreeQueue_->empty()) {
+            return false;
+        }
+        
+        if (spins < kSpinRounds) {
+            ++spins;
+            cpuRelax();
+            continue;
+        }
+        
+        park();
+        spins = 0;
+    }
+}
+
+void FixedThreadPool::park() {
+    std::unique_lock<std::mutex> lock(parkMutex_);
+    sleepers_.fetch_add(1);
+    // 与wakeOne()中的"任务已发布 -> 检查sleepers_"配对，两边都有全屏障
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    while (!shutdown_.load() && lockFreeQueue_->empty()) {
+        parkCondition_.wait(lock);
+    }
+    
+    sleepers_.fetch_sub(1);
+}
+
+void FixedThreadPool::wakeOne() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCondition_.notify_one();
+    }
+}
+
+void FixedThreadPool::wakeMany(size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_t sleepers = sleepers_.load(std::memory_order_relaxed);
+    if (sleepers == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(parkMutex_);
+    for (size_t i = 0; i < std::min(count, sleepers); ++i) {
+        parkCondition_.notify_one();
+    }
+}
+
+void FixedThreadPool::wakeAll() {
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+    }
+    parkCondition_.notify_all();
+}
+
+bool FixedThreadPool::waitForLockFreeSpace(size_t count) {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    blockedProducers_.fetch_add(1);
+    // 与wakeBlockedProducers()中的"任务已取出 -> 检查blockedProducers_"配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    size_t capacity = lockFreeQueue_->capacity();
+    notFullCondition_.wait(lock, [this, count, capacity] {
+        return shutdown_.load() || lockFreeQueue_->size() + count <= capacity;
+    });
+    
+    blockedProducers_.fetch_sub(1);
+    return !shutdown_.load();
+}
+
+void FixedThreadPool::wakeBlockedProducers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (blockedProducers_.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+        }
+        notFullCondition_.notify_all();
+    }
+}
+
+void FixedThreadPool::runTask(size_t threadId, QueuedTask& item) {
+    ++activeThreads_;
+    WorkerStats& workerStats = *workerStats_[threadId];
+    
+    auto start = std::chrono::steady_clock::now();
+    workerStats.queueWait.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - item.enqueueTime).count()));
+    
+    try {
+        item.task();
+    } catch (const std::exception& e) {
+        std::cerr << "线程 " << threadId << " 任务执行异常: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "线程 " << threadId << " 任务执行未知异常" << std::endl;
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    workerStats.executionTime.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    
+    ++completedTasks_;
+    --activeThreads_;
+}
+
+bool FixedThreadPool::handleRejection(Task& task) {
     ++rejectedTasks_;
     
     switch (rejectionPolicy_) {
@@ -266,11 +459,21 @@ bool FixedThreadPool::handleRejection(const Task& task) {
             return false;
             
         case RejectionPolicy::DiscardOldest:
+            if (lockFreeQueue_) {
+                QueuedTask oldest;
+                QueuedTask copy{std::move(task), std::chrono::steady_clock::now()};
+                lockFreeQueue_->tryPop(oldest); // 丢弃最旧的任务
+                if (lockFreeQueue_->tryPush(copy)) {
+                    wakeOne();
+                    return true;
+                }
+                return false;
+            }
             {
                 std::unique_lock<std::mutex> lock(queueMutex_);
                 if (!taskQueue_.empty()) {
                     taskQueue_.pop(); // 丢弃最旧的任务
-                    taskQueue_.push(task);
+                    taskQueue_.push(QueuedTask{std::move(task), std::chrono::steady_clock::now()});
                     lock.unlock();
                     condition_.notify_one();
                     return true;
@@ -287,17 +490,31 @@ bool FixedThreadPool::handleRejection(const Task& task) {
             }
             
         case RejectionPolicy::Block:
+            if (lockFreeQueue_) {
+                QueuedTask copy{std::move(task), std::chrono::steady_clock::now()};
+                while (true) {
+                    if (lockFreeQueue_->tryPush(copy)) {
+                        wakeOne();
+                        return true;
+                    }
+                    if (!waitForLockFreeSpace(1)) {
+                        return false;
+                    }
+                }
+            }
             {
                 std::unique_lock<std::mutex> lock(queueMutex_);
-                condition_.wait(lock, [this] { 
+                ++blockedSubmitters_;
+                notFullCondition_.wait(lock, [this] { 
                     return shutdown_.load() || taskQueue_.size() < config_.maxQueueSize; 
                 });
+                --blockedSubmitters_;
                 
                 if (shutdown_.load()) {
                     return false;
                 }
                 
-                taskQueue_.push(task);
+                taskQueue_.push(QueuedTask{std::move(task), std::chrono::steady_clock::now()});
                 lock.unlock();
                 condition_.notify_one();
                 return true;
@@ -307,27 +524,109 @@ bool FixedThreadPool::handleRejection(const Task& task) {
     return false;
 }
 
-void FixedThreadPool::recordTaskStart() {
-    // 可以在这里记录任务开始时间
-}
-
-void FixedThreadPool::recordTaskEnd() {
-    // 可以在这里记录任务结束时间
-}
-
-double FixedThreadPool::calculateAvgExecutionTime() const {
-    std::unique_lock<std::mutex> lock(statsMutex_);
+size_t FixedThreadPool::handleBulkRejection(Task* tasks, size_t count) {
+    rejectedTasks_ += count;
+    
+    // 队列能容纳的最大批量（无锁队列容量是向上取整后的2的幂）
+    size_t capacity = lockFreeQueue_ ? lockFreeQueue_->capacity() : config_.maxQueueSize;
     
-    if (executionTimes_.empty()) {
-        return 0.0;
+    switch (rejectionPolicy_) {
+        case RejectionPolicy::Abort:
+            throw std::runtime_error("批量任务被拒绝：队列空间不足");
+            
+        case RejectionPolicy::Discard:
+            std::cerr << "批量任务被丢弃：队列空间不足，任务数: " << count << std::endl;
+            return 0;
+            
+        case RejectionPolicy::DiscardOldest:
+            if (shutdown_.load() || count > capacity) {
+                return 0;
+            }
+            if (lockFreeQueue_) {
+                // 丢弃足够多的最旧任务腾出整批空间，并发提交可能再次占满，此时放弃
+                QueuedTask oldest;
+                size_t used = lockFreeQueue_->size();
+                size_t excess = used + count > capacity ? used + count - capacity : 0;
+                for (size_t i = 0; i < excess; ++i) {
+                    lockFreeQueue_->tryPop(oldest);
+                }
+                return enqueueBulk(tasks, count, std::chrono::steady_clock::now()) ? count : 0;
+            }
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                while (!taskQueue_.empty() && taskQueue_.size() + count > config_.maxQueueSize) {
+                    taskQueue_.pop(); // 丢弃最旧的任务
+                }
+            }
+            return enqueueBulk(tasks, count, std::chrono::steady_clock::now()) ? count : 0;
+            
+        case RejectionPolicy::CallerRuns:
+            {
+                size_t ran = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    try {
+                        tasks[i](); // 在调用者线程中执行
+                        ++ran;
+                    } catch (...) {
+                    }
+                }
+                return ran;
+            }
+            
+        case RejectionPolicy::Block:
+            {
+                // 批量不超过队列容量时等待整批空间；超过时按队列容量分段入队
+                size_t submitted = 0;
+                while (submitted < count && !shutdown_.load()) {
+                    size_t chunk = std::min(count - submitted, capacity);
+                    if (lockFreeQueue_) {
+                        if (!enqueueBulk(tasks + submitted, chunk, std::chrono::steady_clock::now())) {
+                            if (!waitForLockFreeSpace(chunk)) {
+                                break;
+                            }
+                            continue;
+                        }
+                    } else {
+                        {
+                            std::unique_lock<std::mutex> lock(queueMutex_);
+                            ++blockedSubmitters_;
+                            notFullCondition_.wait(lock, [this, chunk] {
+                                return shutdown_.load() || taskQueue_.size() + chunk <= config_.maxQueueSize;
+                            });
+                            --blockedSubmitters_;
+                            if (shutdown_.load()) {
+                                break;
+                            }
+                        }
+                        if (!enqueueBulk(tasks + submitted, chunk, std::chrono::steady_clock::now())) {
+                            continue; // 被其他提交者抢先占用，重新等待
+                        }
+                    }
+                    submitted += chunk;
+                }
+                return submitted;
+            }
     }
     
-    double sum = 0.0;
-    for (double time : executionTimes_) {
-        sum += time;
+    return 0;
+}
+
+void FixedThreadPool::fillLatencyStats(ThreadPoolStats& stats) const {
+    LatencySnapshot execution;
+    LatencySnapshot queueWait;
+    for (const auto& workerStats : workerStats_) {
+        workerStats->executionTime.addTo(execution);
+        workerStats->queueWait.addTo(queueWait);
     }
     
-    return sum / executionTimes_.size();
+    stats.avgExecutionTime = execution.meanMs();
+    stats.p50ExecutionTime = execution.percentileMs(0.50);
+    stats.p99ExecutionTime = execution.percentileMs(0.99);
+    stats.p999ExecutionTime = execution.percentileMs(0.999);
+    stats.avgQueueWaitTime = queueWait.meanMs();
+    stats.p50QueueWaitTime = queueWait.percentileMs(0.50);
+    stats.p99QueueWaitTime = queueWait.percentileMs(0.99);
+    stats.p999QueueWaitTime = queueWait.percentileMs(0.999);
 }
 
 } // namespace ThreadPool 
\ No newline at end of file
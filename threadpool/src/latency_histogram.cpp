@@ -0,0 +1,95 @@
+#include "../include/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ThreadPool {
+
+const int LatencyHistogram::kSubBucketBits;
+const int LatencyHistogram::kMaxValueBits;
+const size_t LatencyHistogram::kSubBucketCount;
+const size_t LatencyHistogram::kBucketCount;
+
+LatencyHistogram::LatencyHistogram() {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+    total_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueNs) {
+    if (valueNs < kSubBucketCount) {
+        return static_cast<size_t>(valueNs);  // 最低区间逐一计数
+    }
+    const uint64_t maxValue = (uint64_t(1) << kMaxValueBits) - 1;
+    if (valueNs > maxValue) {
+        valueNs = maxValue;
+    }
+    int msb = 63 - __builtin_clzll(valueNs);
+    int shift = msb - kSubBucketBits;
+    size_t sub = static_cast<size_t>(valueNs >> shift) & (kSubBucketCount - 1);
+    return (static_cast<size_t>(shift) + 1) * kSubBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    size_t shift = index / kSubBucketCount - 1;
+    uint64_t sub = index % kSubBucketCount;
+    uint64_t lower = (kSubBucketCount + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::addTo(LatencySnapshot& snapshot) const {
+    if (snapshot.counts.size() != kBucketCount) {
+        snapshot.counts.assign(kBucketCount, 0);
+    }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.total += total_.load(std::memory_order_relaxed);
+    snapshot.sumNs += sumNs_.load(std::memory_order_relaxed);
+    snapshot.maxNs = std::max(snapshot.maxNs, maxNs_.load(std::memory_order_relaxed));
+}
+
+double LatencySnapshot::percentileMs(double q) const {
+    if (counts.empty()) {
+        return 0.0;
+    }
+
+    // 各桶计数与total分别读取，以桶计数之和为准
+    uint64_t recorded = 0;
+    for (uint64_t c : counts) {
+        recorded += c;
+    }
+    if (recorded == 0) {
+        return 0.0;
+    }
+
+    q = std::min(1.0, std::max(0.0, q));
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * recorded));
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint64_t value = LatencyHistogram::bucketUpperBound(i);
+            if (maxNs > 0) {
+                value = std::min(value, maxNs);
+            }
+            return value / 1e6;
+        }
+    }
+    return maxNs / 1e6;
+}
+
+double LatencySnapshot::meanMs() const {
+    return total > 0 ? sumNs / 1e6 / total : 0.0;
+}
+
+} // namespace ThreadPool
@@ -1,11 +1,30 @@
 #include "../include/priority_thread_pool.h"
+#include "../include/thread_affinity.h"
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 
 namespace ThreadPool {
 
+const int PriorityThreadPool::kPriorityLevels;
+const int PriorityThreadPool::kMinPriority;
+const int PriorityThreadPool::kMaxPriority;
+
+namespace {
+
+void updateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
 PriorityThreadPool::PriorityThreadPool(const ThreadPoolConfig& config) 
-    : config_(config), rejectionPolicy_(RejectionPolicy::Abort), defaultPriority_(0) {
+    : config_(config), rejectionPolicy_(RejectionPolicy::Abort), defaultPriority_(0),
+      agingIntervalNs_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          config.priorityAgingInterval).count()) {
     
     if (config_.coreThreads == 0) {
         config_.coreThreads = 1;
@@ -37,35 +56,57 @@ bool PriorityThreadPool::submitWithPriority(Task task, int priority) {
     {
         std::unique_lock<std::mutex> lock(queueMutex_);
         
-        if (taskQueue_.size() >= config_.maxQueueSize) {
+        if (queueSize_ >= config_.maxQueueSize) {
+            lock.unlock();
             return handleRejection(task, priority);
         }
         
-        taskQueue_.emplace(std::move(task), priority);
+        pushLocked(std::move(task), priority, std::chrono::steady_clock::now());
     }
     
     condition_.notify_one();
     return true;
 }
 
-size_t PriorityThreadPool::submitBatch(const std::vector<Task>& tasks) {
-    size_t submitted = 0;
-    for (const auto& task : tasks) {
-        if (submit(task)) {
+template<typename TaskAt, typename PriorityAt>
+size_t PriorityThreadPool::submitBulkImpl(size_t count, TaskAt taskAt, PriorityAt priorityAt) {
+    size_t accepted = 0;
+    if (!shutdown_.load() && running_.load()) {
+        auto now = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        while (accepted < count && queueSize_ < config_.maxQueueSize) {
+            pushLocked(std::move(taskAt(accepted)), priorityAt(accepted), now);
+            ++accepted;
+        }
+    }
+    
+    // 唤醒的线程数不超过入队的任务数
+    size_t wakeups = std::min(accepted, workers_.size());
+    for (size_t i = 0; i < wakeups; ++i) {
+        condition_.notify_one();
+    }
+    
+    // Abort策略在这里抛出时，前面accepted个任务已经入队
+    size_t submitted = accepted;
+    for (size_t i = accepted; i < count; ++i) {
+        if (handleRejection(taskAt(i), priorityAt(i))) {
             ++submitted;
         }
     }
     return submitted;
 }
 
-bool PriorityThreadPool::submitBatchWithPriority(const std::vector<std::pair<Task, int>>& tasks) {
-    size_t submitted = 0;
-    for (const auto& taskPair : tasks) {
-        if (submitWithPriority(taskPair.first, taskPair.second)) {
-            ++submitted;
-        }
-    }
-    return submitted == tasks.size();
+size_t PriorityThreadPool::submitBulk(Task* tasks, size_t count) {
+    int priority = defaultPriority_.load();
+    return submitBulkImpl(count,
+                          [tasks](size_t i) -> Task& { return tasks[i]; },
+                          [priority](size_t) { return priority; });
+}
+
+bool PriorityThreadPool::submitBatchWithPriority(std::vector<std::pair<Task, int>> tasks) {
+    return submitBulkImpl(tasks.size(),
+                          [&tasks](size_t i) -> Task& { return tasks[i].first; },
+                          [&tasks](size_t i) { return tasks[i].second; }) == tasks.size();
 }
 
 bool PriorityThreadPool::start() {
@@ -103,6 +144,7 @@ void PriorityThreadPool::shutdown() {
     }
     
     condition_.notify_all();
+    notFullCondition_.notify_all();
     
     for (auto& worker : workers_) {
         if (worker.joinable()) {
@@ -130,11 +172,11 @@ void PriorityThreadPool::shutdownNow() {
         shutdown_ = true;
         
         // 清空队列
-        std::priority_queue<PriorityTask> empty;
-        taskQueue_.swap(empty);
+        clearLocked();
     }
     
     condition_.notify_all();
+    notFullCondition_.notify_all();
     
     for (auto& worker : workers_) {
         if (worker.joinable()) {
@@ -161,11 +203,13 @@ ThreadPoolStats PriorityThreadPool::getStats() const {
     ThreadPoolStats stats;
     stats.threadCount = config_.coreThreads;
     stats.activeThreads = activeThreads_.load();
-    stats.queueSize = taskQueue_.size();
+    stats.queueSize = queueSize_;
     stats.maxQueueSize = config_.maxQueueSize;
     stats.completedTasks = completedTasks_.load();
     stats.rejectedTasks = rejectedTasks_.load();
-    stats.avgExecutionTime = calculateAvgExecutionTime();
+    if (stats.completedTasks > 0) {
+        stats.avgExecutionTime = totalExecutionNs_.load() / 1e6 / stats.completedTasks;
+    }
     
     return stats;
 }
@@ -208,58 +252,195 @@ int PriorityThreadPool::getDefaultPriority() const {
     return defaultPriority_;
 }
 
+void PriorityThreadPool::setAgingInterval(std::chrono::milliseconds interval) {
+    agingIntervalNs_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count());
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    config_.priorityAgingInterval = interval;
+    nextAgingScan_ = std::chrono::steady_clock::time_point();
+}
+
+std::chrono::milliseconds PriorityThreadPool::getAgingInterval() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds(agingIntervalNs_.load()));
+}
+
+PriorityLevelStats PriorityThreadPool::getLevelStats(int priority) const {
+    int level = clampPriority(priority);
+    const LevelCounters& counters = levelCounters_[level];
+    
+    PriorityLevelStats stats;
+    stats.priority = level;
+    stats.submitted = counters.submitted.load(std::memory_order_relaxed);
+    stats.completed = counters.completed.load(std::memory_order_relaxed);
+    stats.promoted = counters.promoted.load(std::memory_order_relaxed);
+    stats.queued = counters.queued.load(std::memory_order_relaxed);
+    stats.maxWaitTime = counters.maxWaitNs.load(std::memory_order_relaxed) / 1e6;
+    if (stats.completed > 0) {
+        stats.avgWaitTime = counters.totalWaitNs.load(std::memory_order_relaxed) / 1e6 / stats.completed;
+    }
+    return stats;
+}
+
+std::vector<PriorityLevelStats> PriorityThreadPool::getAllLevelStats() const {
+    std::vector<PriorityLevelStats> result;
+    for (int level = kMaxPriority; level >= kMinPriority; --level) {
+        PriorityLevelStats stats = getLevelStats(level);
+        if (stats.submitted > 0 || stats.queued > 0) {
+            result.push_back(stats);
+        }
+    }
+    return result;
+}
+
 void PriorityThreadPool::setRejectionPolicy(RejectionPolicy policy) {
     rejectionPolicy_ = policy;
 }
 
+int PriorityThreadPool::clampPriority(int priority) {
+    return std::max(kMinPriority, std::min(kMaxPriority, priority));
+}
+
+void PriorityThreadPool::pushLocked(Task task, int priority, std::chrono::steady_clock::time_point now) {
+    int level = clampPriority(priority);
+    levelCounters_[level].submitted.fetch_add(1, std::memory_order_relaxed);
+    pushEntryLocked(PriorityTask(std::move(task), level, now), level);
+    ++queueSize_;
+}
+
+void PriorityThreadPool::pushEntryLocked(PriorityTask entry, int level) {
+    levels_[level].push_back(std::move(entry));
+    nonEmptyLevels_ |= uint32_t(1) << level;
+    levelCounters_[level].queued.fetch_add(1, std::memory_order_relaxed);
+}
+
+PriorityTask PriorityThreadPool::popHighestLocked(int& level) {
+    level = 31 - __builtin_clz(nonEmptyLevels_);  // 最高的非空级别
+    std::deque<PriorityTask>& queue = levels_[level];
+    PriorityTask entry = std::move(queue.front());
+    queue.pop_front();
+    if (queue.empty()) {
+        nonEmptyLevels_ &= ~(uint32_t(1) << level);
+    }
+    levelCounters_[level].queued.fetch_sub(1, std::memory_order_relaxed);
+    --queueSize_;
+    return entry;
+}
+
+PriorityTask PriorityThreadPool::popLowestLocked() {
+    int level = __builtin_ctz(nonEmptyLevels_);  // 最低的非空级别
+    std::deque<PriorityTask>& queue = levels_[level];
+    PriorityTask entry = std::move(queue.front());
+    queue.pop_front();
+    if (queue.empty()) {
+        nonEmptyLevels_ &= ~(uint32_t(1) << level);
+    }
+    levelCounters_[level].queued.fetch_sub(1, std::memory_order_relaxed);
+    --queueSize_;
+    return entry;
+}
+
+void PriorityThreadPool::ageLocked(std::chrono::steady_clock::time_point now) {
+    std::chrono::nanoseconds interval(agingIntervalNs_.load(std::memory_order_relaxed));
+    
+    // 从高到低处理，刚提升上来的任务本轮不会再次提升；
+    // 每个级别按进入时间排序，只需检查队首
+    for (int level = kMaxPriority - 1; level >= kMinPriority; --level) {
+        if (!(nonEmptyLevels_ & (uint32_t(1) << level))) {
+            continue;
+        }
+        std::deque<PriorityTask>& queue = levels_[level];
+        while (!queue.empty() && now - queue.front().levelTime >= interval) {
+            PriorityTask entry = std::move(queue.front());
+            queue.pop_front();
+            levelCounters_[level].queued.fetch_sub(1, std::memory_order_relaxed);
+            levelCounters_[level].promoted.fetch_add(1, std::memory_order_relaxed);
+            entry.levelTime = now;
+            pushEntryLocked(std::move(entry), level + 1);
+        }
+        if (queue.empty()) {
+            nonEmptyLevels_ &= ~(uint32_t(1) << level);
+        }
+    }
+}
+
+void PriorityThreadPool::clearLocked() {
+    for (int level = kMinPriority; level <= kMaxPriority; ++level) {
+        levelCounters_[level].queued.store(0, std::memory_order_relaxed);
+        levels_[level].clear();
+    }
+    nonEmptyLevels_ = 0;
+    queueSize_ = 0;
+}
+
 void PriorityThreadPool::workerThread(size_t threadId) {
+    setupWorkerThread(config_, threadId);
     std::cout << "优先级工作线程 " << threadId << " 启动" << std::endl;
     
     while (true) {
-        PriorityTask priorityTask([](){}, 0);
+        Task task;
+        int priority = 0;
+        std::chrono::steady_clock::time_point submitTime;
+        std::chrono::steady_clock::time_point dequeueTime;
         
         {
             std::unique_lock<std::mutex> lock(queueMutex_);
-            condition_.wait(lock, [this] { return shutdown_.load() || !taskQueue_.empty(); });
+            condition_.wait(lock, [this] { return shutdown_.load() || queueSize_ > 0; });
             
-            if (shutdown_.load() && taskQueue_.empty()) {
-                break;
+            if (queueSize_ == 0) {
+                break;  // 已关闭且队列为空
             }
             
-            if (!taskQueue_.empty()) {
-                priorityTask = std::move(const_cast<PriorityTask&>(taskQueue_.top()));
-                taskQueue_.pop();
+            // 老化扫描最多每半个间隔进行一次
+            dequeueTime = std::chrono::steady_clock::now();
+            int64_t agingNs = agingIntervalNs_.load(std::memory_order_relaxed);
+            if (agingNs > 0 && dequeueTime >= nextAgingScan_) {
+                ageLocked(dequeueTime);
+                nextAgingScan_ = dequeueTime + std::chrono::nanoseconds(agingNs / 2);
             }
-        }
-        
-        if (priorityTask.task) {
-            ++activeThreads_;
             
-            auto start = std::chrono::high_resolution_clock::now();
+            int level = 0;
+            PriorityTask entry = popHighestLocked(level);
+            task = std::move(entry.task);
+            priority = entry.priority;
+            submitTime = entry.submitTime;
             
-            try {
-                priorityTask.task();
-            } catch (const std::exception& e) {
-                std::cerr << "优先级线程 " << threadId << " 任务执行异常: " << e.what() << std::endl;
-            } catch (...) {
-                std::cerr << "优先级线程 " << threadId << " 任务执行未知异常" << std::endl;
+            if (blockedSubmitters_ > 0) {
+                notFullCondition_.notify_one();
             }
-            
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            
-            recordTaskExecution(duration.count() / 1000.0, priorityTask.priority);
-            
-            ++completedTasks_;
-            --activeThreads_;
         }
+        
+        LevelCounters& counters = levelCounters_[priority];
+        uint64_t waitNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(dequeueTime - submitTime).count());
+        counters.totalWaitNs.fetch_add(waitNs, std::memory_order_relaxed);
+        updateMax(counters.maxWaitNs, waitNs);
+        
+        ++activeThreads_;
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "优先级线程 " << threadId << " 任务执行异常: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "优先级线程 " << threadId << " 任务执行未知异常" << std::endl;
+        }
+        
+        auto end = std::chrono::steady_clock::now();
+        totalExecutionNs_.fetch_add(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+            std::memory_order_relaxed);
+        counters.completed.fetch_add(1, std::memory_order_relaxed);
+        
+        ++completedTasks_;
+        --activeThreads_;
     }
     
     std::cout << "优先级工作线程 " << threadId << " 退出" << std::endl;
 }
 
-bool PriorityThreadPool::handleRejection(const Task& task, int priority) {
-    (void)priority; // 消除未使用参数警告
+bool PriorityThreadPool::handleRejection(Task& task, int priority) {
     ++rejectedTasks_;
     
     switch (rejectionPolicy_) {
@@ -272,10 +453,12 @@ bool PriorityThreadPool::handleRejection(const Task& task, int priority) {
             
         case RejectionPolicy::DiscardOldest:
             {
+                Task discarded;
                 std::unique_lock<std::mutex> lock(queueMutex_);
-                if (!taskQueue_.empty()) {
-                    taskQueue_.pop(); // 丢弃最高优先级的任务
-                    taskQueue_.emplace(task, priority);
+                if (queueSize_ > 0) {
+                    // 丢弃最低优先级中等待最久的任务
+                    discarded = std::move(popLowestLocked().task);
+                    pushLocked(std::move(task), priority, std::chrono::steady_clock::now());
                     lock.unlock();
                     condition_.notify_one();
                     return true;
@@ -294,15 +477,17 @@ bool PriorityThreadPool::handleRejection(const Task& task, int priority) {
         case RejectionPolicy::Block:
             {
                 std::unique_lock<std::mutex> lock(queueMutex_);
-                condition_.wait(lock, [this] { 
-                    return shutdown_.load() || taskQueue_.size() < config_.maxQueueSize; 
+                ++blockedSubmitters_;
+                notFullCondition_.wait(lock, [this] { 
+                    return shutdown_.load() || queueSize_ < config_.maxQueueSize; 
                 });
+                --blockedSubmitters_;
                 
                 if (shutdown_.load()) {
                     return false;
                 }
                 
-                taskQueue_.emplace(task, priority);
+                pushLocked(std::move(task), priority, std::chrono::steady_clock::now());
                 lock.unlock();
                 condition_.notify_one();
                 return true;
@@ -312,30 +497,4 @@ bool PriorityThreadPool::handleRejection(const Task& task, int priority) {
     return false;
 }
 
-void PriorityThreadPool::recordTaskExecution(double executionTime, int priority) {
-    std::unique_lock<std::mutex> lock(statsMutex_);
-    
-    executionTimes_.push_back(executionTime);
-    if (executionTimes_.size() > 1000) {
-        executionTimes_.erase(executionTimes_.begin());
-    }
-    
-    priorityStats_[priority]++;
-}
-
-double PriorityThreadPool::calculateAvgExecutionTime() const {
-    std::unique_lock<std::mutex> lock(statsMutex_);
-    
-    if (executionTimes_.empty()) {
-        return 0.0;
-    }
-    
-    double sum = 0.0;
-    for (double time : executionTimes_) {
-        sum += time;
-    }
-    
-    return sum / executionTimes_.size();
-}
-
-} // namespace ThreadPool 
\ No newline at end of file
+} // namespace ThreadPool
@@ -0,0 +1,597 @@
+#include "../include/scheduled_thread_pool.h"
+#include "../include/thread_affinity.h"
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace ThreadPool {
+
+// 定时任务状态：计划时间和计数器用原子变量，句柄可以在任意线程查询
+struct ScheduledTaskState {
+    enum class Kind {
+        OneShot,     // 执行一次
+        FixedRate,   // 固定频率
+        FixedDelay   // 固定延迟
+    };
+
+    Task task;
+    Kind kind;
+    std::chrono::nanoseconds period;
+    std::atomic<int64_t> nextRunNs;  // 下一次计划执行时间（steady_clock纪元起的纳秒数）
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> done{false};
+    std::atomic<size_t> runCount{0};
+    std::atomic<size_t> missedRuns{0};
+
+    ScheduledTaskState(Task t, Kind k, std::chrono::nanoseconds p,
+                       ScheduledThreadPool::Clock::time_point firstRun)
+        : task(std::move(t)), kind(k), period(p), nextRunNs(toNs(firstRun)) {}
+
+    ScheduledThreadPool::Clock::time_point nextRun() const {
+        return ScheduledThreadPool::Clock::time_point(
+            std::chrono::duration_cast<ScheduledThreadPool::Clock::duration>(
+                std::chrono::nanoseconds(nextRunNs.load())));
+    }
+
+    static int64_t toNs(ScheduledThreadPool::Clock::time_point tp) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    }
+};
+
+// ==================== ScheduledTaskHandle ====================
+
+bool ScheduledTaskHandle::cancel() {
+    if (!state_) {
+        return false;
+    }
+    bool expected = false;
+    return state_->cancelled.compare_exchange_strong(expected, true);
+}
+
+bool ScheduledTaskHandle::isCancelled() const {
+    return state_ && state_->cancelled.load();
+}
+
+bool ScheduledTaskHandle::isDone() const {
+    return state_ && (state_->done.load() || state_->cancelled.load());
+}
+
+bool ScheduledTaskHandle::isPeriodic() const {
+    return state_ && state_->kind != ScheduledTaskState::Kind::OneShot;
+}
+
+size_t ScheduledTaskHandle::getRunCount() const {
+    return state_ ? state_->runCount.load() : 0;
+}
+
+size_t ScheduledTaskHandle::getMissedRuns() const {
+    return state_ ? state_->missedRuns.load() : 0;
+}
+
+std::chrono::steady_clock::time_point ScheduledTaskHandle::getNextRunTime() const {
+    return state_ ? state_->nextRun() : std::chrono::steady_clock::time_point();
+}
+
+// ==================== ScheduledThreadPool ====================
+
+ScheduledThreadPool::ScheduledThreadPool(const ThreadPoolConfig& config)
+    : config_(config), rejectionPolicy_(RejectionPolicy::Abort) {
+
+    if (config_.coreThreads == 0) {
+        config_.coreThreads = 1;
+    }
+    config_.maxThreads = config_.coreThreads; // 固定线程数
+
+    std::cout << "创建定时任务线程池，线程数: " << config_.coreThreads << std::endl;
+}
+
+ScheduledThreadPool::ScheduledThreadPool(size_t threadCount)
+    : ScheduledThreadPool(ThreadPoolConfig(threadCount)) {
+}
+
+ScheduledThreadPool::~ScheduledThreadPool() {
+    if (running_) {
+        shutdownNow();
+    }
+}
+
+bool ScheduledThreadPool::submit(Task task) {
+    if (shutdown_ || !running_) {
+        return handleRejection(task);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        if (readyQueue_.size() < config_.maxQueueSize) {
+            readyQueue_.push(std::make_shared<ScheduledTaskState>(
+                std::move(task), ScheduledTaskState::Kind::OneShot,
+                std::chrono::nanoseconds::zero(), Clock::now()));
+            lock.unlock();
+            condition_.notify_one();
+            return true;
+        }
+    }
+
+    return handleRejection(task);
+}
+
+ScheduledTaskHandle ScheduledThreadPool::schedule(std::chrono::nanoseconds delay, Task task) {
+    return scheduleState(std::make_shared<ScheduledTaskState>(
+        std::move(task), ScheduledTaskState::Kind::OneShot,
+        std::chrono::nanoseconds::zero(), Clock::now() + delay));
+}
+
+ScheduledTaskHandle ScheduledThreadPool::scheduleAtFixedRate(std::chrono::nanoseconds initialDelay,
+                                                             std::chrono::nanoseconds period,
+                                                             Task task) {
+    if (period <= std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("scheduleAtFixedRate: 周期必须大于0");
+    }
+    return scheduleState(std::make_shared<ScheduledTaskState>(
+        std::move(task), ScheduledTaskState::Kind::FixedRate, period, Clock::now() + initialDelay));
+}
+
+ScheduledTaskHandle ScheduledThreadPool::scheduleWithFixedDelay(std::chrono::nanoseconds initialDelay,
+                                                                std::chrono::nanoseconds delay,
+                                                                Task task) {
+    if (delay < std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("scheduleWithFixedDelay: 延迟不能为负");
+    }
+    return scheduleState(std::make_shared<ScheduledTaskState>(
+        std::move(task), ScheduledTaskState::Kind::FixedDelay, delay, Clock::now() + initialDelay));
+}
+
+ScheduledTaskHandle ScheduledThreadPool::scheduleState(std::shared_ptr<ScheduledTaskState> state) {
+    if (shutdown_ || !running_ || !hasCapacity()) {
+        return rejectSchedule();
+    }
+    enqueueTimer(state);
+    return ScheduledTaskHandle(std::move(state));
+}
+
+bool ScheduledThreadPool::hasCapacity() const {
+    size_t pending = getScheduledCount();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        pending += readyQueue_.size();
+    }
+    return pending < config_.maxQueueSize;
+}
+
+void ScheduledThreadPool::enqueueTimer(const std::shared_ptr<ScheduledTaskState>& state) {
+    bool earliest = false;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        if (timerStop_) {
+            state->done = true;
+            return;
+        }
+        Clock::time_point when = state->nextRun();
+        earliest = timerHeap_.empty() || when < timerHeap_.top().when;
+        timerHeap_.push(TimerEntry{when, nextSequence_++, state});
+    }
+
+    // 只有最早到期时间提前时才需要唤醒计时线程
+    if (earliest) {
+        timerCondition_.notify_one();
+    }
+}
+
+void ScheduledThreadPool::timerThread() {
+    setCurrentThreadName(config_.threadNamePrefix + "timer");
+    std::vector<std::shared_ptr<ScheduledTaskState>> due;
+    std::unique_lock<std::mutex> lock(timerMutex_);
+
+    while (!timerStop_) {
+        if (timerHeap_.empty()) {
+            timerCondition_.wait(lock);
+            continue;
+        }
+
+        // wait_until会释放锁，期间入队可能使堆重新分配，因此先复制到期时间，
+        // 不在释放锁之后继续使用堆顶的引用
+        Clock::time_point when;
+        {
+            const TimerEntry& top = timerHeap_.top();
+            if (top.state->cancelled) {
+                top.state->done = true;
+                timerHeap_.pop();
+                continue;
+            }
+            when = top.when;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (when > now) {
+            timerCondition_.wait_until(lock, when);
+            continue;
+        }
+
+        // 取出所有到期任务，释放锁后再交给工作线程
+        while (!timerHeap_.empty() && timerHeap_.top().when <= now) {
+            const std::shared_ptr<ScheduledTaskState>& state = timerHeap_.top().state;
+            if (state->cancelled) {
+                state->done = true;
+            } else {
+                due.push_back(state);
+            }
+            timerHeap_.pop();
+        }
+
+        lock.unlock();
+        dispatchDue(due);
+        due.clear();
+        lock.lock();
+    }
+}
+
+void ScheduledThreadPool::dispatchDue(std::vector<std::shared_ptr<ScheduledTaskState>>& due) {
+    if (due.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        for (auto& state : due) {
+            readyQueue_.push(std::move(state));
+        }
+    }
+
+    // 每个到期任务唤醒一个工作线程，不惊动其余线程
+    size_t wakeups = std::min(due.size(), workers_.size());
+    for (size_t i = 0; i < wakeups; ++i) {
+        condition_.notify_one();
+    }
+}
+
+bool ScheduledThreadPool::start() {
+    if (running_) {
+        return false;
+    }
+
+    running_ = true;
+    shutdown_ = false;
+    terminated_ = false;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timerStop_ = false;
+    }
+
+    workers_.reserve(config_.coreThreads);
+    for (size_t i = 0; i < config_.coreThreads; ++i) {
+        workers_.emplace_back(&ScheduledThreadPool::workerThread, this, i);
+    }
+    timerThread_ = std::thread(&ScheduledThreadPool::timerThread, this);
+
+    std::cout << "定时任务线程池已启动，线程数: " << config_.coreThreads << std::endl;
+    return true;
+}
+
+void ScheduledThreadPool::stop() {
+    shutdown();
+}
+
+void ScheduledThreadPool::stopTimer(bool cancelPending) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timerStop_ = true;
+        while (!timerHeap_.empty()) {
+            if (cancelPending) {
+                timerHeap_.top().state->cancelled = true;
+            }
+            timerHeap_.top().state->done = true;
+            timerHeap_.pop();
+        }
+    }
+    timerCondition_.notify_all();
+
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+}
+
+void ScheduledThreadPool::shutdown() {
+    if (!running_ || shutdown_) {
+        return;
+    }
+
+    std::cout << "正在关闭定时任务线程池..." << std::endl;
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        shutdown_ = true;
+    }
+
+    // 尚未到期的定时/周期任务不再执行，已到期的任务执行完毕后退出
+    stopTimer(true);
+    condition_.notify_all();
+    notFullCondition_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    workers_.clear();
+    running_ = false;
+    terminated_ = true;
+
+    terminationCondition_.notify_all();
+    std::cout << "定时任务线程池已关闭" << std::endl;
+}
+
+void ScheduledThreadPool::shutdownNow() {
+    if (!running_) {
+        return;
+    }
+
+    std::cout << "正在强制关闭定时任务线程池..." << std::endl;
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        shutdown_ = true;
+
+        // 清空已到期但尚未执行的任务
+        while (!readyQueue_.empty()) {
+            readyQueue_.front()->cancelled = true;
+            readyQueue_.front()->done = true;
+            readyQueue_.pop();
+        }
+    }
+
+    stopTimer(true);
+    condition_.notify_all();
+    notFullCondition_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    workers_.clear();
+    running_ = false;
+    terminated_ = true;
+
+    terminationCondition_.notify_all();
+    std::cout << "定时任务线程池已强制关闭" << std::endl;
+}
+
+bool ScheduledThreadPool::awaitTermination(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    return terminationCondition_.wait_for(lock, timeout, [this] { return terminated_.load(); });
+}
+
+ThreadPoolStats ScheduledThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.threadCount = config_.coreThreads;
+    stats.activeThreads = activeThreads_.load();
+    stats.maxQueueSize = config_.maxQueueSize;
+    stats.completedTasks = completedTasks_.load();
+    stats.rejectedTasks = rejectedTasks_.load();
+
+    size_t queued = getScheduledCount();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queued += readyQueue_.size();
+    }
+    stats.queueSize = queued;
+
+    if (stats.completedTasks > 0) {
+        stats.avgExecutionTime = totalExecutionNs_.load() / 1e6 / stats.completedTasks;
+    }
+    return stats;
+}
+
+ThreadPoolConfig ScheduledThreadPool::getConfig() const {
+    return config_;
+}
+
+bool ScheduledThreadPool::setCorePoolSize(size_t coreSize) {
+    (void)coreSize; // 消除未使用参数警告
+    // 定时任务线程池不支持动态调整
+    return false;
+}
+
+bool ScheduledThreadPool::setMaximumPoolSize(size_t maxSize) {
+    (void)maxSize; // 消除未使用参数警告
+    // 定时任务线程池不支持动态调整
+    return false;
+}
+
+bool ScheduledThreadPool::isRunning() const {
+    return running_;
+}
+
+bool ScheduledThreadPool::isShutdown() const {
+    return shutdown_;
+}
+
+bool ScheduledThreadPool::isTerminated() const {
+    return terminated_;
+}
+
+std::string ScheduledThreadPool::getTypeName() const {
+    return "ScheduledThreadPool";
+}
+
+size_t ScheduledThreadPool::getScheduledCount() const {
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    return timerHeap_.size();
+}
+
+size_t ScheduledThreadPool::purge() {
+    std::lock_guard<std::mutex> lock(timerMutex_);
+
+    std::vector<TimerEntry> kept;
+    kept.reserve(timerHeap_.size());
+    size_t removed = 0;
+    while (!timerHeap_.empty()) {
+        const TimerEntry& entry = timerHeap_.top();
+        if (entry.state->cancelled) {
+            entry.state->done = true;
+            ++removed;
+        } else {
+            kept.push_back(entry);
+        }
+        timerHeap_.pop();
+    }
+    for (auto& entry : kept) {
+        timerHeap_.push(std::move(entry));
+    }
+    return removed;
+}
+
+void ScheduledThreadPool::setRejectionPolicy(RejectionPolicy policy) {
+    rejectionPolicy_ = policy;
+}
+
+void ScheduledThreadPool::workerThread(size_t threadId) {
+    setupWorkerThread(config_, threadId);
+    while (true) {
+        std::shared_ptr<ScheduledTaskState> state;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            condition_.wait(lock, [this] { return shutdown_.load() || !readyQueue_.empty(); });
+
+            if (shutdown_.load() && readyQueue_.empty()) {
+                break;
+            }
+
+            state = std::move(readyQueue_.front());
+            readyQueue_.pop();
+
+            if (blockedSubmitters_ > 0) {
+                notFullCondition_.notify_one();
+            }
+        }
+
+        runScheduled(threadId, state);
+    }
+}
+
+void ScheduledThreadPool::runScheduled(size_t threadId, const std::shared_ptr<ScheduledTaskState>& state) {
+    if (state->cancelled) {
+        state->done = true;
+        return;
+    }
+
+    ++activeThreads_;
+    Clock::time_point start = Clock::now();
+
+    bool failed = false;
+    try {
+        state->task();
+    } catch (const std::exception& e) {
+        std::cerr << "定时线程 " << threadId << " 任务执行异常: " << e.what() << std::endl;
+        failed = true;
+    } catch (...) {
+        std::cerr << "定时线程 " << threadId << " 任务执行未知异常" << std::endl;
+        failed = true;
+    }
+
+    Clock::time_point end = Clock::now();
+    totalExecutionNs_.fetch_add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    ++state->runCount;
+    ++completedTasks_;
+    --activeThreads_;
+
+    // 一次性任务、异常、取消或关闭后不再调度
+    if (state->kind == ScheduledTaskState::Kind::OneShot || failed ||
+        state->cancelled || shutdown_) {
+        state->done = true;
+        return;
+    }
+
+    Clock::time_point next;
+    if (state->kind == ScheduledTaskState::Kind::FixedRate) {
+        // 以上一次的计划时间为基准，不受执行耗时和调度延迟影响
+        next = state->nextRun() + state->period;
+        if (next <= end) {
+            // 已经错过了若干个周期：跳到下一个未来的周期点，保持原有相位
+            auto behind = std::chrono::duration_cast<std::chrono::nanoseconds>(end - next);
+            size_t skipped = static_cast<size_t>(behind / state->period) + 1;
+            next += state->period * static_cast<int64_t>(skipped);
+            state->missedRuns += skipped;
+        }
+    } else {
+        next = end + state->period;
+    }
+
+    state->nextRunNs = ScheduledTaskState::toNs(next);
+    enqueueTimer(state);
+}
+
+bool ScheduledThreadPool::handleRejection(Task& task) {
+    ++rejectedTasks_;
+
+    switch (rejectionPolicy_) {
+        case RejectionPolicy::Abort:
+            throw std::runtime_error("任务被拒绝：队列已满");
+
+        case RejectionPolicy::Discard:
+            std::cerr << "任务被丢弃：队列已满" << std::endl;
+            return false;
+
+        case RejectionPolicy::DiscardOldest:
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                if (shutdown_ || readyQueue_.empty()) {
+                    return false;
+                }
+                readyQueue_.front()->cancelled = true; // 丢弃最旧的任务
+                readyQueue_.front()->done = true;
+                readyQueue_.pop();
+                readyQueue_.push(std::make_shared<ScheduledTaskState>(
+                    std::move(task), ScheduledTaskState::Kind::OneShot,
+                    std::chrono::nanoseconds::zero(), Clock::now()));
+            }
+            condition_.notify_one();
+            return true;
+
+        case RejectionPolicy::CallerRuns:
+            try {
+                task(); // 在调用者线程中执行
+                return true;
+            } catch (...) {
+                return false;
+            }
+
+        case RejectionPolicy::Block:
+            {
+                // 工作线程取出任务后通知等待的提交者
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                ++blockedSubmitters_;
+                notFullCondition_.wait(lock, [this] {
+                    return shutdown_.load() || !running_.load() || readyQueue_.size() < config_.maxQueueSize;
+                });
+                --blockedSubmitters_;
+
+                if (shutdown_.load() || !running_.load()) {
+                    return false;
+                }
+
+                readyQueue_.push(std::make_shared<ScheduledTaskState>(
+                    std::move(task), ScheduledTaskState::Kind::OneShot,
+                    std::chrono::nanoseconds::zero(), Clock::now()));
+                lock.unlock();
+                condition_.notify_one();
+                return true;
+            }
+    }
+
+    return false;
+}
+
+ScheduledTaskHandle ScheduledThreadPool::rejectSchedule() {
+    ++rejectedTasks_;
+    if (rejectionPolicy_ == RejectionPolicy::Abort) {
+        throw std::runtime_error("定时任务被拒绝：线程池未运行或队列已满");
+    }
+    return ScheduledTaskHandle();
+}
+
+} // namespace ThreadPool
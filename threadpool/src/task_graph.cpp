@@ -0,0 +1,257 @@
+#include "../include/task_graph.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ThreadPool {
+
+struct TaskGraph::Node {
+    std::string name;
+    Task work;
+    std::vector<NodeId> successors;
+    size_t dependencies = 0;
+    std::atomic<size_t> pending{0};
+
+    // 每轮只有执行该节点的线程写入，统计读取时可能与写入并发
+    std::atomic<uint64_t> runs{0};
+    std::atomic<uint64_t> lastStartNs{0};
+    std::atomic<uint64_t> lastNs{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+};
+
+TaskGraph::TaskGraph()
+    : prepared_(false), pool_(nullptr), remaining_(0), running_(false), failed_(false),
+      done_(false), runCount_(0), lastRunMs_(0.0) {}
+
+TaskGraph::~TaskGraph() = default;
+
+TaskGraph::NodeId TaskGraph::addNode(const std::string& name, Task work) {
+    if (running_.load()) {
+        throw std::logic_error("TaskGraph: 运行中不能修改图");
+    }
+    std::unique_ptr<Node> node(new Node());
+    node->name = name;
+    node->work = std::move(work);
+    nodes_.push_back(std::move(node));
+    prepared_ = false;
+    return nodes_.size() - 1;
+}
+
+void TaskGraph::addEdge(NodeId from, NodeId to) {
+    if (running_.load()) {
+        throw std::logic_error("TaskGraph: 运行中不能修改图");
+    }
+    checkNode(from);
+    checkNode(to);
+    if (from == to) {
+        throw std::logic_error("TaskGraph: 节点不能依赖自己");
+    }
+    nodes_[from]->successors.push_back(to);
+    ++nodes_[to]->dependencies;
+    prepared_ = false;
+}
+
+void TaskGraph::checkNode(NodeId id) const {
+    if (id >= nodes_.size()) {
+        throw std::invalid_argument("TaskGraph: 无效的节点编号");
+    }
+}
+
+void TaskGraph::prepare() {
+    // Kahn拓扑排序检查是否有环，同时记录入度为0的根节点
+    std::vector<size_t> indegree(nodes_.size());
+    std::vector<NodeId> ready;
+    roots_.clear();
+    for (NodeId i = 0; i < nodes_.size(); ++i) {
+        indegree[i] = nodes_[i]->dependencies;
+        if (indegree[i] == 0) {
+            roots_.push_back(i);
+            ready.push_back(i);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeId id = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (NodeId next : nodes_[id]->successors) {
+            if (--indegree[next] == 0) {
+                ready.push_back(next);
+            }
+        }
+    }
+    if (visited != nodes_.size()) {
+        throw std::logic_error("TaskGraph: 图中存在环");
+    }
+    prepared_ = true;
+}
+
+void TaskGraph::run(IThreadPool& pool) {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+        throw std::logic_error("TaskGraph: 同一个图不能并发运行");
+    }
+
+    try {
+        if (!prepared_) {
+            prepare();
+        }
+    } catch (...) {
+        running_.store(false);
+        throw;
+    }
+
+    if (nodes_.empty()) {
+        running_.store(false);
+        ++runCount_;
+        lastRunMs_ = 0.0;
+        return;
+    }
+
+    pool_ = &pool;
+    error_ = nullptr;
+    failed_.store(false, std::memory_order_relaxed);
+    done_ = false;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        nodes_[i]->pending.store(nodes_[i]->dependencies, std::memory_order_relaxed);
+    }
+    remaining_.store(nodes_.size(), std::memory_order_relaxed);
+    runStart_ = std::chrono::steady_clock::now();
+
+    // 其余根节点交给线程池，最后一个根节点由调用线程直接执行
+    for (size_t i = 0; i + 1 < roots_.size(); ++i) {
+        dispatch(roots_[i]);
+    }
+    execute(roots_.back());
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCondition_.wait(lock, [this] { return done_; });
+    }
+
+    lastRunMs_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - runStart_).count();
+    ++runCount_;
+    pool_ = nullptr;
+
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    running_.store(false);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGraph::dispatch(NodeId id) {
+    Task task([this, id]() { execute(id); });
+    bool submitted = false;
+    try {
+        submitted = pool_->submit(std::move(task));
+    } catch (...) {
+        submitted = false;
+    }
+    if (!submitted) {
+        // 被拒绝（或线程池未运行）时在当前线程执行，保证整个图能够完成
+        execute(id);
+    }
+}
+
+void TaskGraph::execute(NodeId id) {
+    while (true) {
+        Node& node = *nodes_[id];
+
+        if (!failed_.load(std::memory_order_relaxed)) {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                node.work();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                failed_.store(true, std::memory_order_relaxed);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            uint64_t elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            node.lastStartNs.store(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - runStart_).count()),
+                std::memory_order_relaxed);
+            node.lastNs.store(elapsed, std::memory_order_relaxed);
+            node.totalNs.store(node.totalNs.load(std::memory_order_relaxed) + elapsed,
+                               std::memory_order_relaxed);
+            if (elapsed > node.maxNs.load(std::memory_order_relaxed)) {
+                node.maxNs.store(elapsed, std::memory_order_relaxed);
+            }
+            node.runs.store(node.runs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // 释放后继：除最后一个就绪的后继外都交给线程池，最后一个在当前线程继续执行
+        const NodeId none = nodes_.size();
+        NodeId next = none;
+        for (NodeId successor : node.successors) {
+            if (nodes_[successor]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (next != none) {
+                    dispatch(next);
+                }
+                next = successor;
+            }
+        }
+
+        // 最后一个节点完成后调用线程可能立即返回，之后不能再访问图
+        finishNode();
+        if (next == none) {
+            return;
+        }
+        id = next;
+    }
+}
+
+void TaskGraph::finishNode() {
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        doneCondition_.notify_all();
+    }
+}
+
+TaskGraphNodeStats TaskGraph::getNodeStats(NodeId id) const {
+    checkNode(id);
+    const Node& node = *nodes_[id];
+    TaskGraphNodeStats stats;
+    stats.name = node.name;
+    stats.runCount = static_cast<size_t>(node.runs.load(std::memory_order_relaxed));
+    stats.lastStartMs = node.lastStartNs.load(std::memory_order_relaxed) / 1e6;
+    stats.lastMs = node.lastNs.load(std::memory_order_relaxed) / 1e6;
+    stats.maxMs = node.maxNs.load(std::memory_order_relaxed) / 1e6;
+    if (stats.runCount > 0) {
+        stats.avgMs = node.totalNs.load(std::memory_order_relaxed) / 1e6 / stats.runCount;
+    }
+    return stats;
+}
+
+std::vector<TaskGraphNodeStats> TaskGraph::getAllNodeStats() const {
+    std::vector<TaskGraphNodeStats> result;
+    result.reserve(nodes_.size());
+    for (NodeId i = 0; i < nodes_.size(); ++i) {
+        result.push_back(getNodeStats(i));
+    }
+    return result;
+}
+
+void TaskGraph::resetStats() {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        Node& node = *nodes_[i];
+        node.runs.store(0, std::memory_order_relaxed);
+        node.lastStartNs.store(0, std::memory_order_relaxed);
+        node.lastNs.store(0, std::memory_order_relaxed);
+        node.totalNs.store(0, std::memory_order_relaxed);
+        node.maxNs.store(0, std::memory_order_relaxed);
+    }
+    runCount_ = 0;
+    lastRunMs_ = 0.0;
+}
+
+} // namespace ThreadPool
@@ -0,0 +1,170 @@
+#include "../include/thread_affinity.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ThreadPool {
+
+namespace {
+
+#ifdef __linux__
+// /sys/devices/system/cpu/cpuN下有名为nodeM的链接，M即该CPU的NUMA节点
+int readCpuNode(int cpu) {
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return 0;
+    }
+    int node = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 &&
+            entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+#endif
+
+CpuTopology loadTopology() {
+    CpuTopology topology;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                int node = readCpuNode(cpu);
+                topology.cpus.push_back(cpu);
+                topology.cpuNodes.push_back(node);
+                topology.nodeCount = std::max(topology.nodeCount, node + 1);
+            }
+        }
+    }
+#endif
+    if (topology.cpus.empty()) {
+        topology.cpus.push_back(0);
+        topology.cpuNodes.push_back(0);
+    }
+    return topology;
+}
+
+// 按策略排好的候选CPU，第i个工作线程绑定到第(i % 数量)个
+std::vector<int> orderedCpus(const ThreadPoolConfig& config) {
+    std::vector<int> ordered;
+    if (config.affinityPolicy == AffinityPolicy::None && config.cpuList.empty()) {
+        return ordered;
+    }
+
+    const CpuTopology& topology = CpuTopology::instance();
+    std::vector<std::pair<int, int>> candidates; // (节点, CPU)
+    if (config.cpuList.empty()) {
+        for (size_t i = 0; i < topology.cpus.size(); ++i) {
+            candidates.emplace_back(topology.cpuNodes[i], topology.cpus[i]);
+        }
+    } else {
+        for (int cpu : config.cpuList) {
+            if (std::find(topology.cpus.begin(), topology.cpus.end(), cpu) != topology.cpus.end()) {
+                candidates.emplace_back(topology.nodeOf(cpu), cpu);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    if (config.affinityPolicy != AffinityPolicy::Scatter) {
+        for (const auto& candidate : candidates) {
+            ordered.push_back(candidate.second);
+        }
+        return ordered;
+    }
+
+    // Scatter：每轮从每个节点各取一个CPU
+    std::vector<std::vector<int>> byNode(topology.nodeCount);
+    for (const auto& candidate : candidates) {
+        byNode[candidate.first].push_back(candidate.second);
+    }
+    for (size_t round = 0; ordered.size() < candidates.size(); ++round) {
+        for (const auto& cpus : byNode) {
+            if (round < cpus.size()) {
+                ordered.push_back(cpus[round]);
+            }
+        }
+    }
+    return ordered;
+}
+
+} // namespace
+
+const CpuTopology& CpuTopology::instance() {
+    static const CpuTopology topology = loadTopology();
+    return topology;
+}
+
+int CpuTopology::nodeOf(int cpu) const {
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        if (cpus[i] == cpu) {
+            return cpuNodes[i];
+        }
+    }
+    return 0;
+}
+
+std::vector<int> planWorkerCpus(const ThreadPoolConfig& config, size_t count) {
+    std::vector<int> ordered = orderedCpus(config);
+    std::vector<int> plan(count, -1);
+    if (!ordered.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            plan[i] = ordered[i % ordered.size()];
+        }
+    }
+    return plan;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+void setCurrentThreadName(const std::string& name) {
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#else
+    (void)name;
+#endif
+}
+
+int setupWorkerThread(const ThreadPoolConfig& config, size_t index, int cpu) {
+    setCurrentThreadName(config.threadNamePrefix + std::to_string(index));
+    if (cpu >= 0 && pinCurrentThread(cpu)) {
+        return cpu;
+    }
+    return -1;
+}
+
+int setupWorkerThread(const ThreadPoolConfig& config, size_t index) {
+    std::vector<int> ordered = orderedCpus(config);
+    int cpu = ordered.empty() ? -1 : ordered[index % ordered.size()];
+    return setupWorkerThread(config, index, cpu);
+}
+
+} // namespace ThreadPool
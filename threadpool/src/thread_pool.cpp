@@ -14,7 +14,24 @@ std::string ThreadPoolStats::toString() const {
     oss << "  已完成任务: " << completedTasks << "\n";
     oss << "  被拒绝任务: " << rejectedTasks << "\n";
     oss << "  平均执行时间: " << avgExecutionTime << "ms";
+    if (p999ExecutionTime > 0.0 || p999QueueWaitTime > 0.0) {
+        oss << std::setprecision(3);
+        oss << "\n  执行时间分位: p50=" << p50ExecutionTime << "ms p99=" << p99ExecutionTime
+            << "ms p999=" << p999ExecutionTime << "ms";
+        oss << "\n  排队等待: 平均=" << avgQueueWaitTime << "ms p50=" << p50QueueWaitTime
+            << "ms p99=" << p99QueueWaitTime << "ms p999=" << p999QueueWaitTime << "ms";
+    }
     return oss.str();
 }
 
+size_t IThreadPool::submitBulk(Task* tasks, size_t count) {
+    size_t submitted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (submit(std::move(tasks[i]))) {
+            ++submitted;
+        }
+    }
+    return submitted;
+}
+
 } // namespace ThreadPool 
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "../include/thread_pool_factory.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <sys/resource.h>
+
+namespace ThreadPool {
+
+namespace {
+
+const uint64_t kNotCompleted = std::numeric_limits<uint64_t>::max();
+const size_t kNestedFanout = 16;  // 嵌套场景：每个父任务自身加15个子任务
+
+// 一次运行的共享状态，任务只持有指针
+struct BenchmarkRun {
+    IThreadPool* pool;
+    ThreadPoolFactory::BenchmarkScenario scenario;
+    std::chrono::steady_clock::time_point base;
+    std::vector<uint64_t> latencyNs;  // 每个任务一个槽位，互不竞争
+    std::atomic<size_t> remaining;
+    std::atomic<size_t> rejected;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    BenchmarkRun(ThreadPoolFactory::BenchmarkScenario s, size_t total)
+        : pool(nullptr), scenario(s), latencyNs(total, kNotCompleted), remaining(total), rejected(0) {}
+
+    uint64_t nowNs() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - base).count());
+    }
+
+    void finishOne() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+
+    void complete(size_t slot, uint64_t submitNs) {
+        latencyNs[slot] = nowNs() - submitNs;
+        finishOne();
+    }
+
+    void submit(size_t slot);
+    void run(size_t slot, uint64_t submitNs);
+};
+
+void spinFor(std::chrono::nanoseconds duration) {
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+void BenchmarkRun::submit(size_t slot) {
+    uint64_t submitNs = nowNs();
+    BenchmarkRun* self = this;
+    bool accepted = false;
+    try {
+        accepted = pool->submit([self, slot, submitNs]() { self->run(slot, submitNs); });
+    } catch (...) {
+        accepted = false;
+    }
+    if (!accepted) {
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        finishOne();
+    }
+}
+
+void BenchmarkRun::run(size_t slot, uint64_t submitNs) {
+    switch (scenario) {
+        case ThreadPoolFactory::BenchmarkScenario::EmptyTasks:
+        case ThreadPoolFactory::BenchmarkScenario::BurstyArrivals:
+            break;
+        case ThreadPoolFactory::BenchmarkScenario::CpuTasks:
+            spinFor(std::chrono::microseconds(1));
+            break;
+        case ThreadPoolFactory::BenchmarkScenario::BlockingTasks:
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            break;
+        case ThreadPoolFactory::BenchmarkScenario::NestedSubmission:
+            if (slot % kNestedFanout == 0) {
+                for (size_t child = 1; child < kNestedFanout; ++child) {
+                    submit(slot + child);
+                }
+            }
+            spinFor(std::chrono::microseconds(1));
+            break;
+    }
+    complete(slot, submitNs);
+}
+
+// 把进程的RSS高水位（VmHWM）重置为当前RSS（Linux 4.0+），使每次运行的峰值互不影响
+bool resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+}
+
+// 读取/proc/self/status中的VmHWM（KB），失败返回-1
+long readPeakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+double toMs(const timeval& tv) {
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+double percentileMs(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)] / 1e6;
+}
+
+std::string jsonEscape(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:   out += c; break;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<ThreadPoolFactory::BenchmarkScenario> ThreadPoolFactory::getAllScenarios() {
+    return {
+        BenchmarkScenario::EmptyTasks,
+        BenchmarkScenario::CpuTasks,
+        BenchmarkScenario::BlockingTasks,
+        BenchmarkScenario::BurstyArrivals,
+        BenchmarkScenario::NestedSubmission
+    };
+}
+
+std::string ThreadPoolFactory::getScenarioName(BenchmarkScenario scenario) {
+    switch (scenario) {
+        case BenchmarkScenario::EmptyTasks:       return "empty";
+        case BenchmarkScenario::CpuTasks:         return "cpu_1us";
+        case BenchmarkScenario::BlockingTasks:    return "blocking_100us";
+        case BenchmarkScenario::BurstyArrivals:   return "bursty";
+        case BenchmarkScenario::NestedSubmission: return "nested";
+        default:                                  return "unknown";
+    }
+}
+
+std::vector<ThreadPoolFactory::PerformanceMetrics> ThreadPoolFactory::benchmark(
+    const std::vector<ThreadPoolType>& types,
+    size_t taskCount,
+    std::chrono::milliseconds testDuration) {
+    return benchmark(types, getAllScenarios(), taskCount, testDuration);
+}
+
+std::vector<ThreadPoolFactory::PerformanceMetrics> ThreadPoolFactory::benchmark(
+    const std::vector<ThreadPoolType>& types,
+    const std::vector<BenchmarkScenario>& scenarios,
+    size_t taskCount,
+    std::chrono::milliseconds testDuration) {
+
+    std::vector<PerformanceMetrics> results;
+
+    for (ThreadPoolType type : types) {
+        for (BenchmarkScenario scenario : scenarios) {
+            try {
+                std::cout << "正在测试 " << getTypeName(type) << " / " << getScenarioName(scenario)
+                          << "..." << std::endl;
+                results.push_back(runBenchmark(type, scenario, taskCount, testDuration));
+            } catch (const std::exception& e) {
+                std::cerr << "测试 " << getTypeName(type) << " 时发生异常: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    return results;
+}
+
+ThreadPoolFactory::PerformanceMetrics ThreadPoolFactory::runBenchmark(
+    ThreadPoolType type, BenchmarkScenario scenario, size_t taskCount, std::chrono::milliseconds timeout) {
+
+    if (scenario == BenchmarkScenario::NestedSubmission) {
+        taskCount = std::max(kNestedFanout, taskCount / kNestedFanout * kNestedFanout);
+    }
+
+    // 队列放得下全部任务，测的是调度而不是拒绝策略
+    ThreadPoolConfig config = getDefaultConfig(type);
+    config.maxQueueSize = std::max(config.maxQueueSize, taskCount * 2);
+
+    // run先于pool构造、后于pool析构：有的线程池shutdown()不等待工作线程退出，
+    // 工作线程可能仍在finishOne()中访问run，池析构时才保证全部退出
+    BenchmarkRun run(scenario, taskCount);
+    std::unique_ptr<IThreadPool> pool = create(type, config);
+    run.pool = pool.get();
+    pool->start();
+
+    PerformanceMetrics metrics;
+    metrics.poolType = pool->getTypeName();
+    metrics.scenario = getScenarioName(scenario);
+    metrics.threadCount = config.coreThreads;
+
+    bool peakReset = resetPeakRss();
+    rusage before;
+    getrusage(RUSAGE_SELF, &before);
+    run.base = std::chrono::steady_clock::now();
+
+    switch (scenario) {
+        case BenchmarkScenario::BurstyArrivals: {
+            const size_t burst = std::max<size_t>(1, taskCount / 20);
+            for (size_t i = 0; i < taskCount; ++i) {
+                run.submit(i);
+                if ((i + 1) % burst == 0 && i + 1 < taskCount) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            break;
+        }
+        case BenchmarkScenario::NestedSubmission:
+            // 只提交父任务，子任务由父任务在线程池内部提交
+            for (size_t i = 0; i < taskCount; i += kNestedFanout) {
+                run.submit(i);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < taskCount; ++i) {
+                run.submit(i);
+            }
+            break;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(run.mutex);
+        metrics.timedOut = !run.done.wait_for(lock, timeout, [&run] {
+            return run.remaining.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    rusage after;
+    getrusage(RUSAGE_SELF, &after);
+    long peakRssKb = peakReset ? readPeakRssKb() : -1;
+
+    // 超时时丢弃剩余任务，未超时时任务已全部完成；
+    // 两种情况下都可能有工作线程尚未退出，由pool的析构等待（见run的声明处）
+    if (metrics.timedOut) {
+        pool->shutdownNow();
+    } else {
+        pool->shutdown();
+    }
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(taskCount);
+    uint64_t sumNs = 0;
+    for (uint64_t ns : run.latencyNs) {
+        if (ns != kNotCompleted) {
+            latencies.push_back(ns);
+            sumNs += ns;
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    metrics.completedTasks = latencies.size();
+    metrics.rejectedTasks = run.rejected.load();
+    metrics.wallTime = std::chrono::duration<double, std::milli>(end - run.base).count();
+    if (metrics.wallTime > 0.0) {
+        metrics.avgThroughput = metrics.completedTasks / (metrics.wallTime / 1000.0);
+    }
+    if (!latencies.empty()) {
+        metrics.avgLatency = sumNs / 1e6 / latencies.size();
+        metrics.p50Latency = percentileMs(latencies, 0.50);
+        metrics.p99Latency = percentileMs(latencies, 0.99);
+        metrics.p999Latency = percentileMs(latencies, 0.999);
+        metrics.maxLatency = latencies.back() / 1e6;
+    }
+
+    metrics.userCpuTime = toMs(after.ru_utime) - toMs(before.ru_utime);
+    metrics.systemCpuTime = toMs(after.ru_stime) - toMs(before.ru_stime);
+    if (metrics.wallTime > 0.0) {
+        metrics.cpuUsage = (metrics.userCpuTime + metrics.systemCpuTime) / metrics.wallTime * 100.0;
+    }
+    // 无法重置高水位时退回到ru_maxrss（进程生命周期内的峰值，Linux下单位为KB）
+    metrics.memoryUsage = (peakRssKb >= 0 ? peakRssKb : after.ru_maxrss) / 1024.0;
+    metrics.voluntaryContextSwitches = after.ru_nvcsw - before.ru_nvcsw;
+    metrics.involuntaryContextSwitches = after.ru_nivcsw - before.ru_nivcsw;
+
+    return metrics;
+}
+
+std::string ThreadPoolFactory::PerformanceMetrics::toString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << poolType << " [" << scenario << "] 性能指标:\n";
+    oss << "  线程数: " << threadCount << "\n";
+    oss << "  吞吐量: " << avgThroughput << " 任务/秒\n";
+    oss << std::setprecision(3);
+    oss << "  延迟: 平均=" << avgLatency << "ms p50=" << p50Latency << "ms p99=" << p99Latency
+        << "ms p999=" << p999Latency << "ms 最大=" << maxLatency << "ms\n";
+    oss << std::setprecision(2);
+    oss << "  完成任务数: " << completedTasks << "（拒绝 " << rejectedTasks << "）"
+        << (timedOut ? " 超时" : "") << "\n";
+    oss << "  CPU时间: 用户态 " << userCpuTime << "ms 内核态 " << systemCpuTime << "ms，耗时 "
+        << wallTime << "ms\n";
+    oss << "  CPU使用率: " << cpuUsage << "%\n";
+    oss << "  上下文切换: 主动 " << voluntaryContextSwitches << " 被动 " << involuntaryContextSwitches << "\n";
+    oss << "  内存使用: " << memoryUsage << " MB（本次运行峰值RSS）";
+    return oss.str();
+}
+
+std::string ThreadPoolFactory::PerformanceMetrics::toJson() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "{\"pool\":\"" << jsonEscape(poolType) << "\""
+        << ",\"scenario\":\"" << jsonEscape(scenario) << "\""
+        << ",\"threads\":" << threadCount
+        << ",\"completed\":" << completedTasks
+        << ",\"rejected\":" << rejectedTasks
+        << ",\"timed_out\":" << (timedOut ? "true" : "false")
+        << ",\"wall_ms\":" << wallTime
+        << ",\"throughput_per_sec\":" << avgThroughput
+        << ",\"latency_ms\":{\"avg\":" << avgLatency << ",\"p50\":" << p50Latency
+        << ",\"p99\":" << p99Latency << ",\"p999\":" << p999Latency << ",\"max\":" << maxLatency << "}"
+        << ",\"cpu_ms\":{\"user\":" << userCpuTime << ",\"system\":" << systemCpuTime << "}"
+        << ",\"cpu_usage_percent\":" << cpuUsage
+        << ",\"peak_rss_mb\":" << memoryUsage
+        << ",\"context_switches\":{\"voluntary\":" << voluntaryContextSwitches
+        << ",\"involuntary\":" << involuntaryContextSwitches << "}}";
+    return oss.str();
+}
+
+std::string ThreadPoolFactory::toJson(const std::vector<PerformanceMetrics>& results) {
+    std::ostringstream oss;
+    oss << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        oss << "  " << results[i].toJson() << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    oss << "]";
+    return oss.str();
+}
+
+} // namespace ThreadPool
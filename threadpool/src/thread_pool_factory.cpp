@@ -19,14 +19,10 @@ std::unique_ptr<IThreadPool> ThreadPoolFactory::create(ThreadPoolType type, cons
             return std::unique_ptr<IThreadPool>(new PriorityThreadPool(config));
             
         case ThreadPoolType::Scheduled:
-            // TODO: 实现定时任务线程池
-            std::cerr << "定时任务线程池尚未实现，使用固定线程池替代" << std::endl;
-            return std::unique_ptr<IThreadPool>(new FixedThreadPool(config));
+            return std::unique_ptr<IThreadPool>(new ScheduledThreadPool(config));
             
         case ThreadPoolType::WorkStealing:
-            // TODO: 实现工作窃取线程池
-            std::cerr << "工作窃取线程池尚未实现，使用固定线程池替代" << std::endl;
-            return std::unique_ptr<IThreadPool>(new FixedThreadPool(config));
+            return std::unique_ptr<IThreadPool>(new WorkStealingThreadPool(config));
             
         default:
             throw std::invalid_argument("不支持的线程池类型");
@@ -67,9 +63,9 @@ std::vector<ThreadPoolType> ThreadPoolFactory::getSupportedTypes() {
     return {
         ThreadPoolType::Fixed,
         ThreadPoolType::Cached,
-        ThreadPoolType::Priority
-        // ThreadPoolType::Scheduled,    // 待实现
-        // ThreadPoolType::WorkStealing  // 待实现
+        ThreadPoolType::Priority,
+        ThreadPoolType::WorkStealing,
+        ThreadPoolType::Scheduled
     };
 }
 
@@ -156,61 +152,6 @@ std::string ThreadPoolFactory::getScenarioDescription(UsageScenario scenario) {
     }
 }
 
-std::vector<ThreadPoolFactory::PerformanceMetrics> ThreadPoolFactory::benchmark(
-    const std::vector<ThreadPoolType>& types,
-    size_t taskCount,
-    std::chrono::milliseconds testDuration) {
-    
-    std::vector<PerformanceMetrics> results;
-    
-    for (ThreadPoolType type : types) {
-        try {
-            std::cout << "正在测试 " << getTypeName(type) << "..." << std::endl;
-            
-            auto pool = create(type, getRecommendedThreadCount());
-            pool->start();
-            
-            PerformanceMetrics metrics;
-            metrics.poolType = getTypeName(type);
-            
-            auto start = std::chrono::high_resolution_clock::now();
-            
-            // 提交测试任务
-            std::atomic<size_t> completedCount{0};
-            for (size_t i = 0; i < taskCount; ++i) {
-                pool->submit([&completedCount]() {
-                    // 模拟一些工作
-                    std::this_thread::sleep_for(std::chrono::microseconds(100));
-                    ++completedCount;
-                });
-            }
-            
-            // 等待测试完成或超时
-            std::this_thread::sleep_for(testDuration);
-            
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-            
-            // 收集统计信息
-            auto stats = pool->getStats();
-            metrics.completedTasks = completedCount.load();
-            metrics.avgThroughput = static_cast<double>(metrics.completedTasks) / 
-                                   (duration.count() / 1000.0);
-            metrics.avgLatency = stats.avgExecutionTime;
-            metrics.cpuUsage = 0.0; // 简化实现
-            metrics.memoryUsage = 0.0; // 简化实现
-            
-            pool->shutdown();
-            results.push_back(metrics);
-            
-        } catch (const std::exception& e) {
-            std::cerr << "测试 " << getTypeName(type) << " 时发生异常: " << e.what() << std::endl;
-        }
-    }
-    
-    return results;
-}
-
 size_t ThreadPoolFactory::getRecommendedThreadCount() {
     size_t hardwareConcurrency = std::thread::hardware_concurrency();
     
@@ -243,6 +184,16 @@ ThreadPoolConfig ThreadPoolFactory::getDefaultConfig(ThreadPoolType type) {
             config.maxQueueSize = 1000;
             break;
             
+        case ThreadPoolType::WorkStealing:
+            config.maxThreads = config.coreThreads;
+            config.maxQueueSize = 10000; // 只限制外部提交，任务内派生的子任务不受限
+            break;
+            
+        case ThreadPoolType::Scheduled:
+            config.maxThreads = config.coreThreads;
+            config.maxQueueSize = 10000; // 包括尚未到期的定时任务
+            break;
+            
         default:
             break;
     }
@@ -250,16 +201,4 @@ ThreadPoolConfig ThreadPoolFactory::getDefaultConfig(ThreadPoolType type) {
     return config;
 }
 
-std::string ThreadPoolFactory::PerformanceMetrics::toString() const {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    oss << poolType << " 性能指标:\n";
-    oss << "  吞吐量: " << avgThroughput << " 任务/秒\n";
-    oss << "  平均延迟: " << avgLatency << " 毫秒\n";
-    oss << "  完成任务数: " << completedTasks << "\n";
-    oss << "  CPU使用率: " << cpuUsage << "%\n";
-    oss << "  内存使用: " << memoryUsage << " MB";
-    return oss.str();
-}
-
 } // namespace ThreadPool 
\ No newline at end of file
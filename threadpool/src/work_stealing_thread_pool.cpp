@@ -0,0 +1,755 @@
+#include "../include/work_stealing_thread_pool.h"
+#include "../include/thread_affinity.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+namespace ThreadPool {
+
+namespace {
+
+// 当前线程所属的线程池和工作线程编号，用于区分任务内提交和外部提交
+thread_local const void* tlsPool = nullptr;
+thread_local size_t tlsWorkerIndex = 0;
+
+const int kStealRounds = 6;             // 休眠前的窃取轮数，每轮之后退避时间翻倍
+const int kYieldRound = 3;              // 从这一轮开始退避时让出CPU而不是忙等
+const size_t kInjectorBatch = 32;       // 每次从注入队列最多取走的任务数
+const uint32_t kInjectorCheckInterval = 61; // 本地队列一直有任务时，每隔多少个任务检查一次注入队列
+const size_t kNodeBatch = 64;           // 节点池每次分配/交换的节点数
+const size_t kMaxCachedNodes = 256;     // 每个工作线程最多缓存的空闲节点数
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void backoff(int round) {
+    if (round >= kYieldRound) {
+        std::this_thread::yield();
+        return;
+    }
+    for (int i = 0; i < (16 << round); ++i) {
+        cpuRelax();
+    }
+}
+
+} // namespace
+
+std::string WorkStealingStats::toString() const {
+    std::ostringstream oss;
+    oss << "工作窃取统计:\n";
+    oss << "  本地提交: " << localSubmits << "\n";
+    oss << "  注入队列提交: " << injectorSubmits << "\n";
+    oss << "  成功窃取: " << steals << "\n";
+    oss << "  跨节点窃取: " << remoteSteals << "\n";
+    oss << "  窃取失败轮数: " << failedSteals << "\n";
+    oss << "  休眠次数: " << parks;
+    return oss.str();
+}
+
+uint64_t WorkStealingThreadPool::Worker::nextRandom() {
+    // xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 2685821657736338717ULL;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const ThreadPoolConfig& config)
+    : config_(config), rejectionPolicy_(RejectionPolicy::Abort) {
+
+    if (config_.coreThreads == 0) {
+        config_.coreThreads = 1;
+    }
+    config_.maxThreads = config_.coreThreads; // 固定线程数
+
+    std::cout << "创建工作窃取线程池，线程数: " << config_.coreThreads << std::endl;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t threadCount)
+    : WorkStealingThreadPool(ThreadPoolConfig(threadCount)) {
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    if (running_) {
+        shutdownNow();
+    }
+    clearAllQueues();
+}
+
+bool WorkStealingThreadPool::submit(Task task) {
+    // 工作线程内提交：进入本地队列，无锁。
+    // 优雅关闭期间仍然接受，父任务已经在执行，它派生的子任务属于"所有任务"的一部分
+    if (tlsPool == this && !stopNow_) {
+        Worker& self = *workers_[tlsWorkerIndex];
+        Task* item = acquireNode(self);
+        *item = std::move(task);
+        self.deque.push(item);
+        self.localSubmits.fetch_add(1, std::memory_order_relaxed);
+        wakeOne();
+        return true;
+    }
+
+    if (shutdown_ || !running_) {
+        return handleRejection(task);
+    }
+
+    if (!pushToInjector(task)) {
+        return handleRejection(task);
+    }
+
+    wakeOne();
+    return true;
+}
+
+size_t WorkStealingThreadPool::submitBulk(Task* tasks, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // 工作线程内批量提交：全部进入本地队列
+    if (tlsPool == this && !stopNow_) {
+        Worker& self = *workers_[tlsWorkerIndex];
+        for (size_t i = 0; i < count; ++i) {
+            Task* item = acquireNode(self);
+            *item = std::move(tasks[i]);
+            self.deque.push(item);
+        }
+        self.localSubmits.fetch_add(count, std::memory_order_relaxed);
+        wakeMany(count);
+        return count;
+    }
+
+    if (shutdown_ || !running_ || !pushBulkToInjector(tasks, count)) {
+        return handleBulkRejection(tasks, count);
+    }
+
+    wakeMany(count);
+    return count;
+}
+
+bool WorkStealingThreadPool::pushBulkToInjector(Task* tasks, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        if (injector_.size() + count > config_.maxQueueSize) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            injector_.push_back(std::move(tasks[i]));
+        }
+        injectorSize_.fetch_add(count);
+    }
+    injectorSubmits_.fetch_add(count, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingThreadPool::pushToInjector(Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        if (injector_.size() >= config_.maxQueueSize) {
+            return false;
+        }
+        injector_.push_back(std::move(task));
+        injectorSize_.fetch_add(1);
+    }
+    injectorSubmits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void WorkStealingThreadPool::wakeOne() {
+    // 与park()中的"sleepers_++ -> 检查任务"配对：
+    // 任务已发布 -> 检查sleepers_，两边都有全屏障，不会出现双方都没看到对方的情况
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCondition_.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::wakeMany(size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_t sleepers = sleepers_.load(std::memory_order_relaxed);
+    if (sleepers == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(parkMutex_);
+    for (size_t i = 0; i < std::min(count, sleepers); ++i) {
+        parkCondition_.notify_one();
+    }
+}
+
+bool WorkStealingThreadPool::start() {
+    if (running_) {
+        return false;
+    }
+
+    running_ = true;
+    shutdown_ = false;
+    stopNow_ = false;
+    terminated_ = false;
+
+    // 先创建所有工作线程的状态，再启动线程，窃取时workers_不会再变化
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    workers_.reserve(config_.coreThreads);
+    std::vector<int> cpus = planWorkerCpus(config_, config_.coreThreads);
+    for (size_t i = 0; i < config_.coreThreads; ++i) {
+        uint64_t seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        workers_.emplace_back(new Worker(seed));
+        workers_[i]->freeNodes.reserve(kMaxCachedNodes + 1);
+        workers_[i]->cpu = cpus[i];
+        workers_[i]->node = CpuTopology::instance().nodeOf(cpus[i]);
+    }
+    for (size_t i = 0; i < config_.coreThreads; ++i) {
+        workers_[i]->thread = std::thread(&WorkStealingThreadPool::workerThread, this, i);
+    }
+
+    std::cout << "工作窃取线程池已启动，线程数: " << config_.coreThreads << std::endl;
+    return true;
+}
+
+void WorkStealingThreadPool::stop() {
+    shutdown();
+}
+
+void WorkStealingThreadPool::shutdown() {
+    if (!running_ || shutdown_) {
+        return;
+    }
+
+    std::cout << "正在关闭工作窃取线程池..." << std::endl;
+    shutdown_ = true;
+
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCondition_.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        injectorNotFull_.notify_all();
+    }
+
+    joinAllWorkers();
+
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(terminationMutex_);
+        terminated_ = true;
+    }
+    terminationCondition_.notify_all();
+    std::cout << "工作窃取线程池已关闭" << std::endl;
+}
+
+void WorkStealingThreadPool::shutdownNow() {
+    if (!running_) {
+        return;
+    }
+
+    std::cout << "正在强制关闭工作窃取线程池..." << std::endl;
+    stopNow_ = true;
+    shutdown_ = true;
+
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCondition_.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        injectorNotFull_.notify_all();
+    }
+
+    joinAllWorkers();
+
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(terminationMutex_);
+        terminated_ = true;
+    }
+    terminationCondition_.notify_all();
+    std::cout << "工作窃取线程池已强制关闭" << std::endl;
+}
+
+size_t WorkStealingThreadPool::handleBulkRejection(Task* tasks, size_t count) {
+    // rejectedTasks_只统计确实没有进入队列的任务（含被挤掉的旧任务）
+    switch (rejectionPolicy_) {
+        case RejectionPolicy::Abort:
+            rejectedTasks_ += count;
+            throw std::runtime_error("批量任务被拒绝：队列空间不足");
+
+        case RejectionPolicy::Discard:
+            rejectedTasks_ += count;
+            std::cerr << "批量任务被丢弃：队列空间不足，任务数: " << count << std::endl;
+            return 0;
+
+        case RejectionPolicy::DiscardOldest:
+            if (shutdown_.load() || count > config_.maxQueueSize) {
+                rejectedTasks_ += count;
+                return 0;
+            }
+            {
+                std::lock_guard<std::mutex> lock(injectorMutex_);
+                size_t dropped = 0;
+                while (!injector_.empty() && injector_.size() + count > config_.maxQueueSize) {
+                    injector_.pop_front(); // 丢弃最旧的任务
+                    ++dropped;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    injector_.push_back(std::move(tasks[i]));
+                }
+                injectorSize_.fetch_add(count);
+                injectorSize_.fetch_sub(dropped);
+                rejectedTasks_ += dropped;
+            }
+            injectorSubmits_.fetch_add(count, std::memory_order_relaxed);
+            wakeMany(count);
+            return count;
+
+        case RejectionPolicy::CallerRuns:
+            {
+                rejectedTasks_ += count;
+                size_t ran = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    try {
+                        tasks[i](); // 在调用者线程中执行
+                        ++ran;
+                    } catch (...) {
+                    }
+                }
+                return ran;
+            }
+
+        case RejectionPolicy::Block:
+            {
+                // 批量不超过队列容量时等待整批空间；超过时按队列容量分段入队
+                size_t submitted = 0;
+                while (submitted < count) {
+                    size_t chunk = std::min(count - submitted, config_.maxQueueSize);
+                    {
+                        std::unique_lock<std::mutex> lock(injectorMutex_);
+                        ++blockedSubmitters_;
+                        injectorNotFull_.wait(lock, [this, chunk] {
+                            return shutdown_.load() || injector_.size() + chunk <= config_.maxQueueSize;
+                        });
+                        --blockedSubmitters_;
+
+                        if (shutdown_.load()) {
+                            break;
+                        }
+
+                        for (size_t i = 0; i < chunk; ++i) {
+                            injector_.push_back(std::move(tasks[submitted + i]));
+                        }
+                        injectorSize_.fetch_add(chunk);
+                    }
+                    injectorSubmits_.fetch_add(chunk, std::memory_order_relaxed);
+                    wakeMany(chunk);
+                    submitted += chunk;
+                }
+                rejectedTasks_ += count - submitted;
+                return submitted;
+            }
+    }
+
+    return 0;
+}
+
+void WorkStealingThreadPool::joinAllWorkers() {
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // 强制关闭时丢弃剩余任务；优雅关闭时队列此时已经为空
+    clearAllQueues();
+
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    workers_.clear();
+}
+
+void WorkStealingThreadPool::clearAllQueues() {
+    // 工作线程都已退出，可以在当前线程清空各个队列，节点全部交还共享池
+    {
+        std::lock_guard<std::mutex> lock(nodePoolMutex_);
+        for (auto& worker : workers_) {
+            Task* task = nullptr;
+            while (worker->deque.steal(task)) {
+                task->reset();
+                sharedNodes_.push_back(task);
+            }
+            sharedNodes_.insert(sharedNodes_.end(), worker->freeNodes.begin(), worker->freeNodes.end());
+            worker->freeNodes.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(injectorMutex_);
+    injector_.clear();
+    injectorSize_ = 0;
+}
+
+bool WorkStealingThreadPool::awaitTermination(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(terminationMutex_);
+    return terminationCondition_.wait_for(lock, timeout, [this] { return terminated_.load(); });
+}
+
+ThreadPoolStats WorkStealingThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.threadCount = config_.coreThreads;
+    stats.activeThreads = activeThreads_.load();
+    stats.maxQueueSize = config_.maxQueueSize;
+    stats.completedTasks = completedTasks_.load();
+    stats.rejectedTasks = rejectedTasks_.load();
+
+    size_t queued = injectorSize_.load();
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        for (const auto& worker : workers_) {
+            queued += worker->deque.size();
+        }
+    }
+    stats.queueSize = queued;
+
+    if (stats.completedTasks > 0) {
+        stats.avgExecutionTime = totalExecutionNs_.load() / 1e6 / stats.completedTasks;
+    }
+    return stats;
+}
+
+WorkStealingStats WorkStealingThreadPool::getStealStats() const {
+    WorkStealingStats stats;
+    stats.injectorSubmits = injectorSubmits_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    for (const auto& worker : workers_) {
+        stats.localSubmits += worker->localSubmits.load(std::memory_order_relaxed);
+        stats.steals += worker->steals.load(std::memory_order_relaxed);
+        stats.remoteSteals += worker->remoteSteals.load(std::memory_order_relaxed);
+        stats.failedSteals += worker->failedSteals.load(std::memory_order_relaxed);
+        stats.parks += worker->parks.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+ThreadPoolConfig WorkStealingThreadPool::getConfig() const {
+    return config_;
+}
+
+bool WorkStealingThreadPool::setCorePoolSize(size_t coreSize) {
+    (void)coreSize; // 消除未使用参数警告
+    // 工作线程数固定，不支持动态调整
+    return false;
+}
+
+bool WorkStealingThreadPool::setMaximumPoolSize(size_t maxSize) {
+    (void)maxSize; // 消除未使用参数警告
+    // 工作线程数固定，不支持动态调整
+    return false;
+}
+
+bool WorkStealingThreadPool::isRunning() const {
+    return running_;
+}
+
+bool WorkStealingThreadPool::isShutdown() const {
+    return shutdown_;
+}
+
+bool WorkStealingThreadPool::isTerminated() const {
+    return terminated_;
+}
+
+std::string WorkStealingThreadPool::getTypeName() const {
+    return "WorkStealingThreadPool";
+}
+
+void WorkStealingThreadPool::setRejectionPolicy(RejectionPolicy policy) {
+    rejectionPolicy_ = policy;
+}
+
+bool WorkStealingThreadPool::isWorkerThread() const {
+    return tlsPool == this;
+}
+
+void WorkStealingThreadPool::workerThread(size_t index) {
+    setupWorkerThread(config_, index, workers_[index]->cpu);
+    tlsPool = this;
+    tlsWorkerIndex = index;
+
+    while (!stopNow_) {
+        Task* task = nullptr;
+        if (findTask(index, task)) {
+            runTask(index, task);
+            continue;
+        }
+
+        // 优雅关闭：所有队列都空了才退出（其他线程派生的子任务只会进入它们自己的本地队列）
+        if (shutdown_ && !hasWork()) {
+            break;
+        }
+        park(index);
+    }
+
+    tlsPool = nullptr;
+}
+
+bool WorkStealingThreadPool::findTask(size_t index, Task*& task) {
+    Worker& self = *workers_[index];
+
+    // 本地队列一直有任务时也定期检查注入队列，避免外部任务饿死
+    if (++self.tick % kInjectorCheckInterval == 0 && takeFromInjector(self, task)) {
+        return true;
+    }
+
+    if (self.deque.pop(task)) {
+        return true;
+    }
+    if (takeFromInjector(self, task)) {
+        return true;
+    }
+
+    // 随机窃取，失败则指数退避
+    for (int round = 0; round < kStealRounds && !stopNow_; ++round) {
+        if (trySteal(index, task)) {
+            return true;
+        }
+        if (takeFromInjector(self, task)) {
+            return true;
+        }
+        backoff(round);
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::takeFromInjector(Worker& self, Task*& task) {
+    if (injectorSize_.load() == 0) {
+        return false;
+    }
+
+    size_t moved = 0;
+    {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        if (injector_.empty()) {
+            return false;
+        }
+        task = acquireNode(self);
+        *task = std::move(injector_.front());
+        injector_.pop_front();
+
+        // 顺便取走一小批放进本地队列，减少注入队列的锁竞争；其余线程可以再从本地队列窃取
+        size_t batch = injector_.size() / workers_.size();
+        if (batch > kInjectorBatch - 1) {
+            batch = kInjectorBatch - 1;
+        }
+        for (; moved < batch; ++moved) {
+            Task* item = acquireNode(self);
+            *item = std::move(injector_.front());
+            injector_.pop_front();
+            self.deque.push(item);
+        }
+        injectorSize_.fetch_sub(1 + moved);
+    }
+
+    if (blockedSubmitters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(injectorMutex_);
+        injectorNotFull_.notify_all();
+    }
+    if (moved > 0) {
+        wakeOne();
+    }
+    return true;
+}
+
+bool WorkStealingThreadPool::trySteal(size_t index, Task*& task) {
+    const size_t count = workers_.size();
+    if (count <= 1) {
+        return false;
+    }
+
+    // numaAware时先遍历同节点的线程，再遍历其他节点；否则一轮遍历所有线程
+    if (config_.numaAware) {
+        if (stealFrom(index, true, task) || stealFrom(index, false, task)) {
+            return true;
+        }
+    } else if (stealFrom(index, true, task)) {
+        return true;
+    }
+
+    workers_[index]->failedSteals.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool WorkStealingThreadPool::stealFrom(size_t index, bool sameNode, Task*& task) {
+    const size_t count = workers_.size();
+    Worker& self = *workers_[index];
+    size_t start = static_cast<size_t>(self.nextRandom() % count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == index) {
+            continue;
+        }
+        Worker& other = *workers_[victim];
+        bool remote = other.node != self.node;
+        if (config_.numaAware && remote == sameNode) {
+            continue;
+        }
+        if (other.deque.steal(task)) {
+            self.steals.fetch_add(1, std::memory_order_relaxed);
+            if (remote) {
+                self.remoteSteals.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::hasWork() const {
+    if (injectorSize_.load() > 0) {
+        return true;
+    }
+    for (const auto& worker : workers_) {
+        if (!worker->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::park(size_t index) {
+    std::unique_lock<std::mutex> lock(parkMutex_);
+    sleepers_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool parked = false;
+    while (!stopNow_ && !shutdown_ && !hasWork()) {
+        if (!parked) {
+            workers_[index]->parks.fetch_add(1, std::memory_order_relaxed);
+            parked = true;
+        }
+        parkCondition_.wait(lock);
+    }
+
+    sleepers_.fetch_sub(1);
+    return parked;
+}
+
+void WorkStealingThreadPool::runTask(size_t index, Task* task) {
+    ++activeThreads_;
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        (*task)();
+    } catch (const std::exception& e) {
+        std::cerr << "工作窃取线程 " << index << " 任务执行异常: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "工作窃取线程 " << index << " 任务执行未知异常" << std::endl;
+    }
+    task->reset();
+    releaseNode(*workers_[index], task);
+
+    auto end = std::chrono::steady_clock::now();
+    totalExecutionNs_.fetch_add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+        std::memory_order_relaxed);
+
+    ++completedTasks_;
+    --activeThreads_;
+}
+
+Task* WorkStealingThreadPool::acquireNode(Worker& self) {
+    if (self.freeNodes.empty()) {
+        std::lock_guard<std::mutex> lock(nodePoolMutex_);
+        size_t take = std::min(kNodeBatch, sharedNodes_.size());
+        self.freeNodes.insert(self.freeNodes.end(), sharedNodes_.end() - take, sharedNodes_.end());
+        sharedNodes_.resize(sharedNodes_.size() - take);
+
+        if (take == 0) {
+            nodeChunks_.emplace_back(new Task[kNodeBatch]);
+            Task* chunk = nodeChunks_.back().get();
+            for (size_t i = 0; i < kNodeBatch; ++i) {
+                self.freeNodes.push_back(chunk + i);
+            }
+        }
+    }
+
+    Task* node = self.freeNodes.back();
+    self.freeNodes.pop_back();
+    return node;
+}
+
+void WorkStealingThreadPool::releaseNode(Worker& self, Task* node) {
+    self.freeNodes.push_back(node);
+    if (self.freeNodes.size() > kMaxCachedNodes) {
+        std::lock_guard<std::mutex> lock(nodePoolMutex_);
+        sharedNodes_.insert(sharedNodes_.end(), self.freeNodes.end() - kNodeBatch, self.freeNodes.end());
+        self.freeNodes.resize(self.freeNodes.size() - kNodeBatch);
+    }
+}
+
+bool WorkStealingThreadPool::handleRejection(Task& task) {
+    // rejectedTasks_只统计确实没有进入队列的任务（含被挤掉的旧任务）
+    switch (rejectionPolicy_) {
+        case RejectionPolicy::Abort:
+            ++rejectedTasks_;
+            throw std::runtime_error("任务被拒绝：队列已满");
+
+        case RejectionPolicy::Discard:
+            ++rejectedTasks_;
+            std::cerr << "任务被丢弃：队列已满" << std::endl;
+            return false;
+
+        case RejectionPolicy::DiscardOldest:
+            ++rejectedTasks_;
+            {
+                std::unique_lock<std::mutex> lock(injectorMutex_);
+                if (shutdown_.load() || injector_.empty()) {
+                    return false;
+                }
+                injector_.pop_front(); // 丢弃最旧的任务
+                injector_.push_back(std::move(task));
+            }
+            wakeOne();
+            return true;
+
+        case RejectionPolicy::CallerRuns:
+            ++rejectedTasks_;
+            try {
+                task(); // 在调用者线程中执行
+                return true;
+            } catch (...) {
+                return false;
+            }
+
+        case RejectionPolicy::Block:
+            {
+                std::unique_lock<std::mutex> lock(injectorMutex_);
+                ++blockedSubmitters_;
+                injectorNotFull_.wait(lock, [this] {
+                    return shutdown_.load() || injector_.size() < config_.maxQueueSize;
+                });
+                --blockedSubmitters_;
+
+                if (shutdown_.load()) {
+                    ++rejectedTasks_;
+                    return false;
+                }
+
+                injector_.push_back(std::move(task));
+                injectorSize_.fetch_add(1);
+            }
+            injectorSubmits_.fetch_add(1, std::memory_order_relaxed);
+            wakeOne();
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace ThreadPool
@@ -18,6 +18,7 @@
 #include <unistd.h>
 #include <assert.h>
 #include <vector>
+#include <atomic>
 #include <errno.h>
 
 class Epoller {
@@ -31,8 +32,17 @@ public:
     int Wait(int timeoutMs = -1);
     int GetEventFd(size_t i) const;
     uint32_t GetEvents(size_t i) const;
-        
+
+    /* 先自旋后阻塞: Wait前以0超时轮询spinUs微秒，仍无事件再阻塞
+     * sockBusyPollUs/preferBusyPoll 在AddFd时设置 SO_BUSY_POLL/SO_PREFER_BUSY_POLL (仅Linux) */
+    void SetBusyPoll(int spinUs, int sockBusyPollUs = 0, bool preferBusyPoll = false);
+    uint64_t GetSpinHits() const { return spinHits_; }          /* 自旋阶段拿到事件的次数 */
+    uint64_t GetBlockingWaits() const { return blockingWaits_; } /* 自旋未命中转入阻塞的次数 */
+
 private:
+    int Poll_(int timeoutMs);
+    void SetSockBusyPoll_(int fd);
+
 #ifdef __linux__
     int epollFd_;
     std::vector<struct epoll_event> events_;
@@ -40,6 +50,12 @@ private:
     int kqueueFd_;
     std::vector<struct kevent> events_;
 #endif
+
+    int spinUs_;
+    int sockBusyPollUs_;
+    bool preferBusyPoll_;
+    std::atomic<uint64_t> spinHits_;
+    std::atomic<uint64_t> blockingWaits_;
 };
 
 #endif //EPOLLER_H 
\ No newline at end of file
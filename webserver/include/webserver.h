@@ -29,6 +29,8 @@ public:
 
     ~WebServer();
     void Start();
+    /* 主循环等待策略: 阻塞前先自旋spinUs微秒，用CPU换延迟，适合独占核心 */
+    void SetBusyPoll(int spinUs, int sockBusyPollUs = 0, bool preferBusyPoll = false);
 
 private:
     bool InitSocket_(); 
@@ -5,6 +5,8 @@
  */ 
 
 #include "../include/epoller.h"
+#include <chrono>
+#include <sys/socket.h>
 
 #ifdef __APPLE__
 // 在macOS上定义epoll兼容的宏
@@ -16,7 +18,8 @@
 #define EPOLLET 0x80000000
 #endif
 
-Epoller::Epoller(int maxEvent):events_(maxEvent){
+Epoller::Epoller(int maxEvent):events_(maxEvent), spinUs_(0), sockBusyPollUs_(0),
+    preferBusyPoll_(false), spinHits_(0), blockingWaits_(0) {
 #ifdef __linux__
     epollFd_ = epoll_create(512);
     assert(epollFd_ >= 0 && events_.size() > 0);
@@ -40,7 +43,9 @@ bool Epoller::AddFd(int fd, uint32_t events) {
     epoll_event ev = {0};
     ev.data.fd = fd;
     ev.events = events;
-    return 0 == epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    if(0 != epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev)) return false;
+    if(sockBusyPollUs_ > 0 || preferBusyPoll_) SetSockBusyPoll_(fd);
+    return true;
 #elif defined(__APPLE__) || defined(__FreeBSD__)
     if(fd < 0) return false;
     struct kevent ev;
@@ -86,7 +91,62 @@ bool Epoller::DelFd(int fd) {
 #endif
 }
 
+void Epoller::SetBusyPoll(int spinUs, int sockBusyPollUs, bool preferBusyPoll) {
+    spinUs_ = spinUs > 0 ? spinUs : 0;
+    sockBusyPollUs_ = sockBusyPollUs > 0 ? sockBusyPollUs : 0;
+    preferBusyPoll_ = preferBusyPoll;
+}
+
+void Epoller::SetSockBusyPoll_(int fd) {
+#ifdef __linux__
+    /* 失败(非socket、缺少CAP_NET_ADMIN、内核不支持)不影响注册 */
+    if(sockBusyPollUs_ > 0) {
+        int value = sockBusyPollUs_;
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value));
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    if(preferBusyPoll_) {
+        int value = 1;
+        setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &value, sizeof(value));
+    }
+#endif
+#else
+    (void)fd;
+#endif
+}
+
 int Epoller::Wait(int timeoutMs) {
+    if(spinUs_ <= 0 || timeoutMs == 0) {
+        return Poll_(timeoutMs);
+    }
+    /* 自旋阶段不超过调用方给定的超时 */
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+    std::chrono::microseconds spin(spinUs_);
+    if(timeoutMs > 0 && spin > std::chrono::milliseconds(timeoutMs)) {
+        spin = std::chrono::milliseconds(timeoutMs);
+    }
+    Clock::time_point now = start;
+    do {
+        int ready = Poll_(0);
+        if(ready != 0) {
+            if(ready > 0) spinHits_++;
+            return ready;
+        }
+        now = Clock::now();
+    } while(now < start + spin);
+
+    blockingWaits_++;
+    int remaining = timeoutMs;
+    if(timeoutMs > 0) {
+        long elapsed = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+        remaining = elapsed >= timeoutMs ? 0 : timeoutMs - static_cast<int>(elapsed);
+    }
+    return Poll_(remaining);
+}
+
+int Epoller::Poll_(int timeoutMs) {
 #ifdef __linux__
     return epoll_wait(epollFd_, &events_[0], static_cast<int>(events_.size()), timeoutMs);
 #elif defined(__APPLE__) || defined(__FreeBSD__)
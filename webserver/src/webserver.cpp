@@ -101,6 +101,12 @@ void WebServer::InitEventMode_(int trigMode) {
     HttpConn::isET = (connEvent_ & EPOLLET);
 }
 
+void WebServer::SetBusyPoll(int spinUs, int sockBusyPollUs, bool preferBusyPoll) {
+    epoller_->SetBusyPoll(spinUs, sockBusyPollUs, preferBusyPoll);
+    LOG_INFO("BusyPoll spin: %dus, SO_BUSY_POLL: %dus, prefer: %d",
+             spinUs, sockBusyPollUs, preferBusyPoll ? 1 : 0);
+}
+
 void WebServer::Start() {
     int timeMS = -1;  /* epoll wait timeout == -1 无事件将阻塞 */
     if(!isClose_) { LOG_INFO_SIMPLE("========== Server start =========="); }